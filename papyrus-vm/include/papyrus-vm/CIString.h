@@ -1,6 +1,7 @@
 #pragma once
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -38,11 +39,16 @@ using CIString = std::basic_string<char, CICharTraits>;
 
 struct CIHash
 {
+  // FNV-1a over lowercase characters, doesn't allocate unlike hashing a
+  // lowercase copy
   size_t operator()(const CIString& keyval) const
   {
-    std::string keyCopy({ keyval.begin(), keyval.end() });
-    std::transform(keyCopy.begin(), keyCopy.end(), keyCopy.begin(), tolower);
-    return std::hash<std::string>()(keyCopy);
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : keyval) {
+      hash ^= static_cast<unsigned char>(tolower(c));
+      hash *= 1099511628211ull;
+    }
+    return static_cast<size_t>(hash);
   }
 };
 
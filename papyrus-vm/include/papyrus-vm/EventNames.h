@@ -0,0 +1,52 @@
+#pragma once
+#include "CIString.h"
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+
+using EventId = uint32_t;
+
+// Well-known events have the same ids in every EventNames instance, so hot
+// paths can switch over them. Order must match kWellKnownEventNames
+namespace Events {
+enum : EventId
+{
+  OnActivate,
+  OnInit,
+  OnUpdate,
+  OnObjectEquipped,
+  OnItemAdded,
+  OnTrigger,
+  OnTriggerEnter,
+  OnTriggerLeave,
+  OnBeginState,
+  OnEndState,
+
+  NumWellKnown
+};
+}
+
+// Interns Papyrus event names (case-insensitive) into small integer ids
+class EventNames
+{
+public:
+  EventNames();
+
+  // Assigns a new id if the name has not been seen before
+  EventId Intern(const char* name);
+
+  std::optional<EventId> Find(const char* name) const;
+
+  // Returned pointer stays valid for the lifetime of this object
+  const char* GetName(EventId eventId) const;
+
+  size_t GetSize() const noexcept;
+
+  // Contains only well-known events. For use where no VM is available
+  static const EventNames& GetWellKnown();
+
+private:
+  CIMap<EventId> idByName;
+  std::deque<std::string> names;
+};
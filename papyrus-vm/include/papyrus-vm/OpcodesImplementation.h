@@ -45,6 +45,9 @@ enum Opcodes
 
 VarValue StrCat(const VarValue& s1, const VarValue& s2, StringTable& table);
 
+// result may be the same variable as s1 or s2
+void StrCat(VarValue& result, const VarValue& s1, const VarValue& s2);
+
 void ArrayFindElement(VarValue& array, VarValue& result, VarValue& needValue,
                       VarValue& startIndex);
 void ArrayRFindElement(VarValue& array, VarValue& result, VarValue& needValue,
@@ -1,4 +1,5 @@
 #pragma once
+#include "EventNames.h"
 #include "Promise.h"
 #include <cassert>
 #include <functional>
@@ -91,6 +92,7 @@ public:
   explicit VarValue(int32_t value);
   explicit VarValue(const char* value);
   explicit VarValue(const std::string& value);
+  explicit VarValue(std::string&& value);
   explicit VarValue(double value);
   explicit VarValue(bool value);
   explicit VarValue(Viet::Promise<VarValue> promise);
@@ -114,6 +116,8 @@ public:
 
   std::shared_ptr<Viet::Promise<VarValue>> promise;
 
+  // Shared between copies of VarValue. Must not be modified unless
+  // use_count() is 1
   std::shared_ptr<std::string> stringHolder;
 
   int32_t GetMetaStackId() const;
@@ -144,6 +148,10 @@ public:
   VarValue CastToFloat() const;
   VarValue CastToBool() const;
 
+  // Makes this a string equal to CastToString(*this) + CastToString(value).
+  // Appends in place if the string isn't shared with other VarValues
+  void AppendString(const VarValue& value);
+
   void Then(std::function<void(VarValue)> cb);
 
 private:
@@ -402,7 +410,11 @@ public:
     std::string childrenName);
 
   FunctionInfo GetFunctionByName(const char* name,
-                                 std::string stateName) const;
+                                 const char* stateName) const;
+
+  // Same as GetFunctionByName for the active state, but remembers the result
+  // per event. Returns nullptr if the script doesn't handle the event
+  const FunctionInfo* GetEventHandler(EventId eventId, const char* eventName);
 
   VarValue& GetVariableValueByName(std::vector<Local>* optional,
                                    std::string name);
@@ -410,12 +422,15 @@ public:
   VarValue& GetIndentifierValue(std::vector<Local>& locals, VarValue& value,
                                 bool treatStringsAsIdentifiers = false);
 
-  VarValue StartFunction(FunctionInfo& function,
+  VarValue StartFunction(const FunctionInfo& function,
                          std::vector<VarValue>& arguments,
                          std::shared_ptr<StackIdHolder> stackIdHolder);
 
   static uint8_t GetTypeByName(std::string typeRef);
-  std::string GetActiveStateName() const;
+
+  // Points to the value of the ::State variable, so it's invalidated by the
+  // next state change
+  const char* GetActiveStateName() const;
 
   bool IsValid() const { return _IsValid; };
 
@@ -437,7 +452,7 @@ private:
                         std::shared_ptr<std::vector<Local>> locals);
 
   std::shared_ptr<std::vector<ActivePexInstance::Local>> MakeLocals(
-    FunctionInfo& function, std::vector<VarValue>& arguments);
+    const FunctionInfo& function, std::vector<VarValue>& arguments);
 
   VarValue ExecuteAll(
     ExecutionContext& ctx,
@@ -479,8 +494,21 @@ private:
   uint64_t promiseIdx = 0;
   std::map<uint64_t, std::shared_ptr<Viet::Promise<VarValue>>> promises;
 
+  // Indexed by EventId. An entry is looked up again when the active state
+  // changes or the script is hot reloaded
+  struct EventHandler
+  {
+    std::shared_ptr<PexScript> pex;
+    std::string stateName;
+    const FunctionInfo* function = nullptr;
+  };
+  std::vector<EventHandler> eventHandlers;
+
   VarValue noneVar = VarValue::None();
 };
 
 VarValue CastToString(const VarValue& var);
 VarValue GetElementsArrayAtString(const VarValue& array, uint8_t type);
+
+// Same as appending CastToString(var) without creating temporary VarValues
+void AppendToString(std::string& out, const VarValue& var);
@@ -1,5 +1,6 @@
 #pragma once
 #include "CIString.h"
+#include "EventNames.h"
 #include "Structures.h"
 #include <MakeID.h-1.0.2>
 #include <functional>
@@ -61,6 +62,14 @@ public:
                         const std::string& functionName,
                         const FunctionType& type, const NativeFunction& fn);
 
+  void SendEvent(std::shared_ptr<IGameObject> self, EventId eventId,
+                 const std::vector<VarValue>& arguments,
+                 OnEnter enter = nullptr);
+
+  void SendEvent(ActivePexInstance* instance, EventId eventId,
+                 const std::vector<VarValue>& arguments);
+
+  // Interns eventName on each call. Prefer EventId overloads on hot paths
   void SendEvent(std::shared_ptr<IGameObject> self, const char* eventName,
                  const std::vector<VarValue>& arguments,
                  OnEnter enter = nullptr);
@@ -68,6 +77,8 @@ public:
   void SendEvent(ActivePexInstance* instance, const char* eventName,
                  const std::vector<VarValue>& arguments);
 
+  EventNames& GetEventNames();
+
   VarValue CallMethod(IGameObject* self, const char* methodName,
                       std::vector<VarValue>& arguments,
                       std::shared_ptr<StackIdHolder> stackIdHolder = nullptr);
@@ -77,6 +88,22 @@ public:
                       std::vector<VarValue>& arguments,
                       std::shared_ptr<StackIdHolder> stackIdHolder = nullptr);
 
+  // CallMethod/CallStatic target with names resolved in advance. Static
+  // calls are resolved completely, methods cache native lookups per native
+  // class of self. Re-resolved automatically after functions are registered
+  struct PreparedCall;
+
+  // className is ignored for methods. Throws if a static function doesn't
+  // exist
+  std::shared_ptr<PreparedCall> PrepareCall(FunctionType type,
+                                            const std::string& className,
+                                            const std::string& functionName);
+
+  // self is ignored for static calls
+  VarValue CallPrepared(
+    PreparedCall& call, IGameObject* self, std::vector<VarValue>& arguments,
+    std::shared_ptr<StackIdHolder> stackIdHolder = nullptr);
+
   PexScript::Lazy GetPexByName(const std::string& name);
 
   std::shared_ptr<ActivePexInstance> CreateActivePexInstance(
@@ -89,6 +116,17 @@ public:
   ExceptionHandler GetExceptionHandler() const;
 
 private:
+  NativeFunction FindNativeMethod(const char* nativeClass,
+                                  const std::string& methodNameLower,
+                                  const char** outLastClass = nullptr);
+
+  VarValue CallScriptMethod(IGameObject* selfObj, const char* methodName,
+                            std::vector<VarValue>& arguments,
+                            std::shared_ptr<StackIdHolder> stackIdHolder,
+                            const char* lastClass);
+
+  void ResolveStatic(PreparedCall& call);
+
   CIMap<PexScript::Lazy> allLoadedScripts;
 
   std::map<std::string, std::map<std::string, NativeFunction>> nativeFunctions,
@@ -99,8 +137,14 @@ private:
 
   std::set<std::shared_ptr<IGameObject>> gameObjectsHolder;
 
+  EventNames eventNames;
+
   MissingScriptHandler missingScriptHandler;
   ExceptionHandler handler;
 
   std::shared_ptr<MakeID> stackIdMaker;
+
+  // Changes when registered functions or loaded scripts change, so that
+  // prepared calls are resolved again
+  uint64_t callResolutionVersion = 0;
 };
@@ -3,6 +3,7 @@
 #include "papyrus-vm/VirtualMachine.h"
 #include <algorithm>
 #include <cctype> // tolower
+#include <charconv>
 #include <functional>
 #include <sstream>
 #include <stdexcept>
@@ -50,28 +51,58 @@ std::shared_ptr<ActivePexInstance> ActivePexInstance::FillParentInstance(
                                            this->sourcePex.source);
 }
 
-FunctionInfo ActivePexInstance::GetFunctionByName(const char* name,
-                                                  std::string stateName) const
+namespace {
+const FunctionInfo* FindFunction(const PexScript& pex, const char* name,
+                                 const char* stateName)
 {
-
-  FunctionInfo function;
-  for (auto& object : sourcePex.fn()->objectTable) {
+  for (auto& object : pex.objectTable) {
     for (auto& state : object.states) {
       if (state.name == stateName) {
         for (auto& func : state.functions) {
           if (!Utils::stricmp(func.name.data(), name)) {
-            function = func.function;
-            function.valid = true;
-            return function;
+            return &func.function;
           }
         }
       }
     }
   }
+  return nullptr;
+}
+}
+
+FunctionInfo ActivePexInstance::GetFunctionByName(const char* name,
+                                                  const char* stateName) const
+{
+
+  FunctionInfo function;
+  if (auto found = FindFunction(*sourcePex.fn(), name, stateName)) {
+    function = *found;
+    function.valid = true;
+  }
   return function;
 }
 
-std::string ActivePexInstance::GetActiveStateName() const
+const FunctionInfo* ActivePexInstance::GetEventHandler(EventId eventId,
+                                                       const char* eventName)
+{
+  if (eventHandlers.size() <= eventId) {
+    eventHandlers.resize(eventId + 1);
+  }
+
+  auto pex = sourcePex.fn();
+  auto stateName = GetActiveStateName();
+
+  // The state name is copied only when the state changes
+  auto& handler = eventHandlers[eventId];
+  if (handler.pex != pex || handler.stateName != stateName) {
+    handler.function = FindFunction(*pex, eventName, stateName);
+    handler.pex = std::move(pex);
+    handler.stateName = stateName;
+  }
+  return handler.function;
+}
+
+const char* ActivePexInstance::GetActiveStateName() const
 {
   VarValue* var = nullptr;
   try {
@@ -143,79 +174,122 @@ VarValue CastToString(const VarValue& var)
         return VarValue(noneString.c_str());
       }
     }
-    case VarValue::kType_Identifier:
-      throw std::runtime_error(
-        "Papyrus VM: failed to get valid type indentifier, ::CastToString()");
     case VarValue::kType_String:
       return var;
-    case VarValue::kType_Integer:
-      return VarValue(std::to_string(static_cast<int32_t>(var)));
-    case VarValue::kType_Float: {
-      char buffer[512];
-      snprintf(buffer, sizeof(buffer), "%.*g", 9000, static_cast<double>(var));
-      return VarValue(std::string(buffer));
-    }
     case VarValue::kType_Bool: {
       return VarValue(static_cast<bool>(var) ? "True" : "False");
     }
-    case VarValue::kType_ObjectArray:
-      return GetElementsArrayAtString(var, var.kType_ObjectArray);
-    case VarValue::kType_StringArray:
-      return GetElementsArrayAtString(var, var.kType_StringArray);
-    case VarValue::kType_IntArray:
-      return GetElementsArrayAtString(var, var.kType_IntArray);
-    case VarValue::kType_FloatArray:
-      return GetElementsArrayAtString(var, var.kType_FloatArray);
-    case VarValue::kType_BoolArray:
-      return GetElementsArrayAtString(var, var.kType_BoolArray);
-    default:
-      throw std::runtime_error(
-        "Papyrus VM: Received wrong type, ::CastToString()");
+    default: {
+      std::string res;
+      AppendToString(res, var);
+      return VarValue(std::move(res));
+    }
   }
 }
 
 VarValue GetElementsArrayAtString(const VarValue& array, uint8_t type)
 {
-  std::string returnValue = "[";
+  std::string returnValue;
+  AppendToString(returnValue, array);
+  return VarValue(std::move(returnValue));
+}
+
+namespace {
+void AppendInt(std::string& out, int32_t value)
+{
+  char buffer[16];
+  auto res = std::to_chars(std::begin(buffer), std::end(buffer), value);
+  out.append(buffer, res.ptr);
+}
+
+void AppendFloat(std::string& out, const char* format, int precision,
+                 double value)
+{
+  char buffer[512];
+  int n = precision >= 0
+    ? snprintf(buffer, sizeof(buffer), format, precision, value)
+    : snprintf(buffer, sizeof(buffer), format, value);
+  if (n > 0) {
+    out.append(buffer, std::min<size_t>(n, sizeof(buffer) - 1));
+  }
+}
+
+void AppendArrayElementsToString(std::string& out, const VarValue& array)
+{
+  out += '[';
 
+  const auto type = array.GetType();
   for (size_t i = 0; i < array.pArray->size(); ++i) {
+    const VarValue& element = (*array.pArray)[i];
     switch (type) {
       case VarValue::kType_ObjectArray: {
-        auto object = (static_cast<IGameObject*>((*array.pArray)[i]));
-        returnValue += object ? object->GetStringID() : "None";
+        auto object = static_cast<IGameObject*>(element);
+        out += object ? object->GetStringID() : "None";
         break;
       }
 
       case VarValue::kType_StringArray:
-        returnValue += (const char*)((*array.pArray)[i]);
+        out += static_cast<const char*>(element);
         break;
 
       case VarValue::kType_IntArray:
-        returnValue += std::to_string((int)((*array.pArray)[i]));
+        AppendInt(out, static_cast<int32_t>(element));
         break;
 
       case VarValue::kType_FloatArray:
-        returnValue += std::to_string((double)((*array.pArray)[i]));
+        // Same as std::to_string
+        AppendFloat(out, "%f", -1, static_cast<double>(element));
         break;
 
-      case VarValue::kType_BoolArray: {
-        VarValue& temp = ((*array.pArray)[i]);
-        returnValue += (const char*)(CastToString(temp));
+      case VarValue::kType_BoolArray:
+        AppendToString(out, element);
         break;
-      }
-      default:
-        throw std::runtime_error(
-          " Papyrus VM: None of the type values "
-          "​​matched catched exception ::GetElementArrayAtString");
     }
 
     if (i < array.pArray->size() - 1)
-      returnValue += ", ";
+      out += ", ";
     else
-      returnValue += "]";
+      out += ']';
   }
+}
+}
 
-  return VarValue(returnValue);
+void AppendToString(std::string& out, const VarValue& var)
+{
+  switch (var.GetType()) {
+    case VarValue::kType_Object: {
+      IGameObject* ptr = ((IGameObject*)var);
+      out += ptr ? ptr->GetStringID() : "None";
+      break;
+    }
+    case VarValue::kType_Identifier:
+      throw std::runtime_error(
+        "Papyrus VM: failed to get valid type indentifier, ::CastToString()");
+    case VarValue::kType_String:
+      if (auto str = static_cast<const char*>(var)) {
+        out += str;
+      }
+      break;
+    case VarValue::kType_Integer:
+      AppendInt(out, static_cast<int32_t>(var));
+      break;
+    case VarValue::kType_Float:
+      AppendFloat(out, "%.*g", 9000, static_cast<double>(var));
+      break;
+    case VarValue::kType_Bool:
+      out += static_cast<bool>(var) ? "True" : "False";
+      break;
+    case VarValue::kType_ObjectArray:
+    case VarValue::kType_StringArray:
+    case VarValue::kType_IntArray:
+    case VarValue::kType_FloatArray:
+    case VarValue::kType_BoolArray:
+      AppendArrayElementsToString(out, var);
+      break;
+    default:
+      throw std::runtime_error(
+        "Papyrus VM: Received wrong type, ::CastToString()");
+  }
 }
 
 struct ActivePexInstance::ExecutionContext
@@ -435,8 +509,7 @@ void ActivePexInstance::ExecuteOpCode(ExecutionContext* ctx, uint8_t op,
       ctx->needReturn = true;
       break;
     case OpcodesImplementation::Opcodes::op_StrCat:
-      *args[0] = OpcodesImplementation::StrCat(
-        *args[1], *args[2], this->sourcePex.fn()->stringTable);
+      OpcodesImplementation::StrCat(*args[0], *args[1], *args[2]);
       break;
     case OpcodesImplementation::Opcodes::op_PropGet:
       // PropGet/Set seems to work only in very simple cases covered by unit
@@ -536,7 +609,7 @@ void ActivePexInstance::ExecuteOpCode(ExecutionContext* ctx, uint8_t op,
 }
 
 std::shared_ptr<std::vector<ActivePexInstance::Local>>
-ActivePexInstance::MakeLocals(FunctionInfo& function,
+ActivePexInstance::MakeLocals(const FunctionInfo& function,
                               std::vector<VarValue>& arguments)
 {
   auto locals = std::make_shared<std::vector<Local>>();
@@ -657,7 +730,7 @@ VarValue ActivePexInstance::ExecuteAll(
 }
 
 VarValue ActivePexInstance::StartFunction(
-  FunctionInfo& function, std::vector<VarValue>& arguments,
+  const FunctionInfo& function, std::vector<VarValue>& arguments,
   std::shared_ptr<StackIdHolder> stackIdHolder)
 {
   if (!stackIdHolder)
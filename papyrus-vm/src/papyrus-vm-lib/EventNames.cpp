@@ -0,0 +1,64 @@
+#include "papyrus-vm/EventNames.h"
+#include <iterator>
+#include <stdexcept>
+
+namespace {
+constexpr const char* kWellKnownEventNames[] = {
+  "OnActivate",
+  "OnInit",
+  "OnUpdate",
+  "OnObjectEquipped",
+  "OnItemAdded",
+  "OnTrigger",
+  "OnTriggerEnter",
+  "OnTriggerLeave",
+  "OnBeginState",
+  "OnEndState",
+};
+static_assert(std::size(kWellKnownEventNames) == Events::NumWellKnown);
+}
+
+EventNames::EventNames()
+{
+  for (auto name : kWellKnownEventNames) {
+    Intern(name);
+  }
+}
+
+EventId EventNames::Intern(const char* name)
+{
+  auto [it, inserted] =
+    idByName.emplace(CIString(name), static_cast<EventId>(names.size()));
+  if (inserted) {
+    names.push_back(name);
+  }
+  return it->second;
+}
+
+std::optional<EventId> EventNames::Find(const char* name) const
+{
+  auto it = idByName.find(CIString(name));
+  if (it == idByName.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+const char* EventNames::GetName(EventId eventId) const
+{
+  if (eventId >= names.size()) {
+    throw std::runtime_error("Unknown event id " + std::to_string(eventId));
+  }
+  return names[eventId].data();
+}
+
+size_t EventNames::GetSize() const noexcept
+{
+  return names.size();
+}
+
+const EventNames& EventNames::GetWellKnown()
+{
+  static const EventNames g_wellKnown;
+  return g_wellKnown;
+}
@@ -3,15 +3,24 @@
 VarValue OpcodesImplementation::StrCat(const VarValue& s1, const VarValue& s2,
                                        StringTable&)
 {
+  VarValue res;
+  StrCat(res, s1, s2);
+  return res;
+}
 
-  std::string temp;
-
-  for (auto param : { &s1, &s2 }) {
-    auto str = CastToString(*param);
-    temp += static_cast<const char*>(str);
+void OpcodesImplementation::StrCat(VarValue& result, const VarValue& s1,
+                                   const VarValue& s2)
+{
+  // 's = s + x' in a loop. Avoid copying s each time
+  if (&result == &s1) {
+    result.AppendString(s2);
+    return;
   }
 
-  return VarValue(temp);
+  std::string temp;
+  AppendToString(temp, s1);
+  AppendToString(temp, s2);
+  result = VarValue(std::move(temp));
 }
 
 void OpcodesImplementation::ArrayFindElement(VarValue& array, VarValue& result,
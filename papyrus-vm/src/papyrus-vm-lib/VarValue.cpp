@@ -2,6 +2,7 @@
 #include "papyrus-vm/VirtualMachine.h"
 
 #include <cmath>
+#include <cstring>
 #include <sstream>
 
 VarValue VarValue::CastToInt() const
@@ -52,14 +53,8 @@ VarValue VarValue::CastToBool() const
       }
     case kType_Identifier:
       throw std::runtime_error("Wrong type in CastToBool");
-    case kType_String: {
-      std::string str;
-      if (this->data.string == str) {
-        return VarValue(false);
-      } else {
-        return VarValue(true);
-      }
-    }
+    case kType_String:
+      return VarValue(this->data.string && *this->data.string);
     case kType_Integer:
       return VarValue(static_cast<bool>(this->data.i));
     case kType_Float:
@@ -158,6 +153,13 @@ VarValue::VarValue(const std::string& value)
   this->data.string = this->stringHolder->data();
 }
 
+VarValue::VarValue(std::string&& value)
+{
+  this->type = this->kType_String;
+  this->stringHolder = std::make_shared<std::string>(std::move(value));
+  this->data.string = this->stringHolder->data();
+}
+
 VarValue::VarValue(double value)
 {
   this->type = this->kType_Float;
@@ -384,12 +386,10 @@ VarValue VarValue::operator!()
       var.data.b = !this->data.b;
       var.type = this->kType_Bool;
       return var;
-    case kType_String: {
+    case kType_String:
       var.type = this->kType_Bool;
-      static const std::string g_emptyLine;
-      var.data.b = (this->data.string == g_emptyLine);
+      var.data.b = !this->data.string || !*this->data.string;
       return var;
-    }
     case kType_ObjectArray:
     case kType_StringArray:
     case kType_IntArray:
@@ -418,18 +418,9 @@ bool VarValue::operator==(const VarValue& argument2) const
         return false;
       }
 
-      std::string s1;
-      std::string s2;
-
-      if (this->data.string != nullptr) {
-        s1 = this->data.string;
-      }
-
-      if (argument2.data.string != nullptr) {
-        s2 = argument2.data.string;
-      }
-
-      return s1 == s2;
+      const char* s1 = this->data.string ? this->data.string : "";
+      const char* s2 = argument2.data.string ? argument2.data.string : "";
+      return s1 == s2 || !strcmp(s1, s2);
     }
     case VarValue::kType_Integer:
       return this->CastToInt().data.i == argument2.CastToInt().data.i;
@@ -569,12 +560,26 @@ VarValue& VarValue::operator=(const VarValue& arg2)
 
   promise = arg2.promise;
 
-  if (arg2.stringHolder) {
-    stringHolder.reset(new std::string(*arg2.stringHolder));
+  // Strings are immutable while shared, no need to copy
+  stringHolder = arg2.stringHolder;
+
+  return *this;
+}
+
+void VarValue::AppendString(const VarValue& value)
+{
+  const bool canAppendInPlace = this->type == kType_String && stringHolder &&
+    stringHolder.use_count() == 1 && data.string == stringHolder->data() &&
+    &value != this;
+
+  if (canAppendInPlace) {
+    AppendToString(*stringHolder, value);
     data.string = stringHolder->data();
-  } else {
-    stringHolder.reset();
+    return;
   }
 
-  return *this;
+  std::string res;
+  AppendToString(res, *this);
+  AppendToString(res, value);
+  *this = VarValue(std::move(res));
 }
@@ -1,17 +1,28 @@
 #include "papyrus-vm/VirtualMachine.h"
 #include "papyrus-vm/Utils.h"
 #include <algorithm>
+#include <atomic>
 #include <sstream>
 #include <stdexcept>
+#include <unordered_map>
 
 namespace {
 constexpr uint32_t g_maxStackId = 100'000;
+
+// Shared by all machines, so that a call prepared by one machine is never
+// considered resolved by another
+uint64_t NextCallResolutionVersion()
+{
+  static std::atomic<uint64_t> g_version{ 0 };
+  return ++g_version;
+}
 }
 
 VirtualMachine::VirtualMachine(
   const std::vector<PexScript::Lazy>& loadedScripts)
 {
   stackIdMaker.reset(new MakeID(g_maxStackId));
+  callResolutionVersion = NextCallResolutionVersion();
 
   for (auto& script : loadedScripts) {
     allLoadedScripts[CIString{ script.source.begin(), script.source.end() }] =
@@ -23,6 +34,7 @@ VirtualMachine::VirtualMachine(
   const std::vector<std::shared_ptr<PexScript>>& loadedScripts)
 {
   stackIdMaker.reset(new MakeID(g_maxStackId));
+  callResolutionVersion = NextCallResolutionVersion();
 
   for (auto& script : loadedScripts) {
     allLoadedScripts[CIString{ script->source.begin(),
@@ -63,6 +75,7 @@ void VirtualMachine::RegisterFunction(const std::string& className,
       nativeFunctions[ToLower(className)][ToLower(functionName)] = fn;
       break;
   }
+  callResolutionVersion = NextCallResolutionVersion();
 }
 
 void VirtualMachine::AddObject(std::shared_ptr<IGameObject> self,
@@ -85,36 +98,51 @@ void VirtualMachine::AddObject(std::shared_ptr<IGameObject> self,
 }
 
 void VirtualMachine::SendEvent(std::shared_ptr<IGameObject> self,
-                               const char* eventName,
+                               EventId eventId,
                                const std::vector<VarValue>& arguments,
                                OnEnter enter)
 {
+  auto eventName = eventNames.GetName(eventId);
   for (auto& scriptInstance : self->activePexInstances) {
-    auto name = scriptInstance->GetActiveStateName();
-
-    auto fn = scriptInstance->GetFunctionByName(
-      eventName, scriptInstance->GetActiveStateName());
-    if (fn.valid) {
+    auto fn = scriptInstance->GetEventHandler(eventId, eventName);
+    if (fn) {
       auto stackIdHolder = std::make_shared<StackIdHolder>(*this);
       if (enter)
         enter(*stackIdHolder);
       scriptInstance->StartFunction(
-        fn, const_cast<std::vector<VarValue>&>(arguments), stackIdHolder);
+        *fn, const_cast<std::vector<VarValue>&>(arguments), stackIdHolder);
     }
   }
 }
 
+void VirtualMachine::SendEvent(ActivePexInstance* instance, EventId eventId,
+                               const std::vector<VarValue>& arguments)
+{
+  auto fn = instance->GetEventHandler(eventId, eventNames.GetName(eventId));
+  if (fn) {
+    instance->StartFunction(*fn, const_cast<std::vector<VarValue>&>(arguments),
+                            std::make_shared<StackIdHolder>(*this));
+  }
+}
+
+void VirtualMachine::SendEvent(std::shared_ptr<IGameObject> self,
+                               const char* eventName,
+                               const std::vector<VarValue>& arguments,
+                               OnEnter enter)
+{
+  SendEvent(self, eventNames.Intern(eventName), arguments, enter);
+}
+
 void VirtualMachine::SendEvent(ActivePexInstance* instance,
                                const char* eventName,
                                const std::vector<VarValue>& arguments)
 {
+  SendEvent(instance, eventNames.Intern(eventName), arguments);
+}
 
-  auto fn =
-    instance->GetFunctionByName(eventName, instance->GetActiveStateName());
-  if (fn.valid) {
-    instance->StartFunction(fn, const_cast<std::vector<VarValue>&>(arguments),
-                            std::make_shared<StackIdHolder>(*this));
-  }
+EventNames& VirtualMachine::GetEventNames()
+{
+  return eventNames;
 }
 
 StackIdHolder::StackIdHolder(VirtualMachine& vm_)
@@ -137,6 +165,27 @@ int32_t StackIdHolder::GetStackId() const
   return stackId;
 }
 
+struct VirtualMachine::PreparedCall
+{
+  FunctionType type = FunctionType::GlobalFunction;
+  std::string className;
+  std::string functionName;
+  std::string functionNameLower;
+
+  // 0 means not resolved yet
+  uint64_t version = 0;
+
+  // Static calls: either a native function or a script function
+  NativeFunction nativeStatic;
+  std::shared_ptr<ActivePexInstance> instance;
+  FunctionInfo function;
+
+  // Methods: native function (or null) and the last class checked by
+  // FindNativeMethod, by the native class of self
+  std::unordered_map<std::string, std::pair<NativeFunction, std::string>>
+    nativeMethodsByClass;
+};
+
 VarValue VirtualMachine::CallMethod(
   IGameObject* selfObj, const char* methodName,
   std::vector<VarValue>& arguments,
@@ -150,13 +199,33 @@ VarValue VirtualMachine::CallMethod(
     return VarValue::None();
   }
 
-  const char* nativeClass = selfObj->GetParentNativeScript();
+  const char* lastClass = "";
+  if (auto f = FindNativeMethod(selfObj->GetParentNativeScript(),
+                                ToLower(methodName), &lastClass)) {
+    auto self = VarValue(selfObj);
+    self.SetMetaStackIdHolder(stackIdHolder);
+    return f(self, arguments);
+  }
+
+  return CallScriptMethod(selfObj, methodName, arguments, stackIdHolder,
+                          lastClass);
+}
+
+NativeFunction VirtualMachine::FindNativeMethod(
+  const char* nativeClass, const std::string& methodNameLower,
+  const char** outLastClass)
+{
   const char* base = nativeClass;
   while (1) {
-    if (auto f = nativeFunctions[ToLower(base)][ToLower(methodName)]) {
-      auto self = VarValue(selfObj);
-      self.SetMetaStackIdHolder(stackIdHolder);
-      return f(self, arguments);
+    if (outLastClass) {
+      *outLastClass = base;
+    }
+    auto classIt = nativeFunctions.find(ToLower(base));
+    if (classIt != nativeFunctions.end()) {
+      auto it = classIt->second.find(methodNameLower);
+      if (it != classIt->second.end() && it->second) {
+        return it->second;
+      }
     }
     auto it = allLoadedScripts.find(base);
     if (it == allLoadedScripts.end())
@@ -165,7 +234,14 @@ VarValue VirtualMachine::CallMethod(
     if (!base[0])
       break;
   }
+  return nullptr;
+}
 
+VarValue VirtualMachine::CallScriptMethod(
+  IGameObject* selfObj, const char* methodName,
+  std::vector<VarValue>& arguments,
+  std::shared_ptr<StackIdHolder> stackIdHolder, const char* lastClass)
+{
   for (auto& activeScript : selfObj->activePexInstances) {
     FunctionInfo functionInfo;
 
@@ -186,8 +262,8 @@ VarValue VirtualMachine::CallMethod(
   }
 
   std::string e = "Method not found - '";
-  e += base;
-  e += (base[0] ? "." : "") + std::string(methodName) + "'";
+  e += lastClass;
+  e += (lastClass[0] ? "." : "") + std::string(methodName) + "'";
   throw std::runtime_error(e);
 }
 
@@ -196,30 +272,56 @@ VarValue VirtualMachine::CallStatic(
   std::vector<VarValue>& arguments,
   std::shared_ptr<StackIdHolder> stackIdHolder)
 {
-  if (!stackIdHolder) {
-    stackIdHolder.reset(new StackIdHolder(*this));
-  }
-
-  VarValue result = VarValue::None();
-  FunctionInfo function;
+  // Version is 0, so CallPrepared resolves it
+  PreparedCall call;
+  call.type = FunctionType::GlobalFunction;
+  call.className = className;
+  call.functionName = functionName;
+  call.functionNameLower = ToLower(functionName);
+  return CallPrepared(call, nullptr, arguments, stackIdHolder);
+}
 
-  auto functionNameLower = ToLower(functionName);
-  auto f = nativeStaticFunctions[ToLower(className)][functionNameLower]
-    ? nativeStaticFunctions[ToLower(className)][functionNameLower]
-    : nativeStaticFunctions[""][functionNameLower];
+std::shared_ptr<VirtualMachine::PreparedCall> VirtualMachine::PrepareCall(
+  FunctionType type, const std::string& className,
+  const std::string& functionName)
+{
+  auto call = std::make_shared<PreparedCall>();
+  call->type = type;
+  call->className = className;
+  call->functionName = functionName;
+  call->functionNameLower = ToLower(functionName);
+  if (type == FunctionType::GlobalFunction) {
+    ResolveStatic(*call);
+  }
+  call->version = callResolutionVersion;
+  return call;
+}
 
-  if (f) {
-    auto self = VarValue::None();
-    self.SetMetaStackIdHolder(stackIdHolder);
-    return f(self, arguments);
+void VirtualMachine::ResolveStatic(PreparedCall& call)
+{
+  call.nativeStatic = nullptr;
+  call.instance = nullptr;
+  call.function = FunctionInfo();
+
+  for (auto classNameLower : { ToLower(call.className), std::string() }) {
+    auto classIt = nativeStaticFunctions.find(classNameLower);
+    if (classIt != nativeStaticFunctions.end()) {
+      auto it = classIt->second.find(call.functionNameLower);
+      if (it != classIt->second.end() && it->second) {
+        call.nativeStatic = it->second;
+        return;
+      }
+    }
   }
 
+  const auto& className = call.className;
   auto classNameCi = CIString{ className.begin(), className.end() };
   auto it = allLoadedScripts.find(classNameCi);
   if (it == allLoadedScripts.end()) {
     if (this->missingScriptHandler) {
       if (auto newScript = this->missingScriptHandler(className)) {
         allLoadedScripts[classNameCi] = *newScript;
+        callResolutionVersion = NextCallResolutionVersion();
       }
     }
     it = allLoadedScripts.find(classNameCi);
@@ -233,22 +335,68 @@ VarValue VirtualMachine::CallStatic(
                                                    VarValue::None(), "");
   }
 
-  function = instance->GetFunctionByName(functionName.c_str(), "");
+  auto function = instance->GetFunctionByName(call.functionName.c_str(), "");
+  if (!function.valid) {
+    throw std::runtime_error("Function is not valid - '" + call.functionName +
+                             "'");
+  }
+  if (function.IsNative()) {
+    throw std::runtime_error("Function not found - '" + call.functionName +
+                             "'");
+  }
+
+  call.instance = instance;
+  call.function = std::move(function);
+}
 
-  if (function.valid) {
-    if (function.IsNative()) {
-      throw std::runtime_error("Function not found - '" +
-                               std::string(functionName) + "'");
+VarValue VirtualMachine::CallPrepared(
+  PreparedCall& call, IGameObject* self, std::vector<VarValue>& arguments,
+  std::shared_ptr<StackIdHolder> stackIdHolder)
+{
+  if (call.version != callResolutionVersion) {
+    call.nativeMethodsByClass.clear();
+    if (call.type == FunctionType::GlobalFunction) {
+      ResolveStatic(call);
     }
+    call.version = callResolutionVersion;
+  }
 
-    result = instance->StartFunction(function, arguments, stackIdHolder);
+  if (!stackIdHolder) {
+    stackIdHolder.reset(new StackIdHolder(*this));
   }
-  if (!function.valid) {
-    throw std::runtime_error("Function is not valid - '" +
-                             std::string(functionName) + "'");
+
+  if (call.type == FunctionType::GlobalFunction) {
+    if (call.nativeStatic) {
+      auto selfValue = VarValue::None();
+      selfValue.SetMetaStackIdHolder(stackIdHolder);
+      return call.nativeStatic(selfValue, arguments);
+    }
+    return call.instance->StartFunction(call.function, arguments,
+                                        stackIdHolder);
+  }
+
+  if (!self) {
+    return VarValue::None();
+  }
+
+  auto [it, inserted] =
+    call.nativeMethodsByClass.try_emplace(self->GetParentNativeScript());
+  auto& [nativeMethod, lastClass] = it->second;
+  if (inserted) {
+    const char* lastClassPtr = "";
+    nativeMethod = FindNativeMethod(self->GetParentNativeScript(),
+                                    call.functionNameLower, &lastClassPtr);
+    lastClass = lastClassPtr;
+  }
+
+  if (nativeMethod) {
+    auto selfValue = VarValue(self);
+    selfValue.SetMetaStackIdHolder(stackIdHolder);
+    return nativeMethod(selfValue, arguments);
   }
 
-  return result;
+  return CallScriptMethod(self, call.functionName.c_str(), arguments,
+                          stackIdHolder, lastClass.c_str());
 }
 
 PexScript::Lazy VirtualMachine::GetPexByName(const std::string& name)
@@ -26,6 +26,8 @@ export enum MsgType {
   OnHit = 17,
   DeathStateContainer = 18,
   DropItem = 19,
+  RequestGamemodeData = 20,
+  UpdatePropertyBatch = 21,
 }
 
 export interface SetInventory {
@@ -97,6 +99,11 @@ export interface UpdatePropertyMessage {
   propName: string;
 }
 
+export interface UpdatePropertyBatchMessage {
+  t: MsgType.UpdatePropertyBatch;
+  updates: UpdatePropertyMessage[];
+}
+
 export interface ChangeValuesMessage {
   t: MsgType.ChangeValues;
   data: ActorValues;
@@ -135,9 +142,41 @@ export interface HostStopMessage {
   target: number;
 }
 
+export interface JoinQueueMessage {
+  type: "joinQueue";
+  position: number;
+}
+
 export interface UpdateGamemodeDataMessage {
   type: "updateGamemodeData";
   eventSources: Record<string, string>;
   updateOwnerFunctions: Record<string, string>;
   updateNeighborFunctions: Record<string, string>;
 }
+
+// Entry name => content hash, for each section of UpdateGamemodeDataMessage
+export interface GamemodeDataHashes {
+  eventSources: Record<string, string>;
+  updateOwnerFunctions: Record<string, string>;
+  updateNeighborFunctions: Record<string, string>;
+}
+
+export interface GamemodeDataManifestMessage {
+  type: "gamemodeDataManifest";
+  version: number;
+  hashes: GamemodeDataHashes;
+}
+
+export interface GamemodeDataDeltaMessage {
+  type: "gamemodeDataDelta";
+  version: number;
+  hashes: GamemodeDataHashes;
+  removed: Record<keyof GamemodeDataHashes, string[]>;
+  bodies: Record<string, string>;
+}
+
+export interface GamemodeDataBodiesMessage {
+  type: "gamemodeDataBodies";
+  version: number;
+  bodies: Record<string, string>;
+}
@@ -81,6 +81,12 @@ const skipFormViewCreation = (
 // eventSource system
 //
 
+const gamemodeDataSections: Array<keyof messages.GamemodeDataHashes> = [
+  'eventSources',
+  'updateOwnerFunctions',
+  'updateNeighborFunctions',
+];
+
 const setupEventSource = (ctx: any) => {
   once('update', () => {
     try {
@@ -260,6 +266,10 @@ export class RemoteServer implements MsgHandler, ModelSource, SendTarget {
   }
 
   createActor(msg: messages.CreateActorMessage): void {
+    if (msg.isMe) {
+      storage['joinQueuePosition'] = undefined;
+    }
+
     if (skipFormViewCreation(msg)) {
       const refrId = msg.refrId!;
       onceLoad(refrId, (refr: ObjectReference) => {
@@ -586,6 +596,12 @@ export class RemoteServer implements MsgHandler, ModelSource, SendTarget {
     (form as Record<string, unknown>)[msg.propName] = msg.data;
   }
 
+  UpdatePropertyBatch(msg: messages.UpdatePropertyBatchMessage): void {
+    for (const update of msg.updates) {
+      this.UpdateProperty(update);
+    }
+  }
+
   DeathStateContainer(msg: messages.DeathStateContainerMessage): void {
     once('update', () =>
       printConsole(`Received death state: ${JSON.stringify(msg.tIsDead)}`),
@@ -637,6 +653,17 @@ export class RemoteServer implements MsgHandler, ModelSource, SendTarget {
     });
   }
 
+  joinQueue(msg: messages.JoinQueueMessage): void {
+    // Positions change every server tick, don't spam notifications
+    const shouldNotify =
+      storage['joinQueuePosition'] === undefined || msg.position % 10 === 0;
+    storage['joinQueuePosition'] = msg.position;
+    if (shouldNotify) {
+      sp.Debug.notification(`Position in the queue: ${msg.position}`);
+      printConsole('Position in the join queue:', msg.position);
+    }
+  }
+
   setRaceMenuOpen(msg: messages.SetRaceMenuOpenMessage): void {
     if (msg.open) {
       // wait 0.3s cause we can see visual bugs when teleporting
@@ -704,6 +731,106 @@ export class RemoteServer implements MsgHandler, ModelSource, SendTarget {
     storage[`${storageVar}_keys`] = Object.keys(storage[storageVar] as any);
   }
 
+  gamemodeDataManifest(msg: messages.GamemodeDataManifestMessage): void {
+    storage['gamemodeDataHashes'] = msg.hashes;
+    storage['gamemodeDataVersion'] = msg.version;
+    storage['gamemodeDataAppliedVersion'] = undefined;
+
+    const missing = this.getMissingGamemodeDataHashes();
+    if (missing.length > 0) {
+      this.requestGamemodeData(missing, false);
+    } else {
+      this.applyGamemodeData();
+    }
+  }
+
+  gamemodeDataDelta(msg: messages.GamemodeDataDeltaMessage): void {
+    const hashes = storage['gamemodeDataHashes'] as
+      | messages.GamemodeDataHashes
+      | undefined;
+    const version = storage['gamemodeDataVersion'] as number | undefined;
+
+    // The delta is relative to a version we don't have
+    if (!hashes || version === undefined || msg.version !== version + 1) {
+      printConsole(
+        `Got gamemodeDataDelta ${msg.version} having ${version}, requesting manifest`,
+      );
+      this.requestGamemodeData([], true);
+      return;
+    }
+    for (const section of gamemodeDataSections) {
+      Object.assign(hashes[section], msg.hashes[section]);
+      msg.removed[section].forEach((name) => delete hashes[section][name]);
+    }
+    storage['gamemodeDataVersion'] = msg.version;
+    this.cacheGamemodeDataBodies(msg.bodies);
+    this.applyGamemodeData();
+  }
+
+  gamemodeDataBodies(msg: messages.GamemodeDataBodiesMessage): void {
+    this.cacheGamemodeDataBodies(msg.bodies);
+    this.applyGamemodeData();
+  }
+
+  // Not this.send since the manifest usually arrives before our actor
+  private requestGamemodeData(hashes: string[], manifest: boolean): void {
+    netInfo.NetInfo.addSentPacketCount(1);
+    networking.send(
+      { t: messages.MsgType.RequestGamemodeData, hashes, manifest },
+      true,
+    );
+  }
+
+  private cacheGamemodeDataBodies(bodies: Record<string, string>): void {
+    storage['gamemodeDataBodies'] = {
+      ...(storage['gamemodeDataBodies'] as Record<string, string>),
+      ...bodies,
+    };
+  }
+
+  private getMissingGamemodeDataHashes(): string[] {
+    const hashes = storage['gamemodeDataHashes'] as messages.GamemodeDataHashes;
+    const bodies = (storage['gamemodeDataBodies'] || {}) as Record<
+      string,
+      string
+    >;
+    const missing: Record<string, true> = {};
+    for (const section of gamemodeDataSections) {
+      for (const hash of Object.values(hashes[section])) {
+        if (typeof bodies[hash] !== 'string') missing[hash] = true;
+      }
+    }
+    return Object.keys(missing);
+  }
+
+  // Does nothing until all bodies of the current version are cached
+  private applyGamemodeData(): void {
+    const version = storage['gamemodeDataVersion'];
+    if (storage['gamemodeDataAppliedVersion'] === version) return;
+    if (this.getMissingGamemodeDataHashes().length > 0) return;
+
+    const hashes = storage['gamemodeDataHashes'] as messages.GamemodeDataHashes;
+    const bodies = storage['gamemodeDataBodies'] as Record<string, string>;
+    const msg: messages.UpdateGamemodeDataMessage = {
+      type: 'updateGamemodeData',
+      eventSources: {},
+      updateOwnerFunctions: {},
+      updateNeighborFunctions: {},
+    };
+    const usedBodies: Record<string, string> = {};
+    for (const section of gamemodeDataSections) {
+      for (const [name, hash] of Object.entries(hashes[section])) {
+        msg[section][name] = bodies[hash];
+        usedBodies[hash] = bodies[hash];
+      }
+    }
+
+    // Bodies of outdated entries are not needed anymore
+    storage['gamemodeDataBodies'] = usedBodies;
+    storage['gamemodeDataAppliedVersion'] = version;
+    this.updateGamemodeData(msg);
+  }
+
   updateGamemodeData(msg: messages.UpdateGamemodeDataMessage): void {
     //
     // updateOwnerFunctions/updateNeighborFunctions
@@ -123,6 +123,11 @@ export interface ServerSettings {
   startPoints?: StartPoint[];
   isPapyrusHotReloadEnabled?: boolean;
   locale?: string;
+  packetHistory?: {
+    blockSizeBytes?: number;
+    ringCapacityBytes?: number;
+    spillDirectory?: string;
+  };
 
   // TODO: add missing settings items here if any, sync with docs/docs_server_configuration_reference.md
   sweetPieMinimumPlayersToStart?: number;
@@ -138,6 +143,26 @@ export interface ServerSettings {
   readonly [key: string]: unknown;
 }
 
+export interface PlaceRequest {
+  baseId: number;
+  pos: [number, number, number];
+  // Defaults to [0, 0, 0]
+  angle?: [number, number, number];
+  // Defaults to Tamriel ('3c:Skyrim.esm')
+  worldOrCellDesc?: string;
+  // Same as mp.set for each property. 'pos', 'angle', 'worldOrCellDesc' and 'locationalData' are not allowed here
+  properties?: Record<string, unknown>;
+}
+
+export interface NeighborsChangeEvent {
+  // Flat [emitterId, listenerId, ...] pairs
+  entered: Uint32Array;
+  left: Uint32Array;
+  // Actors that got or lost a user
+  online: Uint32Array;
+  offline: Uint32Array;
+}
+
 export interface Mp {
   /**
    * Returns the actual value of a specified property. If there is no value, then
@@ -200,6 +225,12 @@ export interface Mp {
 
   lookupEspmRecordById(globalRecordId: number): EspmLookupResult | Partial<EspmLookupResult>;
 
+  /**
+   * Batched lookupEspmRecordById. Field data of a record are views over a single copied
+   * ArrayBuffer instead of separate copies.
+   */
+  lookupEspmRecordsById(globalRecordIds: number[]): (EspmLookupResult | Partial<EspmLookupResult>)[];
+
   getEspmLoadOrder(): string[];
 
   getDescFromId(formId: number): string;
@@ -210,6 +241,12 @@ export interface Mp {
 
   place(globalRecordId: number): number;
 
+  /**
+   * Batched place. References are created at their initial places with properties already set
+   * and become visible to players only after the whole batch is created. Returns form ids in order of requests.
+   */
+  placeMany(requests: PlaceRequest[]): number[];
+
   registerPapyrusFunction(callType: 'method', className: string, functionName: string, f: PapyrusMethod): void;
   registerPapyrusFunction(callType: 'global', className: string, functionName: string, f: PapyrusGlobalFunction): void;
 
@@ -228,12 +265,28 @@ export interface Mp {
     args: PapyrusValue[]
   ): PapyrusValue;
 
+  /**
+   * Resolves the function once and returns a handle for callPreparedPapyrusFunction. Preparing the
+   * same call again returns the same handle.
+   */
+  preparePapyrusCall(callType: 'method' | 'global', className: string, functionName: string): number;
+
+  callPreparedPapyrusFunction(handle: number, self: PapyrusObject | null, args: PapyrusValue[]): PapyrusValue;
+
   getServerSettings(): ServerSettings;
 
   setPacketHistoryRecording(userId: number, enabled: boolean): void;
   getPacketHistory(userId: number): PacketHistory;
+  // Writes recorded packets to the spill file and returns its path ('' if packetHistory.spillDirectory is not set)
+  spillPacketHistory(userId: number): string;
   clearPacketHistory(userId: number): void;
-  requestPacketHistoryPlayback(userId: number, packetHistory: PacketHistory): void;
+  requestPacketHistoryPlayback(userId: number, packetHistory: PacketHistory | string): void;
+
+  // Writes saved and pending change forms to a gzip archive, one JSON per line. Resolves with the number of change forms written
+  createSnapshot(path: string): Promise<number>;
+
+  // Called once per tick with subscription and online status changes since the previous call
+  onNeighborsChange?: (event: NeighborsChangeEvent) => void;
 
   [key: string]: unknown;
 }
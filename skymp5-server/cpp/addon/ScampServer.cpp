@@ -2,6 +2,7 @@
 
 #include "AsyncSaveStorage.h"
 #include "Bot.h"
+#include "EspmFieldsUtils.h"
 #include "EspmGameObject.h"
 #include "FileDatabase.h"
 #include "FormCallbacks.h"
@@ -19,6 +20,7 @@
 #include "formulas/SweetPieDamageFormula.h"
 #include "formulas/TES5DamageFormula.h"
 #include "property_bindings/PropertyBindingFactory.h"
+#include <algorithm>
 #include <cassert>
 #include <cctype>
 #include <memory>
@@ -89,21 +91,30 @@ Napi::Object ScampServer::Init(Napi::Env env, Napi::Object exports)
       InstanceMethod("get", &ScampServer::Get),
       InstanceMethod("set", &ScampServer::Set),
       InstanceMethod("place", &ScampServer::Place),
+      InstanceMethod("placeMany", &ScampServer::PlaceMany),
       InstanceMethod("lookupEspmRecordById",
                      &ScampServer::LookupEspmRecordById),
+      InstanceMethod("lookupEspmRecordsById",
+                     &ScampServer::LookupEspmRecordsById),
       InstanceMethod("getEspmLoadOrder", &ScampServer::GetEspmLoadOrder),
       InstanceMethod("getDescFromId", &ScampServer::GetDescFromId),
       InstanceMethod("getIdFromDesc", &ScampServer::GetIdFromDesc),
       InstanceMethod("callPapyrusFunction", &ScampServer::CallPapyrusFunction),
+      InstanceMethod("preparePapyrusCall", &ScampServer::PreparePapyrusCall),
+      InstanceMethod("callPreparedPapyrusFunction",
+                     &ScampServer::CallPreparedPapyrusFunction),
       InstanceMethod("registerPapyrusFunction",
                      &ScampServer::RegisterPapyrusFunction),
       InstanceMethod("sendCustomPacket", &ScampServer::SendCustomPacket),
       InstanceMethod("setPacketHistoryRecording",
                      &ScampServer::SetPacketHistoryRecording),
       InstanceMethod("getPacketHistory", &ScampServer::GetPacketHistory),
+      InstanceMethod("spillPacketHistory", &ScampServer::SpillPacketHistory),
       InstanceMethod("clearPacketHistory", &ScampServer::ClearPacketHistory),
       InstanceMethod("requestPacketHistoryPlayback",
-                     &ScampServer::RequestPacketHistoryPlayback) });
+                     &ScampServer::RequestPacketHistoryPlayback),
+      InstanceMethod("createSnapshot", &ScampServer::CreateSnapshot),
+      InstanceMethod("getIngressStats", &ScampServer::GetIngressStats) });
   constructor = Napi::Persistent(func);
   constructor.SuppressDestruct();
   exports.Set("ScampServer", func);
@@ -229,6 +240,66 @@ ScampServer::ScampServer(const Napi::CallbackInfo& info)
       logger->info("'{}' will be relooted every {} ms", recordType, timeMs);
     }
 
+    if (serverSettings["maxRelootsPerTick"].is_number_unsigned()) {
+      partOne->worldState.maxRelootsPerTick =
+        serverSettings["maxRelootsPerTick"].get<size_t>();
+    }
+
+    if (serverSettings["maxPapyrusUpdatesPerTick"].is_number_unsigned()) {
+      partOne->worldState.maxPapyrusUpdatesPerTick =
+        serverSettings["maxPapyrusUpdatesPerTick"].get<size_t>();
+    }
+
+    if (serverSettings["deferPropertyBroadcasts"].is_boolean()) {
+      partOne->worldState.deferPropertyBroadcasts =
+        serverSettings["deferPropertyBroadcasts"].get<bool>();
+    }
+
+    if (auto joinQueue = serverSettings["joinQueue"]; joinQueue.is_object()) {
+      JoinQueueSettings settings;
+      if (joinQueue["maxActivationsPerTick"].is_number_unsigned()) {
+        settings.maxActivationsPerTick = joinQueue["maxActivationsPerTick"];
+      }
+      if (joinQueue["maxPreloadsPerTick"].is_number_unsigned()) {
+        settings.maxPreloadsPerTick = joinQueue["maxPreloadsPerTick"];
+      }
+      partOne->SetJoinQueueSettings(settings);
+    }
+
+    if (auto ingress = serverSettings["ingress"]; ingress.is_object()) {
+      IngressQueueSettings settings;
+      if (ingress["maxPacketsPerTick"].is_number_unsigned()) {
+        settings.maxPacketsPerTick = ingress["maxPacketsPerTick"];
+      }
+      if (ingress["maxTimePerTickMs"].is_number()) {
+        auto ms = ingress["maxTimePerTickMs"].get<double>();
+        settings.maxTimePerTick =
+          std::chrono::microseconds(static_cast<int64_t>(ms * 1000));
+      }
+      if (ingress["maxQueuedPacketsPerUser"].is_number_unsigned()) {
+        settings.maxQueuedPacketsPerUser = ingress["maxQueuedPacketsPerUser"];
+      }
+      ingressQueue = std::make_unique<IngressQueue>(settings);
+    }
+
+    if (auto packetHistory = serverSettings["packetHistory"];
+        packetHistory.is_object()) {
+      PacketHistoryRecorderSettings settings;
+      if (packetHistory["blockSizeBytes"].is_number_unsigned()) {
+        settings.blockSizeBytes = packetHistory["blockSizeBytes"];
+      }
+      if (packetHistory["ringCapacityBytes"].is_number_unsigned()) {
+        settings.ringCapacityBytes = packetHistory["ringCapacityBytes"];
+      }
+      if (packetHistory["spillDirectory"].is_string()) {
+        settings.spillDirectory =
+          static_cast<std::string>(packetHistory["spillDirectory"]);
+      }
+      partOne->SetPacketHistorySettings(settings);
+      logger->info("Packet history spill directory is '{}'",
+                   settings.spillDirectory.string());
+    }
+
     auto res =
       NapiHelper::RunScript(Env(),
                             "let require = global.require || "
@@ -261,20 +332,104 @@ Napi::Value ScampServer::Tick(const Napi::CallbackInfo& info)
     bool tickFinished = false;
     while (!tickFinished) {
       try {
-        server->Tick(PartOne::HandlePacket, partOne.get());
+        if (ingressQueue) {
+          server->Tick(IngressQueue::Push, ingressQueue.get());
+        } else {
+          server->Tick(PartOne::HandlePacket, partOne.get());
+        }
         tickFinished = true;
       } catch (std::exception& e) {
         logger->error("{}", e.what());
       }
     }
 
+    if (ingressQueue) {
+      ProcessIngressQueue();
+    }
+
     partOne->Tick();
+
+    DispatchNeighborEvents();
   } catch (std::exception& e) {
     throw Napi::Error::New(info.Env(), std::string(e.what()));
   }
   return info.Env().Undefined();
 }
 
+void ScampServer::DispatchNeighborEvents()
+{
+  auto& worldState = partOne->worldState;
+
+  Napi::Function f;
+  auto mpValue = tickEnv.Global().Get("mp");
+  if (mpValue.IsObject()) {
+    auto fValue = mpValue.As<Napi::Object>().Get("onNeighborsChange");
+    if (fValue.IsFunction()) {
+      f = fValue.As<Napi::Function>();
+    }
+  }
+
+  // Events are recorded only while somebody listens. Subscriptions made
+  // before the handler was assigned are not reported
+  worldState.neighborEventsEnabled = !f.IsEmpty();
+  if (f.IsEmpty()) {
+    worldState.neighborEvents.Take();
+    return;
+  }
+  if (worldState.neighborEvents.Empty()) {
+    return;
+  }
+
+  auto batch = worldState.neighborEvents.Take();
+
+  auto toTypedArray = [this](const std::vector<uint32_t>& values) {
+    auto arr = Napi::Uint32Array::New(tickEnv, values.size());
+    std::copy(values.begin(), values.end(), arr.Data());
+    return arr;
+  };
+
+  auto event = Napi::Object::New(tickEnv);
+  event.Set("entered", toTypedArray(batch.entered));
+  event.Set("left", toTypedArray(batch.left));
+  event.Set("online", toTypedArray(batch.online));
+  event.Set("offline", toTypedArray(batch.offline));
+
+  try {
+    f.Call({ event });
+  } catch (Napi::Error& e) {
+    logger->error("'onNeighborsChange' handler finished with javascript "
+                  "error '{}'",
+                  e.Message());
+  }
+}
+
+void ScampServer::ProcessIngressQueue()
+{
+  ingressQueue->BeginTick();
+
+  bool processFinished = false;
+  while (!processFinished) {
+    try {
+      ingressQueue->Process(PartOne::HandlePacket, partOne.get());
+      processFinished = true;
+    } catch (std::exception& e) {
+      logger->error("{}", e.what());
+    }
+  }
+
+  auto& stats = ingressQueue->GetStats();
+  auto now = std::chrono::steady_clock::now();
+  if (stats.numQueuedPackets > 0 &&
+      now - lastIngressBacklogWarning > std::chrono::seconds(10)) {
+    lastIngressBacklogWarning = now;
+    logger->warn("Ingress backlog: {} packets deferred to the next tick, "
+                 "{} deferred ticks, {} coalesced movements and {} dropped "
+                 "packets total",
+                 stats.numQueuedPackets, stats.numDeferredTicks,
+                 stats.numCoalescedMovements, stats.numDroppedPackets);
+  }
+}
+
 Napi::Value ScampServer::On(const Napi::CallbackInfo& info)
 {
   auto on = emitter.Get("on").As<Napi::Function>();
@@ -734,27 +889,7 @@ Napi::Value ScampServer::Set(const Napi::CallbackInfo& info)
     auto propertyName = NapiHelper::ExtractString(info[1], "propertyName");
     auto value = info[2];
 
-    static auto g_standardPropertyBindings =
-      PropertyBindingFactory().CreateStandardPropertyBindings();
-
-    auto it = g_standardPropertyBindings.find(propertyName);
-    if (it != g_standardPropertyBindings.end()) {
-      if (spdlog::should_log(spdlog::level::trace)) {
-        spdlog::trace("ScampServer::Set {:x} - {}={} (native property)",
-                      formId, propertyName,
-                      static_cast<std::string>(value.ToString()));
-      }
-      it->second->Set(info.Env(), *this, formId, value);
-    } else {
-      if (spdlog::should_log(spdlog::level::trace)) {
-        spdlog::trace("ScampServer::Set {:x} - {}={} (custom property)",
-                      formId, propertyName,
-                      static_cast<std::string>(value.ToString()));
-      }
-      PropertyBindingFactory()
-        .CreateCustomPropertyBinding(propertyName)
-        ->Set(info.Env(), *this, formId, value);
-    }
+    SetProperty(info.Env(), formId, propertyName, value);
 
     return info.Env().Undefined();
   } catch (std::exception& e) {
@@ -762,42 +897,110 @@ Napi::Value ScampServer::Set(const Napi::CallbackInfo& info)
   }
 }
 
-Napi::Value ScampServer::Place(const Napi::CallbackInfo& info)
+void ScampServer::SetProperty(Napi::Env env, uint32_t formId,
+                              const std::string& propertyName,
+                              Napi::Value value)
 {
-  try {
-    auto globalRecordId = NapiHelper::ExtractUInt32(info[0], "globalRecordId");
-    auto akFormToPlace =
-      partOne->GetEspm().GetBrowser().LookupById(globalRecordId);
-    if (!akFormToPlace.rec) {
-      std::stringstream ss;
-      ss << std::hex << "Bad record Id " << globalRecordId;
-      throw std::runtime_error(ss.str());
+  static auto g_standardPropertyBindings =
+    PropertyBindingFactory().CreateStandardPropertyBindings();
+
+  auto it = g_standardPropertyBindings.find(propertyName);
+  if (it != g_standardPropertyBindings.end()) {
+    if (spdlog::should_log(spdlog::level::trace)) {
+      spdlog::trace("ScampServer::Set {:x} - {}={} (native property)", formId,
+                    propertyName, static_cast<std::string>(value.ToString()));
     }
+    it->second->Set(env, *this, formId, value);
+  } else {
+    if (spdlog::should_log(spdlog::level::trace)) {
+      spdlog::trace("ScampServer::Set {:x} - {}={} (custom property)", formId,
+                    propertyName, static_cast<std::string>(value.ToString()));
+    }
+    PropertyBindingFactory()
+      .CreateCustomPropertyBinding(propertyName)
+      ->Set(env, *this, formId, value);
+  }
+}
 
-    std::string type = akFormToPlace.rec->GetType().ToString();
+Napi::Value ScampServer::Place(const Napi::CallbackInfo& info)
+{
+  try {
+    PlaceRequest request;
+    request.baseId = NapiHelper::ExtractUInt32(info[0], "globalRecordId");
 
-    LocationalData locationalData = { { 0, 0, 0 },
-                                      { 0, 0, 0 },
-                                      FormDesc::Tamriel() };
-    FormCallbacks callbacks = partOne->CreateFormCallbacks();
+    auto formIds = partOne->PlaceReferences({ request });
+    return Napi::Number::New(info.Env(), formIds[0]);
+  } catch (std::exception& e) {
+    throw Napi::Error::New(info.Env(), std::string(e.what()));
+  }
+}
 
-    std::unique_ptr<MpObjectReference> newRefr;
-    if (akFormToPlace.rec->GetType() == "NPC_") {
-      auto actor = new MpActor(locationalData, callbacks, globalRecordId);
-      newRefr.reset(actor);
-    } else {
-      newRefr.reset(new MpObjectReference(locationalData, callbacks,
-                                          globalRecordId, type));
+Napi::Value ScampServer::PlaceMany(const Napi::CallbackInfo& info)
+{
+  try {
+    auto jsRequests = NapiHelper::ExtractArray(info[0], "requests");
+
+    std::vector<PlaceRequest> requests;
+    std::vector<Napi::Object> jsProperties;
+    requests.reserve(jsRequests.Length());
+    jsProperties.reserve(jsRequests.Length());
+
+    for (uint32_t i = 0; i < jsRequests.Length(); ++i) {
+      auto jsRequest = NapiHelper::ExtractObject(jsRequests.Get(i), "request");
+
+      PlaceRequest request;
+      request.baseId =
+        NapiHelper::ExtractUInt32(jsRequest.Get("baseId"), "request.baseId");
+      request.locationalData.pos =
+        NapiHelper::ExtractNiPoint3(jsRequest.Get("pos"), "request.pos");
+      if (!jsRequest.Get("angle").IsUndefined()) {
+        request.locationalData.rot =
+          NapiHelper::ExtractNiPoint3(jsRequest.Get("angle"), "request.angle");
+      }
+      if (!jsRequest.Get("worldOrCellDesc").IsUndefined()) {
+        request.locationalData.cellOrWorldDesc =
+          FormDesc::FromString(NapiHelper::ExtractString(
+            jsRequest.Get("worldOrCellDesc"), "request.worldOrCellDesc"));
+      }
+      requests.push_back(std::move(request));
+
+      auto properties = jsRequest.Get("properties");
+      jsProperties.push_back(properties.IsUndefined()
+                               ? Napi::Object::New(info.Env())
+                               : NapiHelper::ExtractObject(
+                                   properties, "request.properties"));
+
+      // Setting these would subscribe the reference before the batch is
+      // complete
+      for (auto locationalProperty :
+           { "pos", "angle", "worldOrCellDesc", "locationalData" }) {
+        if (jsProperties.back().Has(locationalProperty)) {
+          throw std::runtime_error(fmt::format(
+            "'{}' can't be passed in request.properties, use request.pos, "
+            "request.angle and request.worldOrCellDesc instead",
+            locationalProperty));
+        }
+      }
     }
 
-    auto worldState = &partOne->worldState;
-    auto newRefrId = worldState->GenerateFormId();
-    worldState->AddForm(std::move(newRefr), newRefrId);
-
-    auto& refr = worldState->GetFormAt<MpObjectReference>(newRefrId);
-    refr.ForceSubscriptionsUpdate();
+    auto env = info.Env();
+    auto formIds = partOne->PlaceReferences(
+      requests, [&](MpObjectReference& refr, size_t requestIndex) {
+        auto& properties = jsProperties[requestIndex];
+        auto propertyNames = properties.GetPropertyNames();
+        for (uint32_t i = 0; i < propertyNames.Length(); ++i) {
+          auto propertyName =
+            static_cast<std::string>(propertyNames.Get(i).ToString());
+          SetProperty(env, refr.GetFormId(), propertyName,
+                      properties.Get(propertyName));
+        }
+      });
 
-    return Napi::Number::New(info.Env(), refr.GetFormId());
+    auto res = Napi::Array::New(env, formIds.size());
+    for (uint32_t i = 0; i < formIds.size(); ++i) {
+      res.Set(i, Napi::Number::New(env, formIds[i]));
+    }
+    return res;
   } catch (std::exception& e) {
     throw Napi::Error::New(info.Env(), std::string(e.what()));
   }
@@ -807,68 +1010,119 @@ Napi::Value ScampServer::LookupEspmRecordById(const Napi::CallbackInfo& info)
 {
   try {
     auto globalRecordId = NapiHelper::ExtractUInt32(info[0], "globalRecordId");
-
-    auto espmLookupResult = Napi::Object::New(info.Env());
-
     auto lookupRes =
       partOne->GetEspm().GetBrowser().LookupById(globalRecordId);
-    if (lookupRes.rec) {
-      auto& cache = partOne->worldState.GetEspmCache();
-
-      std::vector<Napi::Value> fields;
-      espm::IterateFields_(
-        lookupRes.rec,
-        [&](const char* type, uint32_t size, const char* data) {
-          auto uint8arr = Napi::Uint8Array::New(info.Env(), size);
-          memcpy(uint8arr.Data(), data, size);
-
-          auto field = Napi::Object::New(info.Env());
-          field.Set("type",
-                    Napi::String::New(info.Env(), std::string(type, 4)));
-          field.Set("data", uint8arr);
-          fields.push_back(field);
-        },
-        cache);
-      auto fieldsArray = Napi::Array::New(info.Env(), fields.size());
-      for (size_t i = 0; i < fields.size(); i++) {
-        fieldsArray.Set(i, fields[i]);
-      }
+    return MakeEspmLookupResult(info.Env(), lookupRes, false);
+  } catch (std::exception& e) {
+    throw Napi::Error::New(info.Env(), std::string(e.what()));
+  }
+}
 
-      auto id = Napi::Number::New(info.Env(), lookupRes.rec->GetId());
-      auto edid =
-        Napi::String::New(info.Env(), lookupRes.rec->GetEditorId(cache));
-      auto type =
-        Napi::String::New(info.Env(), lookupRes.rec->GetType().ToString());
-      auto flags = Napi::Number::New(info.Env(), lookupRes.rec->GetFlags());
-
-      auto record = Napi::Object::New(info.Env());
-      record.Set("id", id);
-      record.Set("editorId", edid);
-      record.Set("type", type);
-      record.Set("flags", flags);
-      record.Set("fields", fieldsArray);
-      espmLookupResult.Set("record", record);
-
-      espmLookupResult.Set("fileIndex",
-                           Napi::Number::New(info.Env(), lookupRes.fileIdx));
-
-      espmLookupResult.Set(
-        "toGlobalRecordId",
-        Napi::Function::New(
-          info.Env(), [lookupRes](const Napi::CallbackInfo& info) {
-            auto localRecordId =
-              NapiHelper::ExtractUInt32(info[0], "localRecordId");
-            uint32_t res = lookupRes.ToGlobalId(localRecordId);
-            return Napi::Number::New(info.Env(), res);
-          }));
+Napi::Value ScampServer::LookupEspmRecordsById(
+  const Napi::CallbackInfo& info)
+{
+  try {
+    auto globalRecordIds =
+      NapiHelper::ExtractArray(info[0], "globalRecordIds");
+    auto& br = partOne->GetEspm().GetBrowser();
+
+    auto res = Napi::Array::New(info.Env(), globalRecordIds.Length());
+    for (uint32_t i = 0; i < globalRecordIds.Length(); ++i) {
+      auto globalRecordId =
+        NapiHelper::ExtractUInt32(globalRecordIds.Get(i), "globalRecordId");
+      res.Set(i,
+              MakeEspmLookupResult(info.Env(), br.LookupById(globalRecordId),
+                                   true));
     }
-
-    return espmLookupResult;
+    return res;
   } catch (std::exception& e) {
     throw Napi::Error::New(info.Env(), std::string(e.what()));
   }
 }
 
+Napi::Object ScampServer::MakeEspmLookupResult(
+  Napi::Env env, const espm::LookupResult& lookupRes, bool packFields)
+{
+  auto espmLookupResult = Napi::Object::New(env);
+  if (!lookupRes.rec) {
+    return espmLookupResult;
+  }
+
+  auto& cache = partOne->worldState.GetEspmCache();
+
+  auto fieldsArray = Napi::Array::New(env);
+  uint32_t numFields = 0;
+  auto addField = [&](const char* type, Napi::Uint8Array data) {
+    auto field = Napi::Object::New(env);
+    field.Set("type", Napi::String::New(env, type, 4));
+    field.Set("data", data);
+    fieldsArray.Set(numFields++, field);
+  };
+
+  if (packFields) {
+    Napi::ArrayBuffer arrayBuffer;
+    auto fields = EspmFieldsUtils::CopyFields(
+      lookupRes.rec, cache, [&](size_t totalSize) {
+        arrayBuffer = Napi::ArrayBuffer::New(env, totalSize);
+        return static_cast<char*>(arrayBuffer.Data());
+      });
+    for (auto& field : fields) {
+      addField(field.type,
+               Napi::Uint8Array::New(env, field.size, arrayBuffer,
+                                     field.offset));
+    }
+  } else {
+    espm::IterateFields_(
+      lookupRes.rec,
+      [&](const char* type, uint32_t size, const char* data) {
+        auto uint8arr = Napi::Uint8Array::New(env, size);
+        memcpy(uint8arr.Data(), data, size);
+        addField(type, uint8arr);
+      },
+      cache);
+  }
+
+  auto id = Napi::Number::New(env, lookupRes.rec->GetId());
+  auto edid = Napi::String::New(env, lookupRes.rec->GetEditorId(cache));
+  auto type = Napi::String::New(env, lookupRes.rec->GetType().ToString());
+  auto flags = Napi::Number::New(env, lookupRes.rec->GetFlags());
+
+  auto record = Napi::Object::New(env);
+  record.Set("id", id);
+  record.Set("editorId", edid);
+  record.Set("type", type);
+  record.Set("flags", flags);
+  record.Set("fields", fieldsArray);
+  espmLookupResult.Set("record", record);
+
+  espmLookupResult.Set("fileIndex", Napi::Number::New(env, lookupRes.fileIdx));
+  espmLookupResult.Set("toGlobalRecordId",
+                       GetToGlobalRecordIdFunction(env, lookupRes.fileIdx));
+  return espmLookupResult;
+}
+
+Napi::Function ScampServer::GetToGlobalRecordIdFunction(Napi::Env env,
+                                                        uint8_t fileIdx)
+{
+  if (toGlobalRecordIdFunctions.size() <= fileIdx) {
+    toGlobalRecordIdFunctions.resize(fileIdx + 1);
+  }
+
+  auto& ref = toGlobalRecordIdFunctions[fileIdx];
+  if (ref.IsEmpty()) {
+    const espm::BrowserInfo browserInfo(&partOne->GetEspm().GetBrowser(),
+                                        fileIdx);
+    ref = Napi::Persistent(Napi::Function::New(
+      env, [browserInfo](const Napi::CallbackInfo& info) {
+        auto localRecordId =
+          NapiHelper::ExtractUInt32(info[0], "localRecordId");
+        uint32_t res = browserInfo.ToGlobalId(localRecordId);
+        return Napi::Number::New(info.Env(), res);
+      }));
+  }
+  return ref.Value();
+}
+
 Napi::Value ScampServer::GetEspmLoadOrder(const Napi::CallbackInfo& info)
 {
   try {
@@ -950,6 +1204,82 @@ Napi::Value ScampServer::CallPapyrusFunction(const Napi::CallbackInfo& info)
   }
 }
 
+Napi::Value ScampServer::PreparePapyrusCall(const Napi::CallbackInfo& info)
+{
+  try {
+    auto callType = NapiHelper::ExtractString(info[0], "callType");
+    auto className = NapiHelper::ExtractString(info[1], "className");
+    auto functionName = NapiHelper::ExtractString(info[2], "functionName");
+
+    FunctionType type;
+    if (callType == "method") {
+      type = FunctionType::Method;
+    } else if (callType == "global") {
+      type = FunctionType::GlobalFunction;
+    } else {
+      throw std::runtime_error("Unknown call type '" + callType +
+                               "', expected one of ['method', 'global']");
+    }
+
+    // Gamemode hot reload prepares the same calls again. Papyrus names are
+    // case-insensitive and className is ignored for methods
+    auto key = callType + ':' +
+      (type == FunctionType::Method ? std::string() : className) + ':' +
+      functionName;
+    std::transform(key.begin(), key.end(), key.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+
+    auto it = preparedPapyrusCallHandles.find(key);
+    if (it == preparedPapyrusCallHandles.end()) {
+      auto& vm = partOne->worldState.GetPapyrusVm();
+      preparedPapyrusCalls.push_back(
+        vm.PrepareCall(type, className, functionName));
+      it = preparedPapyrusCallHandles
+             .emplace(key, preparedPapyrusCalls.size() - 1)
+             .first;
+    }
+    return Napi::Number::New(info.Env(), it->second);
+  } catch (std::exception& e) {
+    throw Napi::Error::New(info.Env(), std::string(e.what()));
+  }
+}
+
+Napi::Value ScampServer::CallPreparedPapyrusFunction(
+  const Napi::CallbackInfo& info)
+{
+  try {
+    auto handle = NapiHelper::ExtractUInt32(info[0], "handle");
+    if (handle >= preparedPapyrusCalls.size()) {
+      throw std::runtime_error(
+        fmt::format("Invalid prepared Papyrus call handle {}", handle));
+    }
+
+    auto self = PapyrusUtils::GetPapyrusValueFromJsValue(info[1], false,
+                                                         partOne->worldState);
+
+    auto arr = NapiHelper::ExtractArray(info[2], "args");
+    auto arrSize = arr.Length();
+
+    bool treatNumberAsInt = false;
+
+    std::vector<VarValue> args;
+    args.resize(arrSize);
+    for (uint32_t i = 0; i < arrSize; ++i) {
+      args[i] = PapyrusUtils::GetPapyrusValueFromJsValue(
+        arr.Get(i), treatNumberAsInt, partOne->worldState);
+    }
+
+    auto& vm = partOne->worldState.GetPapyrusVm();
+    auto res = vm.CallPrepared(*preparedPapyrusCalls[handle],
+                               static_cast<IGameObject*>(self), args);
+
+    return PapyrusUtils::GetJsValueFromPapyrusValue(
+      info.Env(), res, partOne->worldState.espmFiles);
+  } catch (std::exception& e) {
+    throw Napi::Error::New(info.Env(), std::string(e.what()));
+  }
+}
+
 Napi::Value ScampServer::RegisterPapyrusFunction(
   const Napi::CallbackInfo& info)
 {
@@ -1029,6 +1359,17 @@ Napi::Value ScampServer::GetPacketHistory(const Napi::CallbackInfo& info)
   }
 }
 
+Napi::Value ScampServer::SpillPacketHistory(const Napi::CallbackInfo& info)
+{
+  try {
+    auto userId = NapiHelper::ExtractUInt32(info[0], "userId");
+    auto path = partOne->SpillPacketHistory(userId);
+    return Napi::String::New(info.Env(), path.string());
+  } catch (std::exception& e) {
+    throw Napi::Error::New(info.Env(), std::string(e.what()));
+  }
+}
+
 Napi::Value ScampServer::ClearPacketHistory(const Napi::CallbackInfo& info)
 {
   try {
@@ -1045,6 +1386,18 @@ Napi::Value ScampServer::RequestPacketHistoryPlayback(
 {
   try {
     auto userId = NapiHelper::ExtractUInt32(info[0], "userId");
+
+    // A path to a spill file is streamed from disk instead of being loaded
+    if (info[1].IsString()) {
+      std::filesystem::path spillPath =
+        NapiHelper::ExtractString(info[1], "packetHistory");
+      auto reader = std::make_shared<PacketHistoryReader>(
+        spillPath, std::filesystem::file_size(spillPath),
+        std::vector<std::shared_ptr<const PacketHistoryBlock>>());
+      partOne->RequestPacketHistoryPlayback(userId, reader);
+      return info.Env().Undefined();
+    }
+
     auto packetHistory = NapiHelper::ExtractObject(info[1], "packetHistory");
 
     PacketHistory history = PacketHistoryWrapper::FromNapiValue(packetHistory);
@@ -1055,3 +1408,49 @@ Napi::Value ScampServer::RequestPacketHistoryPlayback(
     throw Napi::Error::New(info.Env(), std::string(e.what()));
   }
 }
+
+Napi::Value ScampServer::CreateSnapshot(const Napi::CallbackInfo& info)
+{
+  try {
+    std::filesystem::path path = NapiHelper::ExtractString(info[0], "path");
+
+    auto deferred = Napi::Promise::Deferred::New(info.Env());
+    partOne->worldState.CreateSnapshot(path)
+      .Then([deferred](size_t numChangeForms) {
+        deferred.Resolve(Napi::Number::New(
+          deferred.Env(), static_cast<double>(numChangeForms)));
+      })
+      .Catch([deferred](const char* what) {
+        deferred.Reject(Napi::String::New(deferred.Env(), what));
+      });
+    return deferred.Promise();
+  } catch (std::exception& e) {
+    throw Napi::Error::New(info.Env(), std::string(e.what()));
+  }
+}
+
+Napi::Value ScampServer::GetIngressStats(const Napi::CallbackInfo& info)
+{
+  try {
+    if (!ingressQueue) {
+      return info.Env().Null();
+    }
+    auto res = Napi::Object::New(info.Env());
+    auto& stats = ingressQueue->GetStats();
+    res.Set("numQueuedPackets",
+            Napi::Number::New(info.Env(), stats.numQueuedPackets));
+    res.Set("numReceivedPackets",
+            Napi::Number::New(info.Env(), stats.numReceivedPackets));
+    res.Set("numProcessedPackets",
+            Napi::Number::New(info.Env(), stats.numProcessedPackets));
+    res.Set("numCoalescedMovements",
+            Napi::Number::New(info.Env(), stats.numCoalescedMovements));
+    res.Set("numDeferredTicks",
+            Napi::Number::New(info.Env(), stats.numDeferredTicks));
+    res.Set("numDroppedPackets",
+            Napi::Number::New(info.Env(), stats.numDroppedPackets));
+    return res;
+  } catch (std::exception& e) {
+    throw Napi::Error::New(info.Env(), std::string(e.what()));
+  }
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "GamemodeApi.h"
+#include "IngressQueue.h"
 #include "LocalizationProvider.h"
 #include "Networking.h"
 #include "NetworkingMock.h"
@@ -9,6 +10,7 @@
 #include <napi.h>
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
+#include <unordered_map>
 
 class ScampServer : public Napi::ObjectWrap<ScampServer>
 {
@@ -43,18 +45,25 @@ public:
   Napi::Value Get(const Napi::CallbackInfo& info);
   Napi::Value Set(const Napi::CallbackInfo& info);
   Napi::Value Place(const Napi::CallbackInfo& info);
+  Napi::Value PlaceMany(const Napi::CallbackInfo& info);
   Napi::Value LookupEspmRecordById(const Napi::CallbackInfo& info);
+  Napi::Value LookupEspmRecordsById(const Napi::CallbackInfo& info);
   Napi::Value GetEspmLoadOrder(const Napi::CallbackInfo& info);
   Napi::Value GetDescFromId(const Napi::CallbackInfo& info);
   Napi::Value GetIdFromDesc(const Napi::CallbackInfo& info);
   Napi::Value CallPapyrusFunction(const Napi::CallbackInfo& info);
+  Napi::Value PreparePapyrusCall(const Napi::CallbackInfo& info);
+  Napi::Value CallPreparedPapyrusFunction(const Napi::CallbackInfo& info);
   Napi::Value RegisterPapyrusFunction(const Napi::CallbackInfo& info);
   Napi::Value SendCustomPacket(const Napi::CallbackInfo& info);
 
   Napi::Value SetPacketHistoryRecording(const Napi::CallbackInfo& info);
   Napi::Value GetPacketHistory(const Napi::CallbackInfo& info);
+  Napi::Value SpillPacketHistory(const Napi::CallbackInfo& info);
   Napi::Value ClearPacketHistory(const Napi::CallbackInfo& info);
   Napi::Value RequestPacketHistoryPlayback(const Napi::CallbackInfo& info);
+  Napi::Value CreateSnapshot(const Napi::CallbackInfo& info);
+  Napi::Value GetIngressStats(const Napi::CallbackInfo& info);
 
   const std::shared_ptr<PartOne>& GetPartOne() const { return partOne; }
   const GamemodeApi::State& GetGamemodeApiState() const
@@ -76,5 +85,28 @@ private:
 
   std::shared_ptr<LocalizationProvider> localizationProvider;
 
+  // Null unless 'ingress' is configured, packets are handled right away then
+  std::unique_ptr<IngressQueue> ingressQueue;
+  std::chrono::steady_clock::time_point lastIngressBacklogWarning;
+  void ProcessIngressQueue();
+  void SetProperty(Napi::Env env, uint32_t formId,
+                   const std::string& propertyName, Napi::Value value);
+  void DispatchNeighborEvents();
+
+  // If packFields is true, fields are views over a single copy of record
+  // data instead of separate copies
+  Napi::Object MakeEspmLookupResult(Napi::Env env,
+                                    const espm::LookupResult& lookupRes,
+                                    bool packFields);
+  Napi::Function GetToGlobalRecordIdFunction(Napi::Env env, uint8_t fileIdx);
+
+  // Indexed by file index in the load order, filled on first use
+  std::vector<Napi::FunctionReference> toGlobalRecordIdFunctions;
+
+  // Indexed by handles returned from preparePapyrusCall
+  std::vector<std::shared_ptr<VirtualMachine::PreparedCall>>
+    preparedPapyrusCalls;
+  std::unordered_map<std::string, size_t> preparedPapyrusCallHandles;
+
   static Napi::FunctionReference constructor;
 };
@@ -31,8 +31,28 @@ public:
         : std::string("db");
 
       auto databaseUri = settings["databaseUri"].get<std::string>();
+
+      MongoDatabaseSettings mongoSettings;
+      if (settings.count("databaseBulkWriteSize")) {
+        mongoSettings.bulkWriteSize =
+          settings["databaseBulkWriteSize"].get<size_t>();
+      }
+      if (settings.count("databaseMaxBulkWritesInFlight")) {
+        mongoSettings.maxBulkWritesInFlight =
+          settings["databaseMaxBulkWritesInFlight"].get<size_t>();
+      }
+      if (settings.count("databaseIterateBatchSize")) {
+        mongoSettings.iterateBatchSize =
+          settings["databaseIterateBatchSize"].get<int32_t>();
+      }
+      if (settings.count("databaseMaxCachedChangeForms")) {
+        mongoSettings.maxCachedChangeForms =
+          settings["databaseMaxCachedChangeForms"].get<size_t>();
+      }
+
       logger->info("Using mongodb with name '" + databaseName + "'");
-      return std::make_shared<MongoDatabase>(databaseUri, databaseName);
+      return std::make_shared<MongoDatabase>(databaseUri, databaseName,
+                                             mongoSettings, logger);
     }
 
     if (databaseDriver == "migration") {
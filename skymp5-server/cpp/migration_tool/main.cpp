@@ -0,0 +1,55 @@
+#include "DatabaseMigrator.h"
+#include "SettingsUtils.h"
+#include <fstream>
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+// Offline counterpart of the 'migration' database driver. Copies everything
+// from 'databaseOld' to 'databaseNew' of the given settings file
+int main(int argc, char* argv[])
+{
+  auto logger = spdlog::stdout_color_mt("console");
+
+  std::string settingsPath = argc > 1 ? argv[1] : "server-settings.json";
+
+  try {
+    std::ifstream f(settingsPath);
+    if (!f.good()) {
+      throw std::runtime_error(settingsPath + " is missing");
+    }
+    auto settings = nlohmann::json::parse(f);
+
+    DatabaseMigratorSettings migratorSettings;
+    migratorSettings.checkpointPath = "migration-checkpoint.json";
+    if (settings.count("migrationBatchSize")) {
+      migratorSettings.batchSize =
+        settings["migrationBatchSize"].get<size_t>();
+    }
+    if (settings.count("migrationMaxBatchesInQueue")) {
+      migratorSettings.maxBatchesInQueue =
+        settings["migrationMaxBatchesInQueue"].get<size_t>();
+    }
+    if (settings.count("migrationCheckpointPath")) {
+      migratorSettings.checkpointPath =
+        settings["migrationCheckpointPath"].get<std::string>();
+    }
+
+    // Each form is written once, remembering written fields is a waste
+    auto newDatabaseSettings = settings.at("databaseNew");
+    if (!newDatabaseSettings.count("databaseMaxCachedChangeForms")) {
+      newDatabaseSettings["databaseMaxCachedChangeForms"] = 0;
+    }
+
+    auto oldDatabase =
+      SettingsUtils::CreateDatabase(settings.at("databaseOld"), logger);
+    auto newDatabase =
+      SettingsUtils::CreateDatabase(newDatabaseSettings, logger);
+
+    DatabaseMigrator(oldDatabase, newDatabase, migratorSettings, logger)
+      .Run();
+  } catch (std::exception& e) {
+    logger->critical("Migration failed: {}", e.what());
+    return 1;
+  }
+
+  return 0;
+}
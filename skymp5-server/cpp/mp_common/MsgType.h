@@ -22,5 +22,7 @@ enum class MsgType : int64_t
   ChangeValues = 16,
   OnHit = 17,
   DeathStateContainer = 18,
-  DropItem = 19
+  DropItem = 19,
+  RequestGamemodeData = 20,
+  UpdatePropertyBatch = 21
 };
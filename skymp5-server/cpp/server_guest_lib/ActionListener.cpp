@@ -12,6 +12,7 @@
 #include "MpObjectReference.h"
 #include "MsgType.h"
 #include "UserMessageOutput.h"
+#include "WeaponDamageCache.h"
 #include "WorldState.h"
 #include "papyrus-vm/Utils.h"
 #include <fmt/format.h>
@@ -233,11 +234,13 @@ void ActionListener::OnUpdateEquipment(
 
 void RecalculateWorn(MpObjectReference& refr)
 {
-  if (!refr.GetParent()->HasEspm()) {
+  auto worldState = refr.GetParent();
+  if (!worldState->HasEspm()) {
     return;
   }
-  auto& loader = refr.GetParent()->GetEspm();
-  auto& cache = refr.GetParent()->GetEspmCache();
+  auto& browser = worldState->GetEspm().GetBrowser();
+  auto& espmCache = worldState->GetEspmCache();
+  auto& weaponDamageCache = worldState->GetWeaponDamageCache();
 
   auto ac = dynamic_cast<MpActor*>(&refr);
   if (!ac) {
@@ -249,50 +252,57 @@ void RecalculateWorn(MpObjectReference& refr)
   Equipment newEq;
   newEq.numChanges = eq.numChanges + 1;
   for (auto& entry : eq.inv.entries) {
+    auto& weaponInfo = weaponDamageCache.Get(entry.baseId, browser, espmCache);
+    if (!weaponInfo.exists) {
+      throw std::runtime_error(
+        fmt::format("Record {0:x} doesn't exist", entry.baseId));
+    }
     bool isEquipped = entry.extra.worn != Inventory::Worn::None;
-    bool isWeap =
-      espm::GetRecordType(entry.baseId, refr.GetParent()) == espm::WEAP::kType;
-    if (isEquipped && isWeap) {
+    if (isEquipped && weaponInfo.isWeapon) {
       continue;
     }
     newEq.inv.AddItems({ entry });
   }
 
-  const Inventory inv = ac->GetInventory();
-  Inventory::Entry bestEntry;
+  const Inventory::Entry* bestEntry = nullptr;
   int16_t bestDamage = -1;
-  for (auto& entry : inv.entries) {
-    if (entry.baseId) {
-      auto lookupRes = loader.GetBrowser().LookupById(entry.baseId);
-      if (auto weap = espm::Convert<espm::WEAP>(lookupRes.rec)) {
-        if (!bestEntry.count ||
-            weap->GetData(cache).weapData->damage > bestDamage) {
-          bestEntry = entry;
-          bestDamage = weap->GetData(cache).weapData->damage;
-        }
-      }
+  for (auto& entry : ac->GetInventory().entries) {
+    if (!entry.baseId) {
+      continue;
+    }
+    auto& weaponInfo = weaponDamageCache.Get(entry.baseId, browser, espmCache);
+    if (!weaponInfo.isWeapon) {
+      continue;
+    }
+    if (!bestEntry || weaponInfo.damage > bestDamage) {
+      bestEntry = &entry;
+      bestDamage = weaponInfo.damage;
     }
   }
 
-  if (bestEntry.count > 0) {
-    bestEntry.extra.worn = Inventory::Worn::Right;
-    newEq.inv.AddItems({ bestEntry });
+  if (bestEntry && bestEntry->count > 0) {
+    Inventory::Entry wornEntry = *bestEntry;
+    wornEntry.extra.worn = Inventory::Worn::Right;
+    newEq.inv.AddItems({ wornEntry });
   }
 
-  ac->SetEquipment(newEq.ToJson().dump());
+  ac->SetEquipment(newEq);
+
+  // Keys are in the same order nlohmann::json would dump them
+  std::string s;
+  s += Networking::MinPacketId;
+  s += R"({"data":)";
+  s += ac->GetEquipmentAsJson();
+  s += R"(,"idx":)";
+  s += std::to_string(ac->GetIdx());
+  s += R"(,"t":)";
+  s += std::to_string(static_cast<int>(MsgType::UpdateEquipment));
+  s += '}';
+
   for (auto listener : ac->GetListeners()) {
-    auto actor = dynamic_cast<MpActor*>(listener);
-    if (!actor) {
-      continue;
+    if (auto actor = dynamic_cast<MpActor*>(listener)) {
+      actor->SendToUser(s.data(), s.size(), true);
     }
-    std::string s;
-    s += Networking::MinPacketId;
-    s += nlohmann::json{
-      { "t", MsgType::UpdateEquipment },
-      { "idx", ac->GetIdx() },
-      { "data", newEq.ToJson() }
-    }.dump();
-    actor->SendToUser(s.data(), s.size(), true);
   }
 }
 
@@ -858,6 +868,18 @@ void ActionListener::OnHit(const RawMessageData& rawMsgData_,
                 healthPercentage);
 }
 
+void ActionListener::OnRequestGamemodeData(
+  const RawMessageData& rawMsgData, const std::vector<std::string>& hashes,
+  bool manifest)
+{
+  if (manifest) {
+    partOne.SendGamemodeDataManifest(rawMsgData.userId);
+  }
+  if (!hashes.empty()) {
+    partOne.SendGamemodeDataBodies(rawMsgData.userId, hashes);
+  }
+}
+
 void ActionListener::OnUnknown(const RawMessageData& rawMsgData,
                                simdjson::dom::element data)
 {
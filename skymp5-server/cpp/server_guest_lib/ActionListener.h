@@ -85,6 +85,11 @@ public:
 
   virtual void OnHit(const RawMessageData& rawMsgData, const HitData& hitData);
 
+  // manifest is set by clients that missed a delta
+  virtual void OnRequestGamemodeData(const RawMessageData& rawMsgData,
+                                     const std::vector<std::string>& hashes,
+                                     bool manifest);
+
   virtual void OnUnknown(const RawMessageData& rawMsgData,
                          simdjson::dom::element data);
 
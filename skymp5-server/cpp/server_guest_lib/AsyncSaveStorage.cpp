@@ -7,6 +7,11 @@ struct AsyncSaveStorage::Impl
   {
     std::vector<MpChangeForm> changeForms;
     std::function<void()> callback;
+
+    // Non-empty for tasks created by IterateAsync. Tasks are executed in
+    // order, so iteration sees exactly the upserts requested before it
+    IterateSyncCallback iterateCallback;
+    IterateAsyncCallback iterateFinishCallback;
   };
 
   std::shared_ptr<spdlog::logger> logger;
@@ -32,6 +37,7 @@ struct AsyncSaveStorage::Impl
   struct
   {
     std::vector<std::function<void()>> upsertCallbacksToFire;
+    std::vector<std::function<void()>> iterateCallbacksToFire;
     std::mutex m;
   } share4;
 
@@ -59,6 +65,10 @@ AsyncSaveStorage::~AsyncSaveStorage()
 
 void AsyncSaveStorage::SaverThreadMain(Impl* pImpl)
 {
+  // Failure of an upsert requested before the next iteration. A snapshot
+  // would silently miss these change forms, so the iteration fails instead
+  std::exception_ptr upsertError;
+
   while (!pImpl->destroyed) {
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
     try {
@@ -71,13 +81,42 @@ void AsyncSaveStorage::SaverThreadMain(Impl* pImpl)
       }
 
       std::vector<std::function<void()>> callbacksToFire;
+      std::vector<std::function<void()>> iterateCallbacksToFire;
 
       {
-        std::lock_guard l(pImpl->share.m);
+        std::unique_lock l(pImpl->share.m);
         auto was = clock();
         size_t numChangeForms = 0;
         for (auto& t : tasks) {
-          numChangeForms += pImpl->share.dbImpl->Upsert(t.changeForms);
+          if (t.iterateCallback) {
+            // Writing a snapshot takes long. Upserts are only done by this
+            // thread, so the database doesn't change while unlocked
+            auto dbImpl = pImpl->share.dbImpl;
+            l.unlock();
+            std::exception_ptr exceptionPtr = std::move(upsertError);
+            upsertError = nullptr;
+            try {
+              if (!exceptionPtr) {
+                dbImpl->Iterate(t.iterateCallback);
+              }
+            } catch (...) {
+              exceptionPtr = std::current_exception();
+            }
+            l.lock();
+            auto onFinish = std::move(t.iterateFinishCallback);
+            iterateCallbacksToFire.push_back(
+              [onFinish, exceptionPtr] { onFinish(exceptionPtr); });
+            continue;
+          }
+          try {
+            numChangeForms += pImpl->share.dbImpl->Upsert(t.changeForms);
+          } catch (...) {
+            // Rethrown by Tick. The rest of the batch is still processed
+            upsertError = std::current_exception();
+            std::lock_guard l2(pImpl->share2.m);
+            pImpl->share2.exceptions.push_back(upsertError);
+            continue;
+          }
           callbacksToFire.push_back(t.callback);
         }
         if (numChangeForms > 0 && pImpl->logger)
@@ -89,6 +128,8 @@ void AsyncSaveStorage::SaverThreadMain(Impl* pImpl)
         std::lock_guard l(pImpl->share4.m);
         for (auto& cb : callbacksToFire)
           pImpl->share4.upsertCallbacksToFire.push_back(cb);
+        for (auto& cb : iterateCallbacksToFire)
+          pImpl->share4.iterateCallbacksToFire.push_back(cb);
       }
     } catch (...) {
       std::lock_guard l(pImpl->share2.m);
@@ -111,6 +152,13 @@ void AsyncSaveStorage::Upsert(const std::vector<MpChangeForm>& changeForms,
   pImpl->share3.upsertTasks.push_back({ changeForms, cb });
 }
 
+void AsyncSaveStorage::IterateAsync(const IterateSyncCallback& cb,
+                                    const IterateAsyncCallback& onFinish)
+{
+  std::lock_guard l(pImpl->share3.m);
+  pImpl->share3.upsertTasks.push_back({ {}, nullptr, cb, onFinish });
+}
+
 uint32_t AsyncSaveStorage::GetNumFinishedUpserts() const
 {
   return pImpl->numFinishedUpserts;
@@ -128,13 +176,19 @@ void AsyncSaveStorage::Tick()
   }
 
   decltype(pImpl->share4.upsertCallbacksToFire) upsertCallbacksToFire;
+  decltype(pImpl->share4.iterateCallbacksToFire) iterateCallbacksToFire;
   {
     std::lock_guard l(pImpl->share4.m);
     upsertCallbacksToFire = std::move(pImpl->share4.upsertCallbacksToFire);
     pImpl->share4.upsertCallbacksToFire.clear();
+    iterateCallbacksToFire = std::move(pImpl->share4.iterateCallbacksToFire);
+    pImpl->share4.iterateCallbacksToFire.clear();
   }
   for (auto& cb : upsertCallbacksToFire) {
     pImpl->numFinishedUpserts++;
     cb();
   }
+  for (auto& cb : iterateCallbacksToFire) {
+    cb();
+  }
 }
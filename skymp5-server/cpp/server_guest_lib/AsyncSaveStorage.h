@@ -15,6 +15,8 @@ public:
   void IterateSync(const IterateSyncCallback& cb) override;
   void Upsert(const std::vector<MpChangeForm>& changeForms,
               const UpsertCallback& cb) override;
+  void IterateAsync(const IterateSyncCallback& cb,
+                    const IterateAsyncCallback& onFinish) override;
   uint32_t GetNumFinishedUpserts() const override;
   void Tick() override;
 
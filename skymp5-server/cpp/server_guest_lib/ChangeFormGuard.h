@@ -28,10 +28,27 @@ public:
                       Mode mode = Mode::RequestSave)
   {
     f(changeForm);
-    if (!blockSaving && mode == Mode::RequestSave) {
-      lastSaveRequest = std::chrono::system_clock::now();
-      ChangeFormGuard_::RequestSave(self);
+    if (mode == Mode::RequestSave) {
+      if (batchDepth > 0) {
+        batchNeedsSave = true;
+      } else {
+        RequestSave();
+      }
+    }
+  }
+
+  // Edits made by f request at most one save, after f returns
+  template <class F>
+  void BatchChangeFormEdits(F&& f)
+  {
+    ++batchDepth;
+    try {
+      f();
+    } catch (...) {
+      EndBatch();
+      throw;
     }
+    EndBatch();
   }
 
   const MpChangeForm& ChangeForm() const noexcept { return changeForm; }
@@ -41,7 +58,25 @@ public:
   bool blockSaving = false;
 
 private:
+  void RequestSave()
+  {
+    if (!blockSaving) {
+      lastSaveRequest = std::chrono::system_clock::now();
+      ChangeFormGuard_::RequestSave(self);
+    }
+  }
+
+  void EndBatch()
+  {
+    if (--batchDepth == 0 && batchNeedsSave) {
+      batchNeedsSave = false;
+      RequestSave();
+    }
+  }
+
   MpChangeForm changeForm;
   MpObjectReference* const self;
   std::optional<std::chrono::system_clock::time_point> lastSaveRequest;
+  int batchDepth = 0;
+  bool batchNeedsSave = false;
 };
@@ -69,11 +69,12 @@ void ExecuteAddItem(MpActor& caller,
     ? caller
     : caller.GetParent()->GetFormAt<MpObjectReference>(targetId);
 
-  auto& br = caller.GetParent()->GetEspm().GetBrowser();
+  auto worldState = caller.GetParent();
+  auto& br = worldState->GetEspm().GetBrowser();
 
   PapyrusObjectReference papyrusObjectReference;
   auto aItem =
-    VarValue(std::make_shared<EspmGameObject>(br.LookupById(itemId)));
+    VarValue(worldState->GetEspmGameObject(br.LookupById(itemId)));
   auto aCount = VarValue(count);
   auto aSilent = VarValue(false);
   (void)papyrusObjectReference.AddItem(target.ToVarValue(),
@@ -92,11 +93,12 @@ void ExecutePlaceAtMe(MpActor& caller,
     ? caller
     : caller.GetParent()->GetFormAt<MpObjectReference>(targetId);
 
-  auto& br = caller.GetParent()->GetEspm().GetBrowser();
+  auto worldState = caller.GetParent();
+  auto& br = worldState->GetEspm().GetBrowser();
 
   PapyrusObjectReference papyrusObjectReference;
   auto aBaseForm =
-    VarValue(std::make_shared<EspmGameObject>(br.LookupById(baseFormId)));
+    VarValue(worldState->GetEspmGameObject(br.LookupById(baseFormId)));
   auto aCount = VarValue(1);
   auto aForcePersist = VarValue(false);
   auto aInitiallyDisabled = VarValue(false);
@@ -0,0 +1,254 @@
+#include "DatabaseMigrator.h"
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <thread>
+
+namespace {
+struct Checkpoint
+{
+  size_t numMigrated = 0;
+  std::string lastFormDesc;
+};
+
+std::optional<Checkpoint> LoadCheckpoint(const std::filesystem::path& path)
+{
+  if (path.empty() || !std::filesystem::exists(path)) {
+    return std::nullopt;
+  }
+
+  std::ifstream f(path);
+  auto j = nlohmann::json::parse(f);
+  return Checkpoint{ j.at("numMigrated").get<size_t>(),
+                     j.at("lastFormDesc").get<std::string>() };
+}
+
+void SaveCheckpoint(const std::filesystem::path& path,
+                    const Checkpoint& checkpoint)
+{
+  auto tmpPath = path;
+  tmpPath += ".tmp";
+  {
+    std::ofstream f(tmpPath, std::ios::trunc);
+    f << nlohmann::json{ { "numMigrated", checkpoint.numMigrated },
+                         { "lastFormDesc", checkpoint.lastFormDesc } }
+           .dump();
+    if (!f) {
+      throw std::runtime_error("Unable to write " + tmpPath.string());
+    }
+  }
+  std::filesystem::rename(tmpPath, path);
+}
+
+// Thrown from the iterate callback to stop reading when writing failed
+struct WriterFailed
+{
+};
+}
+
+struct DatabaseMigrator::Impl
+{
+  std::shared_ptr<IDatabase> oldDatabase;
+  std::shared_ptr<IDatabase> newDatabase;
+  DatabaseMigratorSettings settings;
+  std::shared_ptr<spdlog::logger> logger;
+
+  struct
+  {
+    std::deque<std::vector<MpChangeForm>> batches;
+    bool readingFinished = false;
+    std::exception_ptr writerException;
+    std::mutex m;
+    std::condition_variable cv;
+  } queue;
+
+  void WriterThreadMain(Checkpoint checkpoint, DatabaseMigratorStats& stats,
+                        std::chrono::steady_clock::time_point startTime);
+};
+
+DatabaseMigrator::DatabaseMigrator(std::shared_ptr<IDatabase> oldDatabase,
+                                   std::shared_ptr<IDatabase> newDatabase,
+                                   const DatabaseMigratorSettings& settings,
+                                   std::shared_ptr<spdlog::logger> logger)
+{
+  if (settings.batchSize == 0 || settings.maxBatchesInQueue == 0) {
+    throw std::runtime_error(
+      "batchSize and maxBatchesInQueue must be greater than 0");
+  }
+  pImpl.reset(new Impl{ oldDatabase, newDatabase, settings, logger });
+}
+
+DatabaseMigratorStats DatabaseMigrator::Run()
+{
+  const auto startTime = std::chrono::steady_clock::now();
+  const auto& settings = pImpl->settings;
+
+  auto checkpoint =
+    LoadCheckpoint(settings.checkpointPath).value_or(Checkpoint());
+  if (checkpoint.numMigrated > 0 && pImpl->logger) {
+    pImpl->logger->info("Resuming migration after {} ChangeForms",
+                        checkpoint.numMigrated);
+  }
+
+  {
+    std::lock_guard l(pImpl->queue.m);
+    pImpl->queue.batches.clear();
+    pImpl->queue.readingFinished = false;
+    pImpl->queue.writerException = nullptr;
+  }
+
+  DatabaseMigratorStats stats;
+  std::thread writer(
+    [&] { pImpl->WriterThreadMain(checkpoint, stats, startTime); });
+
+  auto pushBatch = [&](std::vector<MpChangeForm>&& batch) {
+    std::unique_lock l(pImpl->queue.m);
+    pImpl->queue.cv.wait(l, [&] {
+      return pImpl->queue.writerException ||
+        pImpl->queue.batches.size() < settings.maxBatchesInQueue;
+    });
+    if (pImpl->queue.writerException) {
+      throw WriterFailed();
+    }
+    pImpl->queue.batches.push_back(std::move(batch));
+    pImpl->queue.cv.notify_all();
+  };
+
+  std::exception_ptr readerException;
+  size_t numRead = 0;
+  try {
+    std::vector<MpChangeForm> batch;
+    batch.reserve(settings.batchSize);
+
+    pImpl->oldDatabase->Iterate([&](const MpChangeForm& changeForm) {
+      ++numRead;
+      if (numRead <= checkpoint.numMigrated) {
+        if (numRead == checkpoint.numMigrated &&
+            changeForm.formDesc.ToString() != checkpoint.lastFormDesc) {
+          throw std::runtime_error(fmt::format(
+            "Old database order changed since the checkpoint was saved "
+            "(expected {}, got {}). Remove {} to start over",
+            checkpoint.lastFormDesc, changeForm.formDesc.ToString(),
+            settings.checkpointPath.string()));
+        }
+        return;
+      }
+
+      batch.push_back(changeForm);
+      if (batch.size() >= settings.batchSize) {
+        pushBatch(std::move(batch));
+        batch.clear();
+        batch.reserve(settings.batchSize);
+      }
+    });
+
+    if (!batch.empty()) {
+      pushBatch(std::move(batch));
+    }
+
+    if (numRead < checkpoint.numMigrated) {
+      throw std::runtime_error(
+        fmt::format("Old database contains {} ChangeForms, but checkpoint "
+                    "says {} were migrated. Remove {} to start over",
+                    numRead, checkpoint.numMigrated,
+                    settings.checkpointPath.string()));
+    }
+  } catch (WriterFailed&) {
+    // Rethrown below as the writer's exception
+  } catch (...) {
+    readerException = std::current_exception();
+  }
+
+  {
+    std::lock_guard l(pImpl->queue.m);
+    pImpl->queue.readingFinished = true;
+    if (readerException) {
+      pImpl->queue.batches.clear();
+    }
+    pImpl->queue.cv.notify_all();
+  }
+  writer.join();
+
+  if (readerException) {
+    std::rethrow_exception(readerException);
+  }
+  if (pImpl->queue.writerException) {
+    std::rethrow_exception(pImpl->queue.writerException);
+  }
+
+  stats.numRead = numRead;
+  stats.numSkipped = std::min(numRead, checkpoint.numMigrated);
+  stats.elapsed = std::chrono::steady_clock::now() - startTime;
+
+  if (!settings.checkpointPath.empty()) {
+    std::filesystem::remove(settings.checkpointPath);
+  }
+
+  if (pImpl->logger) {
+    auto seconds = std::chrono::duration<double>(stats.elapsed).count();
+    pImpl->logger->info(
+      "Migration finished: {} ChangeForms read, {} skipped, {} written in "
+      "{:.1f}s ({:.0f}/s)",
+      stats.numRead, stats.numSkipped, stats.numWritten, seconds,
+      seconds > 0 ? stats.numWritten / seconds : 0.0);
+  }
+
+  return stats;
+}
+
+void DatabaseMigrator::Impl::WriterThreadMain(
+  Checkpoint checkpoint, DatabaseMigratorStats& stats,
+  std::chrono::steady_clock::time_point startTime)
+{
+  auto lastReportTime = startTime;
+  size_t numWrittenAtLastReport = 0;
+
+  try {
+    while (true) {
+      std::vector<MpChangeForm> batch;
+      {
+        std::unique_lock l(queue.m);
+        queue.cv.wait(
+          l, [&] { return queue.readingFinished || !queue.batches.empty(); });
+        if (queue.batches.empty()) {
+          return;
+        }
+        batch = std::move(queue.batches.front());
+        queue.batches.pop_front();
+        queue.cv.notify_all();
+      }
+
+      size_t numUpserted = newDatabase->Upsert(batch);
+      if (numUpserted != batch.size()) {
+        throw std::runtime_error(
+          fmt::format("Upsert saved only {} of {} ChangeForms", numUpserted,
+                      batch.size()));
+      }
+      stats.numWritten += batch.size();
+
+      checkpoint.numMigrated += batch.size();
+      checkpoint.lastFormDesc = batch.back().formDesc.ToString();
+      if (!settings.checkpointPath.empty()) {
+        SaveCheckpoint(settings.checkpointPath, checkpoint);
+      }
+
+      auto now = std::chrono::steady_clock::now();
+      if (logger && now - lastReportTime >= settings.reportInterval) {
+        auto seconds = std::chrono::duration<double>(now - lastReportTime);
+        logger->info("Migrated {} ChangeForms ({:.0f}/s)",
+                     checkpoint.numMigrated,
+                     (stats.numWritten - numWrittenAtLastReport) /
+                       seconds.count());
+        lastReportTime = now;
+        numWrittenAtLastReport = stats.numWritten;
+      }
+    }
+  } catch (...) {
+    std::lock_guard l(queue.m);
+    queue.writerException = std::current_exception();
+    queue.cv.notify_all();
+  }
+}
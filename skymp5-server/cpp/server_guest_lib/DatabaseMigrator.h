@@ -0,0 +1,52 @@
+#pragma once
+#include "IDatabase.h"
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <spdlog/spdlog.h>
+
+struct DatabaseMigratorSettings
+{
+  // Number of change forms passed to a single Upsert of the new database
+  size_t batchSize = 1000;
+
+  // Batches read ahead while the previous ones are being written
+  size_t maxBatchesInQueue = 8;
+
+  // File to store progress in. Empty means the migration can't be resumed
+  std::filesystem::path checkpointPath;
+
+  std::chrono::milliseconds reportInterval{ 5000 };
+};
+
+struct DatabaseMigratorStats
+{
+  size_t numRead = 0;
+  size_t numSkipped = 0; // Already migrated according to the checkpoint
+  size_t numWritten = 0;
+  std::chrono::steady_clock::duration elapsed{};
+};
+
+// Copies every change form from one database to another. Reading (with
+// decoding done by the old database) and writing (with encoding done by the
+// new database) run on separate threads.
+//
+// A checkpoint is saved after each written batch. Resuming relies on the old
+// database iterating in the same order as before, this is verified by the
+// last migrated FormDesc stored in the checkpoint
+class DatabaseMigrator
+{
+public:
+  DatabaseMigrator(std::shared_ptr<IDatabase> oldDatabase,
+                   std::shared_ptr<IDatabase> newDatabase,
+                   const DatabaseMigratorSettings& settings = {},
+                   std::shared_ptr<spdlog::logger> logger = nullptr);
+
+  // Throws if reading or writing fails. The checkpoint is kept in this case
+  // and removed after a successful migration
+  DatabaseMigratorStats Run();
+
+private:
+  struct Impl;
+  std::shared_ptr<Impl> pImpl;
+};
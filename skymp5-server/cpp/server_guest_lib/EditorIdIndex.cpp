@@ -0,0 +1,37 @@
+#include "EditorIdIndex.h"
+#include <unordered_set>
+
+EditorIdIndex::EditorIdIndex(
+  const espm::CombineBrowser& browser,
+  espm::CompressedFieldsCache& compressedFieldsCache, const char* recordType)
+{
+  auto recordsByFile = browser.GetRecordsByType(recordType);
+
+  // Latest plugins first, so the first record seen for a form is the winning
+  // override and the first form seen for an EditorID is the latest one
+  std::unordered_set<uint32_t> indexedFormIds;
+  for (size_t i = recordsByFile.size(); i-- > 0;) {
+    espm::BrowserInfo info(&browser, static_cast<uint8_t>(i));
+    for (auto record : *recordsByFile[i]) {
+      uint32_t formId = info.ToGlobalId(record->GetId());
+      if (!indexedFormIds.insert(formId).second) {
+        continue;
+      }
+      const char* editorId = record->GetEditorId(compressedFieldsCache);
+      if (editorId[0] != '\0') {
+        formIdByEditorId.emplace(editorId, formId);
+      }
+    }
+  }
+}
+
+uint32_t EditorIdIndex::Find(const char* editorId) const
+{
+  auto it = formIdByEditorId.find(editorId);
+  return it == formIdByEditorId.end() ? 0 : it->second;
+}
+
+size_t EditorIdIndex::GetSize() const noexcept
+{
+  return formIdByEditorId.size();
+}
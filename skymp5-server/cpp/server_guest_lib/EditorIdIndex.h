@@ -0,0 +1,23 @@
+#pragma once
+#include "libespm/Combiner.h"
+#include "papyrus-vm/CIString.h"
+#include <cstdint>
+
+// Case-insensitive EditorID to FormID map for records of one type. Records
+// overridden by later plugins are indexed by their final EditorID. If several
+// forms share an EditorID, the one from the latest plugin wins
+class EditorIdIndex
+{
+public:
+  EditorIdIndex(const espm::CombineBrowser& browser,
+                espm::CompressedFieldsCache& compressedFieldsCache,
+                const char* recordType);
+
+  // Returns 0 if there is no such record
+  uint32_t Find(const char* editorId) const;
+
+  size_t GetSize() const noexcept;
+
+private:
+  CIMap<uint32_t> formIdByEditorId;
+};
@@ -0,0 +1,29 @@
+#include "EspmFieldsUtils.h"
+#include <cstring>
+
+std::vector<EspmFieldsUtils::Field> EspmFieldsUtils::CopyFields(
+  const espm::RecordHeader* rec, espm::CompressedFieldsCache& cache,
+  const Allocate& allocate)
+{
+  std::vector<Field> res;
+  std::vector<const char*> sources;
+  size_t totalSize = 0;
+
+  // Fields of compressed records stay in the cache until it's destroyed
+  espm::IterateFields_(
+    rec,
+    [&](const char* type, uint32_t size, const char* data) {
+      res.push_back({ type, static_cast<uint32_t>(totalSize), size });
+      sources.push_back(data);
+      totalSize += size;
+    },
+    cache);
+
+  char* buffer = allocate(totalSize);
+  for (size_t i = 0; i < res.size(); ++i) {
+    if (res[i].size > 0) {
+      memcpy(buffer + res[i].offset, sources[i], res[i].size);
+    }
+  }
+  return res;
+}
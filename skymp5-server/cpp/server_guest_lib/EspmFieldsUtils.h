@@ -0,0 +1,22 @@
+#pragma once
+#include "libespm/espm.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace EspmFieldsUtils {
+struct Field
+{
+  const char* type = nullptr; // 4 characters, not null-terminated
+  uint32_t offset = 0;        // In the buffer returned by allocate
+  uint32_t size = 0;
+};
+
+using Allocate = std::function<char*(size_t totalSize)>;
+
+// Copies data of all fields of the record back to back into a single buffer
+// of the given allocator, so the caller needs one allocation per record
+std::vector<Field> CopyFields(const espm::RecordHeader* rec,
+                              espm::CompressedFieldsCache& cache,
+                              const Allocate& allocate);
+}
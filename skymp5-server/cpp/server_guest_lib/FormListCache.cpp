@@ -0,0 +1,64 @@
+#include "FormListCache.h"
+
+DecodedFormList::DecodedFormList(
+  const espm::LookupResult& formList,
+  espm::CompressedFieldsCache& compressedFieldsCache)
+{
+  auto flst = espm::Convert<espm::FLST>(formList.rec);
+  if (!flst) {
+    return;
+  }
+
+  formIds = flst->GetData(compressedFieldsCache).formIds;
+  firstIndexByFormId.reserve(formIds.size());
+  for (size_t i = 0; i < formIds.size(); ++i) {
+    formIds[i] = formList.ToGlobalId(formIds[i]);
+    firstIndexByFormId.emplace(formIds[i], static_cast<int>(i));
+  }
+}
+
+const std::vector<uint32_t>& DecodedFormList::GetFormIds() const noexcept
+{
+  return formIds;
+}
+
+int DecodedFormList::Find(uint32_t formId) const noexcept
+{
+  auto it = firstIndexByFormId.find(formId);
+  return it == firstIndexByFormId.end() ? -1 : it->second;
+}
+
+bool DecodedFormList::Contains(uint32_t formId) const noexcept
+{
+  return firstIndexByFormId.count(formId) > 0;
+}
+
+std::shared_ptr<const DecodedFormList> FormListCache::Get(
+  const espm::LookupResult& formList)
+{
+  if (!espm::Convert<espm::FLST>(formList.rec)) {
+    return nullptr;
+  }
+
+  auto& decoded = decodedByRecord[formList.rec];
+  if (!decoded) {
+    decoded = Decode(formList);
+  }
+  return decoded;
+}
+
+void FormListCache::Clear()
+{
+  decodedByRecord.clear();
+}
+
+std::shared_ptr<const DecodedFormList> FormListCache::Decode(
+  const espm::LookupResult& formList)
+{
+  if (!espm::Convert<espm::FLST>(formList.rec)) {
+    return nullptr;
+  }
+
+  espm::CompressedFieldsCache dummyCache;
+  return std::make_shared<DecodedFormList>(formList, dummyCache);
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "libespm/Combiner.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// FLST record contents with form ids mapped to the load order
+class DecodedFormList
+{
+public:
+  DecodedFormList(const espm::LookupResult& formList,
+                  espm::CompressedFieldsCache& compressedFieldsCache);
+
+  const std::vector<uint32_t>& GetFormIds() const noexcept;
+
+  // Returns index of the first occurrence or -1
+  int Find(uint32_t formId) const noexcept;
+
+  bool Contains(uint32_t formId) const noexcept;
+
+private:
+  std::vector<uint32_t> formIds;
+  std::unordered_map<uint32_t, int> firstIndexByFormId;
+};
+
+// Decodes each FLST record once. Records are identified by address, so the
+// cache must be cleared when plugins are reloaded
+class FormListCache
+{
+public:
+  // Returns nullptr if formList is not a FLST record
+  std::shared_ptr<const DecodedFormList> Get(
+    const espm::LookupResult& formList);
+
+  void Clear();
+
+  // Same as Get, but doesn't cache the result
+  static std::shared_ptr<const DecodedFormList> Decode(
+    const espm::LookupResult& formList);
+
+private:
+  std::unordered_map<const espm::RecordHeader*,
+                     std::shared_ptr<const DecodedFormList>>
+    decodedByRecord;
+};
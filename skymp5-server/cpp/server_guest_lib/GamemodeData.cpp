@@ -0,0 +1,131 @@
+#include "GamemodeData.h"
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+bool GamemodeData::Update(const GamemodeApi::State& state)
+{
+  std::array<Entries, NumSections> newEntries;
+  std::unordered_map<std::string, std::string> newBodyByHash;
+
+  auto add = [&](Section section, const std::string& name,
+                 const std::string& body) {
+    auto hash = Hash(body);
+    newEntries[section][name] = hash;
+    newBodyByHash.emplace(std::move(hash), body);
+  };
+
+  for (auto& [eventName, eventSourceInfo] : state.createdEventSources) {
+    add(EventSources, eventName, eventSourceInfo.functionBody);
+  }
+  for (auto& [propertyName, propertyInfo] : state.createdProperties) {
+    //  From docs: isVisibleByNeighbors considered to be always false for
+    //  properties with `isVisibleByOwner == false`, in that case, actual
+    //  flag value is ignored.
+    const bool actuallyVisibleByNeighbor =
+      propertyInfo.isVisibleByNeighbors && propertyInfo.isVisibleByOwner;
+
+    add(UpdateOwnerFunctions, propertyName,
+        propertyInfo.isVisibleByOwner ? propertyInfo.updateOwner : "");
+    add(UpdateNeighborFunctions, propertyName,
+        actuallyVisibleByNeighbor ? propertyInfo.updateNeighbor : "");
+  }
+
+  if (version > 0 && newEntries == entries) {
+    return false;
+  }
+
+  auto jHashes = nlohmann::json::object();
+  auto jRemoved = nlohmann::json::object();
+  auto jBodies = nlohmann::json::object();
+  auto jManifestHashes = nlohmann::json::object();
+
+  for (size_t i = 0; i < NumSections; ++i) {
+    const char* sectionName = GetSectionName(i);
+    auto& jSectionHashes = jHashes[sectionName] = nlohmann::json::object();
+    auto& jSectionRemoved = jRemoved[sectionName] = nlohmann::json::array();
+    jManifestHashes[sectionName] = newEntries[i];
+
+    for (auto& [name, hash] : newEntries[i]) {
+      auto it = entries[i].find(name);
+      if (it == entries[i].end() || it->second != hash) {
+        jSectionHashes[name] = hash;
+        jBodies[hash] = newBodyByHash[hash];
+      }
+    }
+    for (auto& [name, hash] : entries[i]) {
+      if (!newEntries[i].count(name)) {
+        jSectionRemoved.push_back(name);
+      }
+    }
+  }
+
+  ++version;
+  entries = std::move(newEntries);
+  bodyByHash = std::move(newBodyByHash);
+
+  manifestMessage = nlohmann::json{ { "type", "gamemodeDataManifest" },
+                                    { "version", version },
+                                    { "hashes", jManifestHashes } }
+                      .dump();
+  deltaMessage = nlohmann::json{ { "type", "gamemodeDataDelta" },
+                                 { "version", version },
+                                 { "hashes", jHashes },
+                                 { "removed", jRemoved },
+                                 { "bodies", jBodies } }
+                   .dump();
+  return true;
+}
+
+uint64_t GamemodeData::GetVersion() const noexcept
+{
+  return version;
+}
+
+const std::string& GamemodeData::GetManifestMessage() const noexcept
+{
+  return manifestMessage;
+}
+
+const std::string& GamemodeData::GetDeltaMessage() const noexcept
+{
+  return deltaMessage;
+}
+
+std::string GamemodeData::MakeBodiesMessage(
+  const std::vector<std::string>& hashes) const
+{
+  auto jBodies = nlohmann::json::object();
+  for (auto& hash : hashes) {
+    auto it = bodyByHash.find(hash);
+    if (it != bodyByHash.end()) {
+      jBodies[hash] = it->second;
+    }
+  }
+  return nlohmann::json{ { "type", "gamemodeDataBodies" },
+                         { "version", version },
+                         { "bodies", jBodies } }
+    .dump();
+}
+
+std::string GamemodeData::Hash(const std::string& body)
+{
+  uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : body) {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  return fmt::format("{:016x}", hash);
+}
+
+const char* GamemodeData::GetSectionName(size_t section)
+{
+  switch (section) {
+    case EventSources:
+      return "eventSources";
+    case UpdateOwnerFunctions:
+      return "updateOwnerFunctions";
+    case UpdateNeighborFunctions:
+      return "updateNeighborFunctions";
+  }
+  return "";
+}
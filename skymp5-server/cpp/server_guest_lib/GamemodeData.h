@@ -0,0 +1,61 @@
+#pragma once
+#include "GamemodeApi.h"
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Function bodies of the gamemode (event sources and property update
+// functions) split into entries identified by content hashes. Clients keep
+// bodies they have already seen and only download entries missing from their
+// cache:
+// - on connect a client receives 'gamemodeDataManifest' with entry hashes
+//   and replies with MsgType::RequestGamemodeData listing unknown hashes
+// - the server answers with 'gamemodeDataBodies'
+// - further changes are broadcasted as 'gamemodeDataDelta' containing only
+//   changed and removed entries
+// - a client that misses a delta (its version is not the previous one)
+//   requests the manifest again with "manifest": true in
+//   MsgType::RequestGamemodeData
+class GamemodeData
+{
+public:
+  // Returns false if no entry changed. Otherwise bumps the version and
+  // rebuilds the manifest and delta messages
+  bool Update(const GamemodeApi::State& state);
+
+  uint64_t GetVersion() const noexcept;
+
+  // Messages are JSON without the packet id prefix. Both are empty before
+  // the first Update
+  const std::string& GetManifestMessage() const noexcept;
+  const std::string& GetDeltaMessage() const noexcept;
+
+  // Unknown hashes are skipped: they refer to entries changed since the
+  // client received the manifest and the change is already on its way
+  std::string MakeBodiesMessage(const std::vector<std::string>& hashes) const;
+
+  // 64-bit FNV-1a in hex. Must stay stable between server versions since
+  // clients keep cached bodies across sessions
+  static std::string Hash(const std::string& body);
+
+private:
+  enum Section
+  {
+    EventSources,
+    UpdateOwnerFunctions,
+    UpdateNeighborFunctions,
+    NumSections
+  };
+
+  using Entries = std::map<std::string, std::string>; // name => hash
+
+  static const char* GetSectionName(size_t section);
+
+  std::array<Entries, NumSections> entries;
+  std::unordered_map<std::string, std::string> bodyByHash;
+  uint64_t version = 0;
+  std::string manifestMessage, deltaMessage;
+};
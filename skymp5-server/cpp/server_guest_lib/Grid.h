@@ -65,6 +65,44 @@ public:
     return res;
   }
 
+  // Visits objects located exactly in cells from the given range (bounds are
+  // inclusive). Only occupied cells are visited if there are fewer of them
+  // than cells in the range
+  template <class Visitor>
+  void VisitObjectsInCells(int16_t minX, int16_t maxX, int16_t minY,
+                           int16_t maxY, const Visitor& visitor) const
+  {
+    if (minX > maxX || minY > maxY) {
+      return;
+    }
+
+    const auto numCellsInRange =
+      (int64_t(maxX) - minX + 1) * (int64_t(maxY) - minY + 1);
+
+    if (numCellsInRange > static_cast<int64_t>(cells.size())) {
+      for (auto& [key, cellObjects] : cells) {
+        auto [x, y] = UnpackCell(key);
+        if (x >= minX && x <= maxX && y >= minY && y <= maxY) {
+          for (auto& id : cellObjects) {
+            visitor(id);
+          }
+        }
+      }
+      return;
+    }
+
+    for (int32_t x = minX; x <= maxX; ++x) {
+      for (int32_t y = minY; y <= maxY; ++y) {
+        auto it = cells.find(PackCell(int16_t(x), int16_t(y)));
+        if (it != cells.end()) {
+          for (auto& id : it->second) {
+            visitor(id);
+          }
+        }
+      }
+    }
+  }
+
 private:
   struct Obj
   {
@@ -78,6 +116,13 @@ private:
     auto& obj = objects[id];
 
     if (from) {
+      auto cellIt = cells.find(PackCell(from->first, from->second));
+      if (cellIt != cells.end()) {
+        cellIt->second.erase(id);
+        if (cellIt->second.empty()) {
+          cells.erase(cellIt);
+        }
+      }
       for (int i = -1; i <= 1; ++i) {
         for (int j = -1; j <= 1; ++j) {
           nei.At(from->first + i).At(from->second + j).erase(id);
@@ -86,6 +131,7 @@ private:
     }
 
     if (to) {
+      cells[PackCell(to->first, to->second)].insert(id);
       for (int i = -1; i <= 1; ++i) {
         for (int j = -1; j <= 1; ++j) {
           nei.At(to->first + i).At(to->second + j).insert(id);
@@ -97,6 +143,19 @@ private:
   mutable std::unordered_map<T, Obj> objects;
   mutable DSLine<DSLine<std::set<T>>> nei;
 
+  // Objects by the exact cell they are located in
+  std::unordered_map<uint32_t, std::set<T>> cells;
+
+  static uint32_t PackCell(int16_t x, int16_t y)
+  {
+    return (uint32_t(uint16_t(x)) << 16) | uint16_t(y);
+  }
+
+  static std::pair<int16_t, int16_t> UnpackCell(uint32_t key)
+  {
+    return { int16_t(uint16_t(key >> 16)), int16_t(uint16_t(key)) };
+  }
+
   static bool IsNeighbours(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
   {
     if (x1 <= x2 + 1 && x1 >= x2 - 1 && y1 <= y2 + 1 && y1 >= y2 - 1)
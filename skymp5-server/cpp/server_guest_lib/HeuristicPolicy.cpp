@@ -44,7 +44,7 @@ WorldState* HeuristicPolicy::GetWorldState() const
   return worldState;
 }
 
-void HeuristicPolicy::BeforeSendPapyrusEvent(MpForm* form,
+void HeuristicPolicy::BeforeSendPapyrusEvent(MpForm* form, EventId eventId,
                                              const char* eventName,
                                              const VarValue* arguments,
                                              size_t argumentsCount,
@@ -52,20 +52,43 @@ void HeuristicPolicy::BeforeSendPapyrusEvent(MpForm* form,
 {
   MpActor* actor = nullptr;
 
-  if (!Utils::stricmp(eventName, "OnActivate") && argumentsCount >= 1) {
-    actor = GetFormPtr<MpActor>(arguments[0]);
-  } else if (!Utils::stricmp(eventName, "OnObjectEquipped") ||
-             !Utils::stricmp(eventName, "OnInit") ||
-             !Utils::stricmp(eventName, "OnUpdate")) {
-    actor = dynamic_cast<MpActor*>(form);
-  } else if ((!Utils::stricmp(eventName, "OnTriggerEnter") ||
-              !Utils::stricmp(eventName, "OnTriggerLeave") ||
-              !Utils::stricmp(eventName, "OnTrigger")) &&
-             argumentsCount >= 1) {
-    actor = GetFormPtr<MpActor>(arguments[0]);
+  switch (eventId) {
+    case Events::OnActivate:
+    case Events::OnTriggerEnter:
+    case Events::OnTriggerLeave:
+    case Events::OnTrigger:
+      if (argumentsCount >= 1) {
+        actor = GetFormPtr<MpActor>(arguments[0]);
+      }
+      break;
+    case Events::OnObjectEquipped:
+    case Events::OnInit:
+    case Events::OnUpdate:
+      actor = dynamic_cast<MpActor*>(form);
+      break;
+    default:
+      break;
   }
 
   if (stackInfo.size() <= stackId)
     stackInfo.resize(stackId + 1);
   stackInfo[stackId] = { actor, eventName };
 }
+
+void HeuristicPolicy::BeforeSendPapyrusEvent(MpForm* form,
+                                             const char* eventName,
+                                             const VarValue* arguments,
+                                             size_t argumentsCount,
+                                             int32_t stackId)
+{
+  auto& wellKnown = EventNames::GetWellKnown();
+  auto eventId = wellKnown.Find(eventName);
+  if (!eventId) {
+    // Not a well-known event, only the name is remembered
+    eventId = Events::NumWellKnown;
+  } else {
+    eventName = wellKnown.GetName(*eventId);
+  }
+  BeforeSendPapyrusEvent(form, *eventId, eventName, arguments, argumentsCount,
+                         stackId);
+}
@@ -21,6 +21,13 @@ public:
 
   void SetDefaultActor(int32_t stackId, MpActor* actor);
 
+  // eventName must stay valid while the stack is alive. Names interned by
+  // EventNames satisfy this
+  void BeforeSendPapyrusEvent(MpForm* form, EventId eventId,
+                              const char* eventName, const VarValue* arguments,
+                              size_t argumentsCount, int32_t stackId);
+
+  // Slow path for names that are not interned
   void BeforeSendPapyrusEvent(MpForm* form, const char* eventName,
                               const VarValue* arguments, size_t argumentsCount,
                               int32_t stackId);
@@ -1,6 +1,7 @@
 #pragma once
 #include "MpChangeForms.h"
 #include <cstdint>
+#include <exception>
 #include <functional>
 #include <map>
 #include <optional>
@@ -11,10 +12,17 @@ class ISaveStorage
 public:
   using IterateSyncCallback = std::function<void(const MpChangeForm&)>;
   using UpsertCallback = std::function<void()>;
+  using IterateAsyncCallback = std::function<void(std::exception_ptr)>;
 
   virtual void IterateSync(const IterateSyncCallback& cb) = 0;
   virtual void Upsert(const std::vector<MpChangeForm>& changeForms,
                       const UpsertCallback& cb) = 0;
+
+  // Iterates on a background thread over everything saved by Upserts
+  // requested before this call, and nothing saved by later ones. onFinish is
+  // called from Tick with nullptr or the exception thrown while iterating
+  virtual void IterateAsync(const IterateSyncCallback& cb,
+                            const IterateAsyncCallback& onFinish) = 0;
   virtual uint32_t GetNumFinishedUpserts() const = 0;
   virtual void Tick() = 0;
 };
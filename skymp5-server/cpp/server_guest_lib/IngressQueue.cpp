@@ -0,0 +1,118 @@
+#include "IngressQueue.h"
+#include "MovementMessage.h"
+#include <algorithm>
+
+namespace {
+// Packet id byte, header byte, then idx of the moving actor
+constexpr size_t kMovementIdxOffset = 2;
+constexpr size_t kMovementIdxSize = sizeof(MovementMessage::idx);
+}
+
+IngressQueue::IngressQueue(const IngressQueueSettings& settings_)
+  : settings(settings_)
+{
+}
+
+void IngressQueue::Push(void* state, Networking::UserId userId,
+                        Networking::PacketType packetType,
+                        Networking::PacketData data, size_t length)
+{
+  reinterpret_cast<IngressQueue*>(state)->PushImpl(userId, packetType, data,
+                                                   length);
+}
+
+void IngressQueue::PushImpl(Networking::UserId userId,
+                            Networking::PacketType packetType,
+                            Networking::PacketData data, size_t length)
+{
+  if (queues.size() <= userId) {
+    queues.resize(userId + 1);
+  }
+  auto& queue = queues[userId];
+  ++stats.numReceivedPackets;
+
+  std::vector<uint8_t> packetData(data, data + length);
+
+  if (hasBacklog && packetType == Networking::PacketType::Message &&
+      IsMovement(packetData) && !queue.empty() &&
+      queue.back().type == Networking::PacketType::Message &&
+      IsMovement(queue.back().data)) {
+    auto& previous = queue.back().data;
+    auto idxBegin = packetData.begin() + kMovementIdxOffset;
+    if (std::equal(idxBegin, idxBegin + kMovementIdxSize,
+                   previous.begin() + kMovementIdxOffset)) {
+      previous = std::move(packetData);
+      ++stats.numCoalescedMovements;
+      return;
+    }
+  }
+
+  if (settings.maxQueuedPacketsPerUser > 0 &&
+      packetType == Networking::PacketType::Message &&
+      queue.size() >= settings.maxQueuedPacketsPerUser) {
+    ++stats.numDroppedPackets;
+    return;
+  }
+
+  if (queue.empty()) {
+    usersInTurn.push_back(userId);
+  }
+  queue.push_back({ packetType, std::move(packetData) });
+  ++stats.numQueuedPackets;
+}
+
+void IngressQueue::BeginTick()
+{
+  tickDeadline = std::chrono::steady_clock::now() + settings.maxTimePerTick;
+  numPacketsLeftInTick = settings.maxPacketsPerTick;
+}
+
+void IngressQueue::Process(Networking::IServer::OnPacket onPacket,
+                           void* state)
+{
+  while (!usersInTurn.empty() && !IsBudgetOver()) {
+    auto userId = usersInTurn.front();
+    usersInTurn.pop_front();
+
+    auto& queue = queues[userId];
+    auto packet = std::move(queue.front());
+    queue.pop_front();
+    if (!queue.empty()) {
+      usersInTurn.push_back(userId);
+    }
+
+    --stats.numQueuedPackets;
+    ++stats.numProcessedPackets;
+    if (numPacketsLeftInTick > 0) {
+      --numPacketsLeftInTick;
+    }
+
+    onPacket(state, userId, packet.type, packet.data.data(),
+             packet.data.size());
+  }
+
+  hasBacklog = !usersInTurn.empty();
+  if (hasBacklog) {
+    ++stats.numDeferredTicks;
+  }
+}
+
+const IngressQueueStats& IngressQueue::GetStats() const noexcept
+{
+  return stats;
+}
+
+bool IngressQueue::IsMovement(const std::vector<uint8_t>& data) noexcept
+{
+  return data.size() >= kMovementIdxOffset + kMovementIdxSize &&
+    data[1] == MovementMessage::kHeaderByte;
+}
+
+bool IngressQueue::IsBudgetOver() const
+{
+  if (settings.maxPacketsPerTick > 0 && numPacketsLeftInTick == 0) {
+    return true;
+  }
+  return settings.maxTimePerTick.count() > 0 &&
+    std::chrono::steady_clock::now() >= tickDeadline;
+}
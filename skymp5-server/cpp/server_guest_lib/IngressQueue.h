@@ -0,0 +1,86 @@
+#pragma once
+#include "NetworkingInterface.h" // UserId, PacketData, IServer
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+struct IngressQueueSettings
+{
+  // 0 means no limit
+  size_t maxPacketsPerTick = 0;
+
+  // 0 means no limit
+  std::chrono::microseconds maxTimePerTick{ 0 };
+
+  // Message packets of a user that arrive while this many of their packets
+  // are queued are dropped. Connect and disconnect packets are always
+  // queued. 0 means no limit
+  size_t maxQueuedPacketsPerUser = 0;
+};
+
+struct IngressQueueStats
+{
+  size_t numQueuedPackets = 0;
+  uint64_t numReceivedPackets = 0;
+  uint64_t numProcessedPackets = 0;
+
+  // Movement packets replaced by newer ones of the same user and actor
+  uint64_t numCoalescedMovements = 0;
+
+  // Ticks that ended with packets left for the next tick
+  uint64_t numDeferredTicks = 0;
+
+  // See IngressQueueSettings::maxQueuedPacketsPerUser
+  uint64_t numDroppedPackets = 0;
+};
+
+// Holds received packets between network polling and handling, so that a
+// backlog (e.g. after a hitch) is handled over several ticks instead of one
+// enormous tick. Packets of one user are handled in order, users take turns.
+// While there is a backlog, a movement packet replaces the previous queued
+// movement of the same actor if nothing else was queued after it
+class IngressQueue
+{
+public:
+  explicit IngressQueue(const IngressQueueSettings& settings = {});
+
+  // Networking::IServer::OnPacket, state is IngressQueue*
+  static void Push(void* state, Networking::UserId userId,
+                   Networking::PacketType packetType,
+                   Networking::PacketData data, size_t length);
+
+  // Starts budget of the current tick
+  void BeginTick();
+
+  // Handles queued packets until the queue is empty or the budget of the
+  // current tick is over. A packet is removed before its handler is called.
+  // If the handler throws, the exception is propagated and the next call
+  // continues with the rest of the budget
+  void Process(Networking::IServer::OnPacket onPacket, void* state);
+
+  const IngressQueueStats& GetStats() const noexcept;
+
+private:
+  struct QueuedPacket
+  {
+    Networking::PacketType type = Networking::PacketType::Invalid;
+    std::vector<uint8_t> data;
+  };
+
+  static bool IsMovement(const std::vector<uint8_t>& data) noexcept;
+
+  bool IsBudgetOver() const;
+  void PushImpl(Networking::UserId userId, Networking::PacketType packetType,
+                Networking::PacketData data, size_t length);
+
+  const IngressQueueSettings settings;
+  std::vector<std::deque<QueuedPacket>> queues; // by userId
+  std::deque<Networking::UserId> usersInTurn;
+  bool hasBacklog = false;
+
+  std::chrono::steady_clock::time_point tickDeadline;
+  size_t numPacketsLeftInTick = 0;
+
+  IngressQueueStats stats;
+};
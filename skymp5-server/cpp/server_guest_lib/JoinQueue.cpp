@@ -0,0 +1,47 @@
+#include "JoinQueue.h"
+#include <algorithm>
+
+void JoinQueue::Push(Networking::UserId userId, uint32_t actorFormId)
+{
+  auto it = std::find_if(entries.begin(), entries.end(),
+                         [&](const Entry& e) { return e.userId == userId; });
+  if (it != entries.end()) {
+    it->actorFormId = actorFormId;
+    it->preloaded = false;
+    return;
+  }
+  entries.push_back({ userId, actorFormId });
+}
+
+void JoinQueue::Erase(Networking::UserId userId)
+{
+  entries.erase(
+    std::remove_if(entries.begin(), entries.end(),
+                   [&](const Entry& e) { return e.userId == userId; }),
+    entries.end());
+}
+
+size_t JoinQueue::GetPosition(Networking::UserId userId) const
+{
+  auto it = std::find_if(entries.begin(), entries.end(),
+                         [&](const Entry& e) { return e.userId == userId; });
+  return it == entries.end() ? 0 : (it - entries.begin()) + 1;
+}
+
+std::vector<JoinQueue::Entry> JoinQueue::Pop(size_t maxCount)
+{
+  const size_t n = std::min(maxCount, entries.size());
+  std::vector<Entry> res(entries.begin(), entries.begin() + n);
+  entries.erase(entries.begin(), entries.begin() + n);
+  return res;
+}
+
+bool JoinQueue::Empty() const noexcept
+{
+  return entries.empty();
+}
+
+std::deque<JoinQueue::Entry>& JoinQueue::GetEntries() noexcept
+{
+  return entries;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <Networking.h>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+struct JoinQueueSettings
+{
+  // How many users get their actors activated during one tick. 0 means no
+  // queue: SetUserActor activates the actor immediately
+  size_t maxActivationsPerTick = 0;
+
+  // How many queued users get chunks around their actors loaded during one
+  // tick ahead of activation
+  size_t maxPreloadsPerTick = 8;
+};
+
+// Users waiting for their actors to be activated (placed on the grid and
+// subscribed to neighbours). Activation is the expensive part of joining,
+// so when everybody reconnects after a restart it is spread over ticks
+class JoinQueue
+{
+public:
+  struct Entry
+  {
+    Networking::UserId userId = Networking::InvalidUserId;
+    uint32_t actorFormId = 0;
+    bool preloaded = false;
+    size_t sentPosition = 0; // Last position sent to the user, 0 if none
+  };
+
+  // Replaces the actor of a user who is already queued, keeping the position
+  void Push(Networking::UserId userId, uint32_t actorFormId);
+  void Erase(Networking::UserId userId);
+
+  // 1-based, 0 if the user isn't queued
+  size_t GetPosition(Networking::UserId userId) const;
+
+  std::vector<Entry> Pop(size_t maxCount);
+
+  bool Empty() const noexcept;
+
+  std::deque<Entry>& GetEntries() noexcept;
+
+private:
+  std::deque<Entry> entries;
+};
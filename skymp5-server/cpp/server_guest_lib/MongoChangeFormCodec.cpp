@@ -0,0 +1,468 @@
+#include "MongoChangeFormCodec.h"
+#include <bsoncxx/array/view.hpp>
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/types.hpp>
+#include <bitset>
+#include <fmt/format.h>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::sub_array;
+using bsoncxx::builder::basic::sub_document;
+
+template <class Value>
+void Append(sub_document& builder, const std::string& key, Value&& value)
+{
+  builder.append(kvp(key, std::forward<Value>(value)));
+}
+
+template <class Value>
+void Append(sub_array& builder, const std::string&, Value&& value)
+{
+  builder.append(std::forward<Value>(value));
+}
+
+// Integers are stored as int32 when possible, like bsoncxx::from_json does
+template <class Builder>
+void AppendJson(Builder& builder, const std::string& key,
+                const nlohmann::json& j)
+{
+  switch (j.type()) {
+    case nlohmann::json::value_t::null:
+      Append(builder, key, bsoncxx::types::b_null{});
+      break;
+    case nlohmann::json::value_t::boolean:
+      Append(builder, key, j.get<bool>());
+      break;
+    case nlohmann::json::value_t::number_integer:
+    case nlohmann::json::value_t::number_unsigned: {
+      const auto v = j.get<int64_t>();
+      if (v >= std::numeric_limits<int32_t>::min() &&
+          v <= std::numeric_limits<int32_t>::max()) {
+        Append(builder, key, static_cast<int32_t>(v));
+      } else {
+        Append(builder, key, v);
+      }
+      break;
+    }
+    case nlohmann::json::value_t::number_float:
+      Append(builder, key, j.get<double>());
+      break;
+    case nlohmann::json::value_t::string:
+      Append(builder, key, j.get_ref<const std::string&>());
+      break;
+    case nlohmann::json::value_t::array:
+      Append(builder, key, [&j](sub_array arr) {
+        for (auto& element : j) {
+          AppendJson(arr, std::string(), element);
+        }
+      });
+      break;
+    case nlohmann::json::value_t::object:
+      Append(builder, key, [&j](sub_document doc) {
+        for (auto& item : j.items()) {
+          AppendJson(doc, item.key(), item.value());
+        }
+      });
+      break;
+    default:
+      throw std::runtime_error(
+        fmt::format("Unable to convert '{}' to BSON", key));
+  }
+}
+
+// Element is either bsoncxx::document::element or bsoncxx::array::element
+template <class Element>
+nlohmann::json ElementToJson(const Element& element)
+{
+  switch (element.type()) {
+    case bsoncxx::type::k_double:
+      return element.get_double().value;
+    case bsoncxx::type::k_utf8:
+      return std::string(element.get_utf8().value);
+    case bsoncxx::type::k_document:
+      return MongoChangeFormCodec::BsonToJson(element.get_document().value);
+    case bsoncxx::type::k_array: {
+      auto res = nlohmann::json::array();
+      for (auto& arrayElement : element.get_array().value) {
+        res.push_back(ElementToJson(arrayElement));
+      }
+      return res;
+    }
+    case bsoncxx::type::k_bool:
+      return element.get_bool().value;
+    case bsoncxx::type::k_null:
+    case bsoncxx::type::k_undefined:
+      return nullptr;
+    case bsoncxx::type::k_int32:
+      return element.get_int32().value;
+    case bsoncxx::type::k_int64:
+      return element.get_int64().value;
+    default:
+      throw std::runtime_error(fmt::format(
+        "Unsupported BSON type {} of '{}'", static_cast<int>(element.type()),
+        std::string(element.key())));
+  }
+}
+
+template <class T, class Element>
+T GetNumber(const Element& element)
+{
+  switch (element.type()) {
+    case bsoncxx::type::k_int32:
+      return static_cast<T>(element.get_int32().value);
+    case bsoncxx::type::k_int64:
+      return static_cast<T>(element.get_int64().value);
+    case bsoncxx::type::k_double:
+      return static_cast<T>(element.get_double().value);
+    default:
+      throw std::runtime_error(fmt::format("Expected '{}' to be a number",
+                                           std::string(element.key())));
+  }
+}
+
+template <class Element>
+bool GetBool(const Element& element)
+{
+  if (element.type() != bsoncxx::type::k_bool) {
+    throw std::runtime_error(fmt::format("Expected '{}' to be a boolean",
+                                         std::string(element.key())));
+  }
+  return element.get_bool().value;
+}
+
+template <class Element>
+std::string GetString(const Element& element)
+{
+  if (element.type() != bsoncxx::type::k_utf8) {
+    throw std::runtime_error(fmt::format("Expected '{}' to be a string",
+                                         std::string(element.key())));
+  }
+  return std::string(element.get_utf8().value);
+}
+
+template <class Element>
+bsoncxx::array::view GetArray(const Element& element)
+{
+  if (element.type() != bsoncxx::type::k_array) {
+    throw std::runtime_error(fmt::format("Expected '{}' to be an array",
+                                         std::string(element.key())));
+  }
+  return element.get_array().value;
+}
+
+NiPoint3 GetPoint(const bsoncxx::document::element& element)
+{
+  NiPoint3 res;
+  int i = 0;
+  for (auto& component : GetArray(element)) {
+    if (i >= 3) {
+      break;
+    }
+    res[i++] = GetNumber<float>(component);
+  }
+  if (i != 3) {
+    throw std::runtime_error(fmt::format("Expected '{}' to have 3 elements",
+                                         std::string(element.key())));
+  }
+  return res;
+}
+
+// Nested JSON documents are stored as strings in MpChangeForm
+std::string GetDump(const bsoncxx::document::element& element)
+{
+  auto type = element.type();
+  if (type == bsoncxx::type::k_null || type == bsoncxx::type::k_undefined) {
+    return std::string();
+  }
+  return ElementToJson(element).dump();
+}
+
+Inventory::Entry GetInventoryEntry(const bsoncxx::document::view& document)
+{
+  Inventory::Entry e;
+  bool worn = false, wornLeft = false;
+
+  for (auto& element : document) {
+    const auto key = element.key();
+    if (key == "baseId") {
+      e.baseId = GetNumber<uint32_t>(element);
+    } else if (key == "count") {
+      e.count = GetNumber<uint32_t>(element);
+    } else if (key == "health") {
+      e.extra.health = GetNumber<float>(element);
+    } else if (key == "enchantmentId") {
+      e.extra.ench.id = GetNumber<uint32_t>(element);
+    } else if (key == "maxCharge") {
+      e.extra.ench.maxCharge = GetNumber<float>(element);
+    } else if (key == "removeEnchantmentOnUnequip") {
+      e.extra.ench.removeOnUnequip = GetBool(element);
+    } else if (key == "chargePercent") {
+      e.extra.chargePercent = GetNumber<float>(element);
+    } else if (key == "name") {
+      e.extra.name = GetString(element);
+    } else if (key == "soul") {
+      e.extra.soul = GetNumber<uint8_t>(element);
+    } else if (key == "poisonId") {
+      e.extra.poison.id = GetNumber<uint32_t>(element);
+    } else if (key == "poisonCount") {
+      e.extra.poison.count = GetNumber<uint32_t>(element);
+    } else if (key == "worn") {
+      worn = GetBool(element);
+    } else if (key == "wornLeft") {
+      wornLeft = GetBool(element);
+    }
+  }
+
+  if (wornLeft) {
+    e.extra.worn = Inventory::Worn::Left;
+  } else if (worn) {
+    e.extra.worn = Inventory::Worn::Right;
+  }
+  return e;
+}
+
+Inventory GetInventory(const bsoncxx::document::element& element)
+{
+  if (element.type() != bsoncxx::type::k_document) {
+    throw std::runtime_error("Expected 'inv' to be a document");
+  }
+
+  Inventory res;
+  auto entries = element.get_document().value["entries"];
+  if (!entries) {
+    return res;
+  }
+  for (auto& entry : GetArray(entries)) {
+    if (entry.type() != bsoncxx::type::k_document) {
+      throw std::runtime_error("Expected inventory entry to be a document");
+    }
+    res.entries.push_back(GetInventoryEntry(entry.get_document().value));
+  }
+  return res;
+}
+
+using Element = bsoncxx::document::element;
+
+struct Field
+{
+  const char* key;
+  bool required;
+  void (*read)(const Element& element, MpChangeForm& res);
+};
+
+// Fields of MpChangeForm::ToJson. The same fields are required as in
+// MpChangeForm::JsonToChangeForm, tests compare the two
+constexpr Field kFields[] = {
+  { "recType", true,
+    [](const Element& e, MpChangeForm& res) {
+      res.recType = GetNumber<int>(e);
+    } },
+  { "formDesc", true,
+    [](const Element& e, MpChangeForm& res) {
+      res.formDesc = FormDesc::FromString(GetString(e));
+    } },
+  { "baseDesc", true,
+    [](const Element& e, MpChangeForm& res) {
+      res.baseDesc = FormDesc::FromString(GetString(e));
+    } },
+  { "position", true,
+    [](const Element& e, MpChangeForm& res) { res.position = GetPoint(e); } },
+  { "angle", true,
+    [](const Element& e, MpChangeForm& res) { res.angle = GetPoint(e); } },
+  { "worldOrCellDesc", true,
+    [](const Element& e, MpChangeForm& res) {
+      res.worldOrCellDesc = FormDesc::FromString(GetString(e));
+    } },
+  { "inv", true,
+    [](const Element& e, MpChangeForm& res) { res.inv = GetInventory(e); } },
+  { "isHarvested", true,
+    [](const Element& e, MpChangeForm& res) {
+      res.isHarvested = GetBool(e);
+    } },
+  { "isOpen", true,
+    [](const Element& e, MpChangeForm& res) { res.isOpen = GetBool(e); } },
+  { "baseContainerAdded", true,
+    [](const Element& e, MpChangeForm& res) {
+      res.baseContainerAdded = GetBool(e);
+    } },
+  { "nextRelootDatetime", true,
+    [](const Element& e, MpChangeForm& res) {
+      res.nextRelootDatetime = GetNumber<uint64_t>(e);
+    } },
+  { "isDisabled", true,
+    [](const Element& e, MpChangeForm& res) { res.isDisabled = GetBool(e); } },
+  { "profileId", true,
+    [](const Element& e, MpChangeForm& res) {
+      res.profileId = GetNumber<int32_t>(e);
+    } },
+  { "isRaceMenuOpen", true,
+    [](const Element& e, MpChangeForm& res) {
+      res.isRaceMenuOpen = GetBool(e);
+    } },
+  { "dynamicFields", true,
+    [](const Element& e, MpChangeForm& res) {
+      res.dynamicFields = DynamicFields::FromJson(ElementToJson(e));
+    } },
+  { "appearanceDump", true,
+    [](const Element& e, MpChangeForm& res) {
+      res.appearanceDump = GetDump(e);
+    } },
+  { "equipmentDump", true,
+    [](const Element& e, MpChangeForm& res) {
+      res.equipmentDump = GetDump(e);
+    } },
+  { "learnedSpells", false,
+    [](const Element& e, MpChangeForm& res) {
+      for (auto& spellId : GetArray(e)) {
+        res.learnedSpells.LearnSpell(GetNumber<uint32_t>(spellId));
+      }
+    } },
+  { "healthPercentage", true,
+    [](const Element& e, MpChangeForm& res) {
+      res.actorValues.healthPercentage = GetNumber<float>(e);
+    } },
+  { "magickaPercentage", true,
+    [](const Element& e, MpChangeForm& res) {
+      res.actorValues.magickaPercentage = GetNumber<float>(e);
+    } },
+  { "staminaPercentage", true,
+    [](const Element& e, MpChangeForm& res) {
+      res.actorValues.staminaPercentage = GetNumber<float>(e);
+    } },
+  { "isDead", true,
+    [](const Element& e, MpChangeForm& res) { res.isDead = GetBool(e); } },
+  { "consoleCommandsAllowed", false,
+    [](const Element& e, MpChangeForm& res) {
+      res.consoleCommandsAllowed = GetBool(e);
+    } },
+  { "spawnPoint_pos", true,
+    [](const Element& e, MpChangeForm& res) {
+      res.spawnPoint.pos = GetPoint(e);
+    } },
+  { "spawnPoint_rot", true,
+    [](const Element& e, MpChangeForm& res) {
+      res.spawnPoint.rot = GetPoint(e);
+    } },
+  { "spawnPoint_cellOrWorldDesc", true,
+    [](const Element& e, MpChangeForm& res) {
+      res.spawnPoint.cellOrWorldDesc = FormDesc::FromString(GetString(e));
+    } },
+  { "spawnDelay", true,
+    [](const Element& e, MpChangeForm& res) {
+      res.spawnDelay = GetNumber<float>(e);
+    } },
+};
+}
+
+MongoChangeFormCodec::MongoChangeFormCodec(size_t maxCachedForms_)
+  : maxCachedForms(maxCachedForms_)
+{
+}
+
+std::optional<bsoncxx::document::value> MongoChangeFormCodec::MakeUpdate(
+  const MpChangeForm& changeForm)
+{
+  const auto j = MpChangeForm::ToJson(changeForm);
+
+  if (maxCachedForms == 0) {
+    auto setValue = JsonToBson(j);
+    return bsoncxx::builder::basic::make_document(
+      kvp("$set", bsoncxx::types::b_document{ setValue.view() }));
+  }
+
+  std::vector<std::string> values;
+  values.reserve(j.size());
+  for (auto& item : j.items()) {
+    values.push_back(item.value().dump());
+  }
+
+  auto formDesc = changeForm.formDesc.ToString();
+  if (fieldValues.size() >= maxCachedForms && !fieldValues.count(formDesc)) {
+    fieldValues.clear();
+  }
+
+  auto& previousValues = fieldValues[formDesc];
+  const bool isFullUpdate = previousValues.size() != values.size();
+
+  bsoncxx::builder::basic::document set;
+  bool hasChanges = false;
+  size_t i = 0;
+  for (auto& item : j.items()) {
+    if (isFullUpdate || previousValues[i] != values[i]) {
+      AppendJson(set, item.key(), item.value());
+      hasChanges = true;
+    }
+    ++i;
+  }
+
+  previousValues = std::move(values);
+
+  if (!hasChanges) {
+    return std::nullopt;
+  }
+
+  auto setValue = set.extract();
+  return bsoncxx::builder::basic::make_document(
+    kvp("$set", bsoncxx::types::b_document{ setValue.view() }));
+}
+
+void MongoChangeFormCodec::Forget(const std::string& formDesc)
+{
+  fieldValues.erase(formDesc);
+}
+
+MpChangeForm MongoChangeFormCodec::FromBson(
+  const bsoncxx::document::view& document)
+{
+  MpChangeForm res;
+  std::bitset<std::size(kFields)> found;
+
+  for (auto& element : document) {
+    const auto key = element.key();
+    for (size_t i = 0; i < std::size(kFields); ++i) {
+      if (key == kFields[i].key) {
+        kFields[i].read(element, res);
+        found.set(i);
+        break;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < std::size(kFields); ++i) {
+    if (kFields[i].required && !found[i]) {
+      throw std::runtime_error(fmt::format(
+        "Change form document must have '{}'", kFields[i].key));
+    }
+  }
+
+  return res;
+}
+
+bsoncxx::document::value MongoChangeFormCodec::JsonToBson(
+  const nlohmann::json& j)
+{
+  if (!j.is_object()) {
+    throw std::runtime_error("Only objects can be converted to BSON document");
+  }
+  bsoncxx::builder::basic::document res;
+  for (auto& item : j.items()) {
+    AppendJson(res, item.key(), item.value());
+  }
+  return res.extract();
+}
+
+nlohmann::json MongoChangeFormCodec::BsonToJson(
+  const bsoncxx::document::view& document)
+{
+  auto res = nlohmann::json::object();
+  for (auto& element : document) {
+    res[std::string(element.key())] = ElementToJson(element);
+  }
+  return res;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "MpChangeForms.h"
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Converts change forms to BSON and back without a JSON text round-trip.
+// Remembers what was written for each form to produce field-level updates
+class MongoChangeFormCodec
+{
+public:
+  // Forms remembered at most. The memory is dropped entirely once the limit
+  // is exceeded, so the following updates are full ones. 0 means every
+  // update is a full one
+  explicit MongoChangeFormCodec(size_t maxCachedForms = 100000);
+
+  // Returns '$set' update document containing only top-level fields changed
+  // since the previous call for the same form, or nullopt if nothing changed.
+  // The first call for a form sets all fields
+  std::optional<bsoncxx::document::value> MakeUpdate(
+    const MpChangeForm& changeForm);
+
+  // Makes the next MakeUpdate for this form a full one. Call this if writing
+  // the update failed
+  void Forget(const std::string& formDesc);
+
+  static MpChangeForm FromBson(const bsoncxx::document::view& document);
+
+  static bsoncxx::document::value JsonToBson(const nlohmann::json& j);
+  static nlohmann::json BsonToJson(const bsoncxx::document::view& document);
+
+private:
+  const size_t maxCachedForms;
+
+  // Serialized top-level fields in ToJson order. Compared as strings since a
+  // hash collision would silently lose a write
+  std::unordered_map<std::string, std::vector<std::string>> fieldValues;
+};
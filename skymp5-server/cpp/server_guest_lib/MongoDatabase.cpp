@@ -1,75 +1,171 @@
 #include "MongoDatabase.h"
 
-#include "JsonUtils.h"
-#include <bsoncxx/builder/stream/document.hpp>
-#include <bsoncxx/document/element.hpp>
-#include <bsoncxx/document/value.hpp>
-#include <bsoncxx/document/view.hpp>
-#include <bsoncxx/document/view_or_value.hpp>
-#include <bsoncxx/json.hpp>
+#include "MongoChangeFormCodec.h"
+#include <algorithm>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <deque>
+#include <future>
 #include <mongocxx/client.hpp>
 #include <mongocxx/instance.hpp>
+#include <mongocxx/pool.hpp>
 #include <mongocxx/stdx.hpp>
 #include <mongocxx/uri.hpp>
-#include <nlohmann/json.hpp>
+
+namespace {
+struct PendingUpdate
+{
+  std::string formDesc;
+  mongocxx::model::update_one model;
+};
+
+using Chunk = std::vector<PendingUpdate>;
+}
 
 struct MongoDatabase::Impl
 {
   const std::string uri;
   const std::string name;
+  const MongoDatabaseSettings settings;
+  const std::shared_ptr<spdlog::logger> logger;
 
   const char* const collectionName = "changeForms";
 
-  std::shared_ptr<mongocxx::client> client;
-  std::shared_ptr<mongocxx::database> db;
-  std::shared_ptr<mongocxx::collection> changeFormsCollection;
+  std::unique_ptr<mongocxx::pool> pool;
+
+  // Only accessed from the thread calling Upsert
+  MongoChangeFormCodec codec{ settings.maxCachedChangeForms };
+
+  void WriteChunk(Chunk& chunk)
+  {
+    auto client = pool->acquire();
+    auto collection = (*client)[name][collectionName];
+
+    mongocxx::options::bulk_write options;
+    options.ordered(false); // Each form appears in a chunk at most once
+
+    auto bulk = collection.create_bulk_write(options);
+    for (auto& update : chunk) {
+      bulk.append(std::move(update.model));
+    }
+    (void)bulk.execute();
+  }
 };
 
-MongoDatabase::MongoDatabase(std::string uri_, std::string name_)
+MongoDatabase::MongoDatabase(std::string uri_, std::string name_,
+                             const MongoDatabaseSettings& settings_,
+                             std::shared_ptr<spdlog::logger> logger_)
 {
   static mongocxx::instance g_instance;
 
-  pImpl.reset(new Impl{ uri_, name_ });
+  pImpl.reset(new Impl{ uri_, name_, settings_, logger_ });
 
-  pImpl->client.reset(new mongocxx::client(mongocxx::uri(pImpl->uri.data())));
-  pImpl->db.reset(new mongocxx::database((*pImpl->client)[pImpl->name]));
-  pImpl->changeFormsCollection.reset(
-    new mongocxx::collection((*pImpl->db)[pImpl->collectionName]));
+  pImpl->pool.reset(new mongocxx::pool(mongocxx::uri(pImpl->uri.data())));
 }
 
 size_t MongoDatabase::Upsert(const std::vector<MpChangeForm>& changeForms)
 {
-  auto bulk = pImpl->changeFormsCollection->create_bulk_write();
-  for (auto& changeForm : changeForms) {
-    auto jChangeForm = MpChangeForm::ToJson(changeForm);
+  using bsoncxx::builder::basic::kvp;
+  using bsoncxx::builder::basic::make_document;
 
-    auto filter = nlohmann::json::object();
-    filter["formDesc"] = changeForm.formDesc.ToString();
+  const size_t chunkSize = std::max<size_t>(1, pImpl->settings.bulkWriteSize);
+  const size_t maxInFlight =
+    std::max<size_t>(1, pImpl->settings.maxBulkWritesInFlight);
 
-    auto upd = nlohmann::json::object();
-    upd["$set"] = jChangeForm;
+  std::vector<Chunk> chunks;
+  try {
+    for (auto& changeForm : changeForms) {
+      auto update = pImpl->codec.MakeUpdate(changeForm);
+      if (!update) {
+        continue; // Nothing changed since the last write
+      }
+
+      auto formDesc = changeForm.formDesc.ToString();
+      auto filter = make_document(kvp("formDesc", formDesc));
+
+      if (chunks.empty() || chunks.back().size() >= chunkSize) {
+        chunks.emplace_back();
+        chunks.back().reserve(chunkSize);
+      }
+      mongocxx::model::update_one model(std::move(filter), std::move(*update));
+      model.upsert(true);
+      chunks.back().push_back({ std::move(formDesc), std::move(model) });
+    }
+  } catch (...) {
+    // Codec already remembers these updates as written
+    for (auto& chunk : chunks) {
+      for (auto& update : chunk) {
+        pImpl->codec.Forget(update.formDesc);
+      }
+    }
+    throw;
+  }
+
+  struct InFlight
+  {
+    const Chunk* chunk = nullptr; // Only formDesc is valid after the write
+    std::future<void> future;
+  };
+
+  std::deque<InFlight> inFlight;
+  std::exception_ptr firstError;
+  size_t numFailed = 0;
+
+  auto waitOldest = [&] {
+    auto& oldest = inFlight.front();
+    try {
+      oldest.future.get();
+    } catch (...) {
+      // We don't know what was written, so the next write must be a full one
+      for (auto& update : *oldest.chunk) {
+        pImpl->codec.Forget(update.formDesc);
+      }
+      numFailed += oldest.chunk->size();
+      if (!firstError) {
+        firstError = std::current_exception();
+      }
+    }
+    inFlight.pop_front();
+  };
+
+  for (auto& chunk : chunks) {
+    if (inFlight.size() >= maxInFlight) {
+      waitOldest();
+    }
+    auto pImpl_ = pImpl.get();
+    inFlight.push_back(
+      { &chunk, std::async(std::launch::async, [pImpl_, &chunk] {
+          pImpl_->WriteChunk(chunk);
+        }) });
+  }
+
+  while (!inFlight.empty()) {
+    waitOldest();
+  }
 
-    bulk.append(mongocxx::model::update_one(
-                  { std::move(bsoncxx::from_json(filter.dump())),
-                    std::move(bsoncxx::from_json(upd.dump())) })
-                  .upsert(true));
+  if (firstError) {
+    if (pImpl->logger) {
+      pImpl->logger->error("MongoDatabase: {} of {} change forms failed to save",
+                           numFailed, changeForms.size());
+    }
+    std::rethrow_exception(firstError);
   }
 
-  (void)bulk.execute();
   return changeForms.size(); // Should take data from mongo instead?
 }
 
 void MongoDatabase::Iterate(const IterateCallback& iterateCallback)
 {
-  auto emptyFilter = nlohmann::json::object();
-  auto emptyFilterBson = bsoncxx::from_json(emptyFilter.dump());
+  auto client = pImpl->pool->acquire();
+  auto collection = (*client)[pImpl->name][pImpl->collectionName];
 
-  simdjson::dom::parser p;
+  mongocxx::options::find options;
+  options.batch_size(pImpl->settings.iterateBatchSize);
+  options.no_cursor_timeout(true);
 
-  auto cursor = pImpl->changeFormsCollection->find(std::move(emptyFilterBson));
+  auto cursor = collection.find({}, options);
   for (auto& documentView : cursor) {
-    auto document = p.parse(bsoncxx::to_json(documentView)).value();
-    auto changeForm = MpChangeForm::JsonToChangeForm(document);
+    auto changeForm = MongoChangeFormCodec::FromBson(documentView);
     iterateCallback(changeForm);
   }
 }
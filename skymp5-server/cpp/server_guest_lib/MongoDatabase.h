@@ -1,11 +1,33 @@
 #pragma once
 #include "IDatabase.h"
 #include <memory>
+#include <spdlog/spdlog.h>
+
+struct MongoDatabaseSettings
+{
+  // Maximum number of documents in a single bulk write
+  size_t bulkWriteSize = 1000;
+
+  // Bulk writes executed concurrently. Each one uses its own connection
+  size_t maxBulkWritesInFlight = 4;
+
+  // Number of documents the server returns per cursor batch in Iterate
+  int32_t iterateBatchSize = 10000;
+
+  // Change forms remembered to send only changed fields. 0 makes every write
+  // a full one, which is cheaper when each form is written once. Each form
+  // takes about the size of its JSON, ~1 KB, more for characters
+  size_t maxCachedChangeForms = 100000;
+};
 
 class MongoDatabase : public IDatabase
 {
 public:
-  MongoDatabase(std::string uri_, std::string name_);
+  MongoDatabase(std::string uri_, std::string name_,
+                const MongoDatabaseSettings& settings_ = {},
+                std::shared_ptr<spdlog::logger> logger_ = nullptr);
+
+  // Only fields changed since the previous Upsert of the same form are sent
   size_t Upsert(const std::vector<MpChangeForm>& changeForms) override;
   void Iterate(const IterateCallback& iterateCallback) override;
 
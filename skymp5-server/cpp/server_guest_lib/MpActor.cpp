@@ -31,6 +31,11 @@ struct MpActor::Impl
     { espm::ActorValue::Magicka, std::chrono::steady_clock::time_point{} },
   };
   uint32_t blockActiveCount = 0;
+
+  // Last parsed equipmentDump, so that reading equipment doesn't reparse
+  // JSON unless it has changed
+  std::string parsedEquipmentDump;
+  std::optional<Equipment> parsedEquipment;
 };
 
 MpActor::MpActor(const LocationalData& locationalData_,
@@ -90,6 +95,14 @@ void MpActor::SetEquipment(const std::string& jsonString)
     [&](MpChangeForm& changeForm) { changeForm.equipmentDump = jsonString; });
 }
 
+void MpActor::SetEquipment(const Equipment& equipment)
+{
+  auto jsonString = equipment.ToJson().dump();
+  SetEquipment(jsonString);
+  pImpl->parsedEquipment = equipment;
+  pImpl->parsedEquipmentDump = std::move(jsonString);
+}
+
 void MpActor::VisitProperties(const PropertiesVisitor& visitor,
                               VisitPropertiesMode mode)
 {
@@ -169,10 +182,10 @@ bool MpActor::OnEquip(uint32_t baseId)
   }
 
   const VarValue args[] = {
-    VarValue(std::make_shared<EspmGameObject>(lookupRes)), VarValue::None()
+    VarValue(GetParent()->GetEspmGameObject(lookupRes)), VarValue::None()
   };
 
-  SendPapyrusEvent("OnObjectEquipped", args, std::size(args));
+  SendPapyrusEvent(Events::OnObjectEquipped, args, std::size(args));
 
   const auto& espmFiles = GetParent()->espmFiles;
 
@@ -361,9 +374,14 @@ const std::string& MpActor::GetEquipmentAsJson() const
 
 Equipment MpActor::GetEquipment() const
 {
-  simdjson::dom::parser p;
-
-  return Equipment::FromJson(p.parse(GetEquipmentAsJson()).value());
+  const auto& jsonString = GetEquipmentAsJson();
+  if (!pImpl->parsedEquipment || pImpl->parsedEquipmentDump != jsonString) {
+    simdjson::dom::parser p;
+    pImpl->parsedEquipment =
+      Equipment::FromJson(p.parse(jsonString).value());
+    pImpl->parsedEquipmentDump = jsonString;
+  }
+  return *pImpl->parsedEquipment;
 }
 
 uint32_t MpActor::GetRaceId() const
@@ -35,6 +35,7 @@ public:
   void SetRaceMenuOpen(bool isOpen);
   void SetAppearance(const Appearance* newAppearance);
   void SetEquipment(const std::string& jsonString);
+  void SetEquipment(const Equipment& equipment);
 
   void VisitProperties(const PropertiesVisitor& visitor,
                        VisitPropertiesMode mode) override;
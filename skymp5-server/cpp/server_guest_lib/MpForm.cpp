@@ -15,13 +15,13 @@ void MpForm::Init(WorldState* parent_, uint32_t formId_, bool hasChangeForm)
 
 void MpForm::Update()
 {
-  SendPapyrusEvent("OnUpdate");
+  SendPapyrusEvent(Events::OnUpdate);
 }
 
-void MpForm::SendPapyrusEvent(const char* eventName, const VarValue* arguments,
+void MpForm::SendPapyrusEvent(EventId eventId, const VarValue* arguments,
                               size_t argumentsCount)
 {
-  GetParent()->SendPapyrusEvent(this, eventName, arguments, argumentsCount);
+  GetParent()->SendPapyrusEvent(this, eventId, arguments, argumentsCount);
 }
 
 VarValue MpForm::ToVarValue() const
@@ -58,7 +58,9 @@ protected:
   virtual void Init(WorldState* parent_, uint32_t formId_,
                     bool hasChangeForm); // See WorldState::AddForm
   virtual void Update();
-  virtual void SendPapyrusEvent(const char* eventName,
+  // Takes ids instead of names, so events aren't interned on each call.
+  // Well-known events are in Events, others are interned by the VM once
+  virtual void SendPapyrusEvent(EventId eventId,
                                 const VarValue* arguments = nullptr,
                                 size_t argumentsCount = 0);
 
@@ -10,37 +10,74 @@
 #include "PapyrusObjectReference.h"
 #include "Primitive.h"
 #include "ScopedTask.h"
+#include "ScriptAttachmentCache.h"
 #include "ScriptStorage.h"
 #include "ScriptVariablesHolder.h"
 #include "WorldState.h"
 #include "libespm/GroupUtils.h"
 #include "papyrus-vm/Reader.h"
+#include "papyrus-vm/Utils.h"
 #include "papyrus-vm/VirtualMachine.h"
+#include <algorithm>
 #include <map>
 #include <optional>
+#include <unordered_map>
 
 constexpr uint32_t kPlayerCharacterLevel = 1;
 
+namespace {
+const uint32_t kDoorTypeCode = espm::Type("DOOR").ToUint32();
+
+bool NeedsJsonEscaping(const char* str)
+{
+  for (; *str; ++str) {
+    auto c = static_cast<unsigned char>(*str);
+    if (c < 0x20 || c == '"' || c == '\\') {
+      return true;
+    }
+  }
+  return false;
+}
+}
+
 std::string MpObjectReference::CreatePropertyMessage(
   MpObjectReference* self, const char* name, const nlohmann::json& value)
 {
+  // Same as PreparePropertyMessage(...).dump(), but without building a JSON
+  // object. Keys are in the same (alphabetical) order
   std::string str;
   str += Networking::MinPacketId;
-  str += PreparePropertyMessage(self, name, value).dump();
+  str += '{';
+
+  // See 'perf: improve game framerate #1186'
+  // Client needs to know if it is DOOR or not
+  if (self->baseTypeCode == kDoorTypeCode) {
+    str += R"("baseRecordType":"DOOR",)";
+  }
+
+  str += R"("data":)";
+  str += value.dump();
+  str += R"(,"idx":)";
+  str += std::to_string(self->GetIdx());
+  str += R"(,"propName":)";
+  if (NeedsJsonEscaping(name)) {
+    str += nlohmann::json(name).dump();
+  } else {
+    str += '"';
+    str += name;
+    str += '"';
+  }
+  str += R"(,"refrId":)";
+  str += std::to_string(self->GetFormId());
+  str += R"(,"t":)";
+  str += std::to_string(static_cast<int>(MsgType::UpdateProperty));
+  str += '}';
   return str;
 }
 
 nlohmann::json MpObjectReference::PreparePropertyMessage(
   MpObjectReference* self, const char* name, const nlohmann::json& value)
 {
-  std::string baseRecordType;
-
-  auto& loader = self->GetParent()->GetEspm();
-  auto base = loader.GetBrowser().LookupById(GetBaseId());
-  if (base.rec) {
-    baseRecordType = base.rec->GetType().ToString();
-  }
-
   auto object = nlohmann::json{ { "idx", self->GetIdx() },
                                 { "t", MsgType::UpdateProperty },
                                 { "propName", name },
@@ -49,8 +86,8 @@ nlohmann::json MpObjectReference::PreparePropertyMessage(
 
   // See 'perf: improve game framerate #1186'
   // Client needs to know if it is DOOR or not
-  if (baseRecordType == "DOOR") {
-    object["baseRecordType"] = baseRecordType;
+  if (self->baseTypeCode == kDoorTypeCode) {
+    object["baseRecordType"] = "DOOR";
   }
 
   return object;
@@ -150,6 +187,10 @@ MpObjectReference::MpObjectReference(
 {
   pImpl.reset(new Impl);
 
+  if (baseType.size() == 4) {
+    baseTypeCode = espm::Type(baseType.data()).ToUint32();
+  }
+
   if (primitiveBoundsDiv2)
     SetPrimitive(*primitiveBoundsDiv2);
 }
@@ -256,6 +297,11 @@ bool MpObjectReference::IsActivationBlocked() const
   return activationBlocked;
 }
 
+bool MpObjectReference::IsUserActivationPending() const
+{
+  return userActivationPending;
+}
+
 bool MpObjectReference::GetTeleportFlag() const
 {
   return pImpl->teleportFlag;
@@ -297,7 +343,7 @@ void MpObjectReference::Activate(MpObjectReference& activationSource,
 
   if (!defaultProcessingOnly) {
     auto arg = activationSource.ToVarValue();
-    SendPapyrusEvent("OnActivate", &arg, 1);
+    SendPapyrusEvent(Events::OnActivate, &arg, 1);
   }
 }
 
@@ -348,7 +394,8 @@ void MpObjectReference::SetPos(const NiPoint3& newPos)
               return;
             }
             emitterRefr->SendPapyrusEvent(
-              inside ? "OnTriggerEnter" : "OnTriggerLeave", &me, 1);
+              inside ? Events::OnTriggerEnter : Events::OnTriggerLeave, &me,
+              1);
           });
 
           if (inside)
@@ -375,7 +422,7 @@ void MpObjectReference::SetPos(const NiPoint3& newPos)
             emitterId);
           continue;
         }
-        emitterRefr->SendPapyrusEvent("OnTrigger", &me, 1);
+        emitterRefr->SendPapyrusEvent(Events::OnTrigger, &me, 1);
       }
     }
   }
@@ -478,10 +525,15 @@ void MpObjectReference::SetActivationBlocked(bool blocked)
   activationBlocked = blocked;
 }
 
+void MpObjectReference::SetUserActivationPending(bool pending)
+{
+  userActivationPending = pending;
+}
+
 void MpObjectReference::ForceSubscriptionsUpdate()
 {
   auto worldState = GetParent();
-  if (!worldState || IsDisabled()) {
+  if (!worldState || IsDisabled() || userActivationPending) {
     return;
   }
   InitListenersAndEmitters();
@@ -554,7 +606,11 @@ void MpObjectReference::SetProperty(const std::string& propertyName,
   if (isVisibleByNeighbor) {
     SendPropertyToListeners(propertyName.data(), newValue);
   } else if (isVisibleByOwner) {
-    if (auto ac = dynamic_cast<MpActor*>(this)) {
+    auto worldState = GetParent();
+    if (worldState && worldState->deferPropertyBroadcasts) {
+      worldState->propertyUpdates.Push(GetFormId(), propertyName.data(),
+                                       newValue, false);
+    } else if (auto ac = dynamic_cast<MpActor*>(this)) {
       SendPropertyTo(propertyName.data(), newValue, *ac);
     }
   }
@@ -609,7 +665,7 @@ void MpObjectReference::AddItem(uint32_t baseId, uint32_t count)
   auto itemReference = VarValue((IGameObject*)nullptr);
   auto sourceContainer = VarValue((IGameObject*)nullptr);
   VarValue args[4] = { baseItem, itemCount, itemReference, sourceContainer };
-  SendPapyrusEvent("OnItemAdded", args, 4);
+  SendPapyrusEvent(Events::OnItemAdded, args, 4);
 }
 
 void MpObjectReference::AddItems(const std::vector<Inventory::Entry>& entries)
@@ -628,7 +684,7 @@ void MpObjectReference::AddItems(const std::vector<Inventory::Entry>& entries)
     auto itemReference = VarValue((IGameObject*)nullptr);
     auto sourceContainer = VarValue((IGameObject*)nullptr);
     VarValue args[4] = { baseItem, itemCount, itemReference, sourceContainer };
-    SendPapyrusEvent("OnItemAdded", args, 4);
+    SendPapyrusEvent(Events::OnItemAdded, args, 4);
   }
 }
 
@@ -691,18 +747,21 @@ void MpObjectReference::Subscribe(MpObjectReference* emitter,
   if (!emitter->pImpl->onInitEventSent &&
       listener->GetChangeForm().profileId != -1) {
     emitter->pImpl->onInitEventSent = true;
-    emitter->SendPapyrusEvent("OnInit");
+    emitter->SendPapyrusEvent(Events::OnInit);
   }
 
   const bool hasPrimitive = emitter->HasPrimitive();
 
   emitter->InitListenersAndEmitters();
   listener->InitListenersAndEmitters();
-  emitter->listeners->insert(listener);
+  const bool inserted = emitter->listeners->insert(listener).second;
   listener->emitters->insert(emitter);
   if (!hasPrimitive)
     emitter->callbacks->subscribe(emitter, listener);
 
+  if (inserted)
+    RecordNeighborEvent(emitter, listener, true);
+
   if (hasPrimitive) {
     if (!listener->emittersWithPrimitives)
       listener->emittersWithPrimitives.reset(new std::map<uint32_t, bool>);
@@ -722,12 +781,26 @@ void MpObjectReference::Unsubscribe(MpObjectReference* emitter,
 
   if (!hasPrimitive)
     emitter->callbacks->unsubscribe(emitter, listener);
-  emitter->listeners->erase(listener);
+  const bool erased = emitter->listeners->erase(listener) > 0;
   listener->emitters->erase(emitter);
 
   if (listener->emittersWithPrimitives && hasPrimitive) {
     listener->emittersWithPrimitives->erase(emitter->GetFormId());
   }
+
+  if (erased)
+    RecordNeighborEvent(emitter, listener, false);
+}
+
+void MpObjectReference::RecordNeighborEvent(MpObjectReference* emitter,
+                                            MpObjectReference* listener,
+                                            bool subscribed)
+{
+  auto worldState = emitter->GetParent();
+  if (!worldState || !worldState->neighborEventsEnabled || emitter == listener)
+    return;
+  worldState->neighborEvents.RecordSubscription(
+    emitter->GetFormId(), listener->GetFormId(), subscribed);
 }
 
 const std::set<MpObjectReference*>& MpObjectReference::GetListeners() const
@@ -760,13 +833,54 @@ void MpObjectReference::RequestReloot(
 
 void MpObjectReference::DoReloot()
 {
-  if (ChangeForm().nextRelootDatetime) {
+  if (!ChangeForm().nextRelootDatetime) {
+    return;
+  }
+
+  const bool wasOpen = ChangeForm().isOpen;
+  const bool wasHarvested = ChangeForm().isHarvested;
+
+  // Same as SetOpen(false), SetHarvested(false) and RelootContainer(), but
+  // with a single save request and a single pass over listeners
+  BatchChangeFormEdits([&] {
     EditChangeForm([&](MpChangeFormREFR& changeForm) {
       changeForm.nextRelootDatetime = 0;
+      changeForm.isOpen = false;
+      changeForm.isHarvested = false;
+      changeForm.baseContainerAdded = false;
     });
-    SetOpen(false);
-    SetHarvested(false);
-    RelootContainer();
+    EnsureBaseContainerAdded(*GetParent()->espm);
+  });
+
+  // Updates queued earlier in this tick would be flushed after ours and
+  // override them, so the queue is used when there is one
+  if (GetParent()->deferPropertyBroadcasts) {
+    if (wasOpen) {
+      SendPropertyToListeners("isOpen", false);
+    }
+    if (wasHarvested) {
+      SendPropertyToListeners("isHarvested", false);
+    }
+    return;
+  }
+
+  std::vector<std::string> propertyMessages;
+  if (wasOpen) {
+    propertyMessages.push_back(CreatePropertyMessage(this, "isOpen", false));
+  }
+  if (wasHarvested) {
+    propertyMessages.push_back(
+      CreatePropertyMessage(this, "isHarvested", false));
+  }
+  if (propertyMessages.empty()) {
+    return;
+  }
+  for (auto listener : GetListeners()) {
+    if (auto listenerAsActor = dynamic_cast<MpActor*>(listener)) {
+      for (auto& message : propertyMessages) {
+        SendPropertyTo(message, *listenerAsActor);
+      }
+    }
   }
 }
 
@@ -908,7 +1022,7 @@ void MpObjectReference::VisitNeighbours(const Visitor& visitor)
   }
 }
 
-void MpObjectReference::SendPapyrusEvent(const char* eventName,
+void MpObjectReference::SendPapyrusEvent(EventId eventId,
                                          const VarValue* arguments,
                                          size_t argumentsCount)
 {
@@ -916,7 +1030,7 @@ void MpObjectReference::SendPapyrusEvent(const char* eventName,
     InitScripts();
     pImpl->scriptsInited = true;
   }
-  return MpForm::SendPapyrusEvent(eventName, arguments, argumentsCount);
+  return MpForm::SendPapyrusEvent(eventId, arguments, argumentsCount);
 }
 
 void MpObjectReference::Init(WorldState* parent, uint32_t formId,
@@ -1129,42 +1243,78 @@ void MpObjectReference::InitScripts()
 
   auto& compressedFieldsCache = GetParent()->GetEspmCache();
 
-  std::vector<std::string> scriptNames;
+  struct AttachedScript
+  {
+    std::string name;
+    ScriptVariablesHolder::DecodedScripts decoded;
+  };
+  std::vector<AttachedScript> attachedScripts;
+
+  auto findAttached = [&](const std::string& scriptName) {
+    return std::find_if(attachedScripts.begin(), attachedScripts.end(),
+                        [&](const AttachedScript& v) {
+                          return !Utils::stricmp(v.name.data(),
+                                                 scriptName.data());
+                        });
+  };
+
+  auto& attachmentCache = GetParent()->GetScriptAttachmentCache();
+
+  auto isInStorage = [&](const std::string& scriptName) {
+    if (attachmentCache.IsInStorage(scriptName, *scriptStorage)) {
+      return true;
+    }
+    if (attachmentCache.ShouldReportMissing(scriptName)) {
+      GetParent()->logger->warn(
+        "Script '{}' not found in the script storage", scriptName);
+    }
+    return false;
+  };
 
   auto& br = GetParent()->espm->GetBrowser();
   auto base = br.LookupById(baseId);
   auto refr = br.LookupById(GetFormId());
-  for (auto record : { base.rec, refr.rec }) {
-    if (!record)
-      continue;
-    espm::ScriptData scriptData;
-    record->GetScriptData(&scriptData, compressedFieldsCache);
 
-    auto& scriptsInStorage =
-      GetParent()->GetScriptStorage()->ListScripts(false);
-    for (auto& script : scriptData.scripts) {
-      if (scriptsInStorage.count(
-            { script.scriptName.begin(), script.scriptName.end() })) {
+  // Base record scripts are shared by all references of the base form
+  if (auto attachments =
+        attachmentCache.Get(base, compressedFieldsCache, *scriptStorage)) {
+    for (auto& script : attachments->available) {
+      attachedScripts.push_back({ script->scriptName, { script, nullptr } });
+    }
+    for (auto& script : attachments->missing) {
+      if (isInStorage(script->scriptName)) {
+        attachedScripts.push_back(
+          { script->scriptName, { script, nullptr } });
+      }
+    }
+  }
 
-        if (std::count(scriptNames.begin(), scriptNames.end(),
-                       script.scriptName) == 0) {
-          scriptNames.push_back(script.scriptName);
+  if (refr.rec) {
+    espm::ScriptData scriptData;
+    refr.rec->GetScriptData(&scriptData, compressedFieldsCache);
+    for (auto& script : scriptData.scripts) {
+      auto it = findAttached(script.scriptName);
+      if (it != attachedScripts.end()) {
+        if (!it->decoded.refr) {
+          it->decoded.refr = std::make_shared<espm::Script>(script);
         }
-      } else if (auto wst = GetParent())
-        wst->logger->warn("Script '{}' not found in the script storage",
-                          script.scriptName);
+      } else if (isInStorage(script.scriptName)) {
+        auto decoded = std::make_shared<espm::Script>(script);
+        attachedScripts.push_back({ script.scriptName, { nullptr, decoded } });
+      }
     }
   }
 
-  if (!scriptNames.empty()) {
+  if (!attachedScripts.empty()) {
     pImpl->scriptState.reset(new ScriptState);
 
     std::vector<VirtualMachine::ScriptInfo> scriptInfo;
-    for (auto& scriptName : scriptNames) {
+    for (auto& attachedScript : attachedScripts) {
       auto scriptVariablesHolder = std::make_shared<ScriptVariablesHolder>(
-        scriptName, base, refr, base.parent, &compressedFieldsCache,
-        GetParent());
-      scriptInfo.push_back({ scriptName, std::move(scriptVariablesHolder) });
+        attachedScript.name, base, refr, base.parent, &compressedFieldsCache,
+        GetParent(), attachedScript.decoded);
+      scriptInfo.push_back(
+        { attachedScript.name, std::move(scriptVariablesHolder) });
     }
 
     GetParent()->GetPapyrusVm().AddObject(ToGameObject(), scriptInfo);
@@ -1346,6 +1496,12 @@ void MpObjectReference::CheckInteractionAbility(MpObjectReference& refr)
 void MpObjectReference::SendPropertyToListeners(const char* name,
                                                 const nlohmann::json& value)
 {
+  auto worldState = GetParent();
+  if (worldState && worldState->deferPropertyBroadcasts) {
+    worldState->propertyUpdates.Push(GetFormId(), name, value, true);
+    return;
+  }
+
   auto str = CreatePropertyMessage(this, name, value);
   for (auto listener : GetListeners()) {
     auto listenerAsActor = dynamic_cast<MpActor*>(listener);
@@ -1354,6 +1510,69 @@ void MpObjectReference::SendPropertyToListeners(const char* name,
   }
 }
 
+void MpObjectReference::FlushPropertyUpdates(WorldState* worldState)
+{
+  if (worldState->propertyUpdates.Empty()) {
+    return;
+  }
+
+  std::vector<MpActor*> recipients;
+  std::unordered_map<MpActor*, std::vector<std::string>> messagesByRecipient;
+  auto addMessage = [&](MpActor* recipient, const std::string& message) {
+    auto& messages = messagesByRecipient[recipient];
+    if (messages.empty()) {
+      recipients.push_back(recipient);
+    }
+    messages.push_back(message);
+  };
+
+  for (auto& update : worldState->propertyUpdates.Take()) {
+    // The reference may have been destroyed during the tick
+    auto refr = std::dynamic_pointer_cast<MpObjectReference>(
+      worldState->LookupFormById(update.refrId));
+    if (!refr) {
+      continue;
+    }
+
+    auto message = MpObjectReference::CreatePropertyMessage(
+      refr.get(), update.propName.data(), update.value);
+    if (!update.isVisibleByNeighbors) {
+      if (auto ac = dynamic_cast<MpActor*>(refr.get())) {
+        addMessage(ac, message);
+      }
+      continue;
+    }
+    for (auto listener : refr->GetListeners()) {
+      if (auto listenerAsActor = dynamic_cast<MpActor*>(listener)) {
+        addMessage(listenerAsActor, message);
+      }
+    }
+  }
+
+  for (auto recipient : recipients) {
+    auto& messages = messagesByRecipient[recipient];
+    if (messages.size() == 1) {
+      recipient->SendToUser(messages[0].data(), messages[0].size(), true);
+      continue;
+    }
+
+    // Property messages are embedded without their packet id byte
+    std::string str;
+    str += Networking::MinPacketId;
+    str += R"({"t":)";
+    str += std::to_string(static_cast<int>(MsgType::UpdatePropertyBatch));
+    str += R"(,"updates":[)";
+    for (size_t i = 0; i < messages.size(); ++i) {
+      if (i > 0) {
+        str += ',';
+      }
+      str.append(messages[i], 1, std::string::npos);
+    }
+    str += "]}";
+    recipient->SendToUser(str.data(), str.size(), true);
+  }
+}
+
 void MpObjectReference::SendPropertyTo(const char* name,
                                        const nlohmann::json& value,
                                        MpActor& target)
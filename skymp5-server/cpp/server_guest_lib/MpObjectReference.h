@@ -81,6 +81,7 @@ public:
   FormCallbacks GetCallbacks() const;
   bool HasScript(const char* name) const;
   bool IsActivationBlocked() const;
+  bool IsUserActivationPending() const;
   bool GetTeleportFlag() const;
 
   using PropertiesVisitor =
@@ -104,6 +105,11 @@ public:
   void Disable();
   void Enable();
   void SetActivationBlocked(bool blocked);
+
+  // Set for user actors waiting in the join queue. Location changes are
+  // stored, but the reference stays off the grid until the flag is cleared
+  void SetUserActivationPending(bool pending);
+
   void ForceSubscriptionsUpdate();
   void SetPrimitive(const NiPoint3& boundsDiv2);
   void UpdateHoster(uint32_t newHosterId);
@@ -134,6 +140,10 @@ public:
   static void Unsubscribe(MpObjectReference* emitter,
                           MpObjectReference* listener);
 
+  // Sends property updates queued while WorldState::deferPropertyBroadcasts
+  // is set. Each listener receives one packet for all of its updates
+  static void FlushPropertyUpdates(WorldState* worldState);
+
   const std::set<MpObjectReference*>& GetListeners() const;
   const std::set<MpObjectReference*>& GetEmitters() const;
 
@@ -158,8 +168,7 @@ public:
   void SendInventoryUpdate();
 
 protected:
-  void SendPapyrusEvent(const char* eventName,
-                        const VarValue* arguments = nullptr,
+  void SendPapyrusEvent(EventId eventId, const VarValue* arguments = nullptr,
                         size_t argumentsCount = 0) override;
   void Init(WorldState* parent, uint32_t formId, bool hasChangeForm) override;
 
@@ -181,6 +190,9 @@ private:
   bool IsLocationSavingNeeded() const;
   void ProcessActivate(MpObjectReference& activationSource);
   bool MpApiOnActivate(MpObjectReference& caster);
+  static void RecordNeighborEvent(MpObjectReference* emitter,
+                                  MpObjectReference* listener,
+                                  bool subscribed);
 
   bool everSubscribedOrListened = false;
   std::unique_ptr<std::set<MpObjectReference*>> listeners;
@@ -191,23 +203,30 @@ private:
   std::unique_ptr<std::set<uint32_t>> primitivesWeAreInside;
 
   std::string baseType;
+
+  // baseType packed by espm::Type::ToUint32, 0 if baseType is not a record
+  // type. Cheaper to compare than baseType
+  uint32_t baseTypeCode = 0;
+
   uint32_t baseId = 0;
   MpActor* occupant = nullptr;
   std::shared_ptr<OccupantDestroyEventSink> occupantDestroySink;
   std::optional<std::chrono::system_clock::duration> relootTimeOverride;
   std::unique_ptr<uint8_t> chanceNoneOverride;
   bool activationBlocked = false;
+  bool userActivationPending = false;
 
   struct Impl;
   std::shared_ptr<Impl> pImpl;
 
 protected:
   void BeforeDestroy() override;
-  std::string CreatePropertyMessage(MpObjectReference* self, const char* name,
-                                    const nlohmann::json& value);
-  nlohmann::json PreparePropertyMessage(MpObjectReference* self,
-                                        const char* name,
-                                        const nlohmann::json& value);
+  static std::string CreatePropertyMessage(MpObjectReference* self,
+                                           const char* name,
+                                           const nlohmann::json& value);
+  static nlohmann::json PreparePropertyMessage(MpObjectReference* self,
+                                               const char* name,
+                                               const nlohmann::json& value);
 
   const std::shared_ptr<FormCallbacks> callbacks;
 };
@@ -0,0 +1,62 @@
+#include "NeighborEvents.h"
+#include <algorithm>
+
+void NeighborEvents::RecordSubscription(uint32_t emitterId,
+                                        uint32_t listenerId, bool subscribed)
+{
+  auto key = (static_cast<uint64_t>(emitterId) << 32) | listenerId;
+  subscriptionEvents.push_back({ key, subscribed });
+}
+
+void NeighborEvents::RecordOnline(uint32_t actorId, bool online)
+{
+  onlineEvents.push_back({ actorId, online });
+}
+
+bool NeighborEvents::Empty() const noexcept
+{
+  return subscriptionEvents.empty() && onlineEvents.empty();
+}
+
+NeighborEventsBatch NeighborEvents::Take()
+{
+  Compact(subscriptionEvents);
+  Compact(onlineEvents);
+
+  NeighborEventsBatch res;
+  for (auto& event : subscriptionEvents) {
+    auto& pairs = event.added ? res.entered : res.left;
+    pairs.push_back(static_cast<uint32_t>(event.key >> 32));
+    pairs.push_back(static_cast<uint32_t>(event.key));
+  }
+  for (auto& event : onlineEvents) {
+    auto& actors = event.added ? res.online : res.offline;
+    actors.push_back(static_cast<uint32_t>(event.key));
+  }
+
+  subscriptionEvents.clear();
+  onlineEvents.clear();
+  return res;
+}
+
+void NeighborEvents::Compact(std::vector<Event>& events)
+{
+  // Adds and removals of the same key alternate, so an even number of events
+  // means no change and an odd number means the last event wins
+  std::stable_sort(
+    events.begin(), events.end(),
+    [](const Event& a, const Event& b) { return a.key < b.key; });
+
+  size_t numNetEvents = 0;
+  for (size_t i = 0; i < events.size();) {
+    size_t j = i;
+    while (j < events.size() && events[j].key == events[i].key) {
+      ++j;
+    }
+    if ((j - i) % 2 == 1) {
+      events[numNetEvents++] = events[j - 1];
+    }
+    i = j;
+  }
+  events.resize(numNetEvents);
+}
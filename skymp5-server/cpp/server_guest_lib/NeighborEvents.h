@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+struct NeighborEventsBatch
+{
+  // Flat [emitterId, listenerId, emitterId, listenerId, ...] pairs. Neighbors
+  // of a reference are its emitters and its listeners
+  std::vector<uint32_t> entered, left;
+
+  // Actors that got or lost a user
+  std::vector<uint32_t> online, offline;
+};
+
+// Subscription and online status changes collected between ticks, so that
+// gamemodes can keep incremental state instead of polling neighbors of every
+// player. Changes cancelling each other out within one batch are dropped
+class NeighborEvents
+{
+public:
+  void RecordSubscription(uint32_t emitterId, uint32_t listenerId,
+                          bool subscribed);
+  void RecordOnline(uint32_t actorId, bool online);
+
+  bool Empty() const noexcept;
+
+  // Returns net changes since the previous call and starts a new batch
+  NeighborEventsBatch Take();
+
+private:
+  struct Event
+  {
+    uint64_t key = 0;
+    bool added = false;
+  };
+
+  static void Compact(std::vector<Event>& events);
+
+  std::vector<Event> subscriptionEvents, onlineEvents;
+};
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+struct PacketHistoryElement
+{
+  size_t offset = 0;
+  size_t length = 0;
+  uint64_t timeMs = 0;
+};
+
+struct PacketHistory
+{
+  std::vector<uint8_t> buffer;
+  std::deque<PacketHistoryElement> packets;
+};
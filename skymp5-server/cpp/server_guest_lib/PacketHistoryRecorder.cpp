@@ -0,0 +1,388 @@
+#include "PacketHistoryRecorder.h"
+#include <cstring>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <zlib.h>
+
+namespace {
+struct BlockHeader
+{
+  uint32_t numPackets = 0;
+  uint32_t rawSize = 0;
+  uint32_t compressedSize = 0;
+};
+
+constexpr size_t kPacketHeaderSize = sizeof(uint32_t) + sizeof(uint64_t);
+
+void AppendPacket(std::vector<uint8_t>& out, const uint8_t* data,
+                  size_t length, uint64_t timeMs)
+{
+  const auto length32 = static_cast<uint32_t>(length);
+  const size_t offset = out.size();
+  out.resize(offset + kPacketHeaderSize + length);
+  memcpy(out.data() + offset, &length32, sizeof(length32));
+  memcpy(out.data() + offset + sizeof(length32), &timeMs, sizeof(timeMs));
+  if (length > 0) {
+    memcpy(out.data() + offset + kPacketHeaderSize, data, length);
+  }
+}
+
+std::vector<uint8_t> Decompress(const uint8_t* in, size_t inSize,
+                                size_t rawSize)
+{
+  std::vector<uint8_t> out(rawSize);
+  uLongf outSize = static_cast<uLongf>(rawSize);
+  int res = uncompress(out.data(), &outSize, in, static_cast<uLong>(inSize));
+  if (res != Z_OK || outSize != rawSize) {
+    throw std::runtime_error("uncompress() failed with code " +
+                             std::to_string(res));
+  }
+  return out;
+}
+}
+
+PacketHistoryReader::PacketHistoryReader(
+  const std::filesystem::path& spillPath, uintmax_t spillFileSize,
+  std::vector<std::shared_ptr<const PacketHistoryBlock>> blocks_)
+  : spillFileBytesLeft(spillFileSize)
+  , blocks(std::move(blocks_))
+{
+  if (!spillPath.empty() && spillFileSize > 0) {
+    spillFile.open(spillPath, std::ios::binary);
+    if (!spillFile) {
+      spdlog::error("PacketHistoryReader: unable to open {}",
+                    spillPath.string());
+      spillFileBytesLeft = 0;
+    }
+  }
+}
+
+PacketHistoryReader::PacketHistoryReader(const PacketHistory& history)
+{
+  for (auto& packet : history.packets) {
+    if (history.buffer.size() < packet.offset + packet.length) {
+      spdlog::error("Packet history buffer is corrupted");
+      break;
+    }
+    AppendPacket(decoded, history.buffer.data() + packet.offset,
+                 packet.length, packet.timeMs);
+  }
+}
+
+const PacketHistoryReader::Packet* PacketHistoryReader::Peek()
+{
+  if (hasCurrent) {
+    return &current;
+  }
+
+  while (decodedOffset >= decoded.size()) {
+    if (!LoadNextBlock()) {
+      return nullptr;
+    }
+  }
+
+  if (decoded.size() - decodedOffset < kPacketHeaderSize) {
+    spdlog::error("Packet history buffer is corrupted");
+    decoded.clear();
+    decodedOffset = 0;
+    return Peek();
+  }
+
+  uint32_t length = 0;
+  memcpy(&length, decoded.data() + decodedOffset, sizeof(length));
+  memcpy(&current.timeMs, decoded.data() + decodedOffset + sizeof(length),
+         sizeof(current.timeMs));
+
+  if (decoded.size() - decodedOffset - kPacketHeaderSize < length) {
+    spdlog::error("Packet history buffer is corrupted");
+    decoded.clear();
+    decodedOffset = 0;
+    return Peek();
+  }
+
+  current.data = decoded.data() + decodedOffset + kPacketHeaderSize;
+  current.length = length;
+  hasCurrent = true;
+  return &current;
+}
+
+void PacketHistoryReader::Pop()
+{
+  if (!Peek()) {
+    return;
+  }
+  decodedOffset += kPacketHeaderSize + current.length;
+  hasCurrent = false;
+}
+
+bool PacketHistoryReader::LoadNextBlock()
+{
+  decoded.clear();
+  decodedOffset = 0;
+
+  if (spillFile.is_open() && spillFileBytesLeft >= sizeof(BlockHeader)) {
+    BlockHeader header;
+    spillFile.read(reinterpret_cast<char*>(&header), sizeof(header));
+    spillFileBytesLeft -= sizeof(header);
+
+    std::vector<uint8_t> compressed(header.compressedSize);
+    if (spillFile && header.compressedSize <= spillFileBytesLeft) {
+      spillFile.read(reinterpret_cast<char*>(compressed.data()),
+                     compressed.size());
+      spillFileBytesLeft -= compressed.size();
+    }
+
+    if (!spillFile || compressed.size() != header.compressedSize) {
+      spdlog::error("Packet history spill file is corrupted");
+      spillFile.close();
+      return LoadNextBlock();
+    }
+
+    try {
+      decoded =
+        Decompress(compressed.data(), compressed.size(), header.rawSize);
+    } catch (std::exception& e) {
+      spdlog::error("Packet history spill file is corrupted: {}", e.what());
+      spillFile.close();
+      return LoadNextBlock();
+    }
+    return true;
+  }
+  spillFile.close();
+
+  while (nextBlockIdx < blocks.size()) {
+    auto& block = blocks[nextBlockIdx++];
+    try {
+      decoded = Decompress(block->compressed.data(), block->compressed.size(),
+                           block->rawSize);
+      return true;
+    } catch (std::exception& e) {
+      spdlog::error("Packet history block is corrupted: {}", e.what());
+    }
+  }
+  return false;
+}
+
+PacketHistoryRecorder::PacketHistoryRecorder(
+  const PacketHistoryRecorderSettings& settings_,
+  const std::string& spillFileName)
+  : settings(settings_)
+  , spillPath(settings_.spillDirectory.empty()
+                ? std::filesystem::path()
+                : settings_.spillDirectory / spillFileName)
+{
+  currentBlock.reserve(settings.blockSizeBytes);
+}
+
+PacketHistoryRecorder::~PacketHistoryRecorder()
+{
+  // Keep the spilled history on disk: it is what we replay incidents from
+  if (spillPath.empty()) {
+    return;
+  }
+  try {
+    SpillAll();
+  } catch (std::exception& e) {
+    spdlog::error("PacketHistoryRecorder: unable to spill history - {}",
+                  e.what());
+  }
+}
+
+void PacketHistoryRecorder::Record(const uint8_t* data, size_t length,
+                                   uint64_t timeMs) noexcept
+{
+  // Recording must never affect handling of the packet itself
+  try {
+    AppendPacket(currentBlock, data, length, timeMs);
+    ++currentBlockNumPackets;
+    ++numRecordedPackets;
+
+    if (currentBlock.size() >= settings.blockSizeBytes) {
+      CompressCurrentBlock();
+    }
+  } catch (std::exception& e) {
+    spdlog::error("PacketHistoryRecorder: unable to record packet - {}",
+                  e.what());
+    numDroppedPackets += currentBlockNumPackets;
+    currentBlock.clear();
+    currentBlockNumPackets = 0;
+  }
+}
+
+void PacketHistoryRecorder::Flush()
+{
+  if (currentBlockNumPackets > 0) {
+    CompressCurrentBlock();
+  }
+  if (spillFile.is_open()) {
+    spillFile.flush();
+  }
+}
+
+void PacketHistoryRecorder::SpillAll()
+{
+  if (spillPath.empty()) {
+    return Flush();
+  }
+  if (currentBlockNumPackets > 0) {
+    CompressCurrentBlock();
+  }
+  if (spillFailed) {
+    throw std::runtime_error("Disk spill is disabled after a failure");
+  }
+  // Blocks leave the ring one by one, so a failure in the middle doesn't
+  // make readers see the already spilled blocks twice
+  while (!ring.empty()) {
+    auto& oldest = ring.front();
+    try {
+      SpillBlock(*oldest);
+    } catch (std::exception&) {
+      spillFailed = true;
+      throw;
+    }
+    ringSizeBytes -= oldest->compressed.size();
+    ring.pop_front();
+  }
+  if (spillFile.is_open()) {
+    spillFile.flush();
+  }
+}
+
+void PacketHistoryRecorder::Clear()
+{
+  currentBlock.clear();
+  currentBlockNumPackets = 0;
+  ring.clear();
+  ringSizeBytes = 0;
+  numRecordedPackets = 0;
+  numDroppedPackets = 0;
+
+  if (spillFile.is_open()) {
+    spillFile.close();
+  }
+  spillFileSize = 0;
+  spillFailed = false;
+  if (!spillPath.empty()) {
+    std::error_code ec;
+    std::filesystem::remove(spillPath, ec);
+  }
+}
+
+std::unique_ptr<PacketHistoryReader> PacketHistoryRecorder::CreateReader()
+{
+  Flush();
+  return std::make_unique<PacketHistoryReader>(
+    spillPath, spillFileSize,
+    std::vector<std::shared_ptr<const PacketHistoryBlock>>(ring.begin(),
+                                                           ring.end()));
+}
+
+PacketHistory PacketHistoryRecorder::ToPacketHistory()
+{
+  PacketHistory history;
+
+  auto reader = CreateReader();
+  while (auto packet = reader->Peek()) {
+    PacketHistoryElement element;
+    element.offset = history.buffer.size();
+    element.length = packet->length;
+    element.timeMs = packet->timeMs;
+    history.buffer.insert(history.buffer.end(), packet->data,
+                          packet->data + packet->length);
+    history.packets.push_back(element);
+    reader->Pop();
+  }
+
+  return history;
+}
+
+const std::filesystem::path& PacketHistoryRecorder::GetSpillPath() const
+{
+  return spillPath;
+}
+
+uint64_t PacketHistoryRecorder::GetNumRecordedPackets() const
+{
+  return numRecordedPackets;
+}
+
+uint64_t PacketHistoryRecorder::GetNumDroppedPackets() const
+{
+  return numDroppedPackets;
+}
+
+void PacketHistoryRecorder::CompressCurrentBlock()
+{
+  auto block = std::make_shared<PacketHistoryBlock>();
+  block->numPackets = currentBlockNumPackets;
+  block->rawSize = static_cast<uint32_t>(currentBlock.size());
+
+  // Z_BEST_SPEED since this runs on the tick thread
+  uLongf compressedSize = compressBound(static_cast<uLong>(currentBlock.size()));
+  block->compressed.resize(compressedSize);
+  int res = compress2(block->compressed.data(), &compressedSize,
+                      currentBlock.data(),
+                      static_cast<uLong>(currentBlock.size()), Z_BEST_SPEED);
+  if (res != Z_OK) {
+    throw std::runtime_error("compress2() failed with code " +
+                             std::to_string(res));
+  }
+  block->compressed.resize(compressedSize);
+  block->compressed.shrink_to_fit();
+
+  currentBlock.clear();
+  currentBlockNumPackets = 0;
+
+  ringSizeBytes += block->compressed.size();
+  ring.push_back(std::move(block));
+
+  EnforceRingCapacity();
+}
+
+void PacketHistoryRecorder::EnforceRingCapacity()
+{
+  while (ringSizeBytes > settings.ringCapacityBytes && ring.size() > 1) {
+    auto& oldest = ring.front();
+    if (spillPath.empty() || spillFailed) {
+      numDroppedPackets += oldest->numPackets;
+    } else {
+      try {
+        SpillBlock(*oldest);
+      } catch (std::exception& e) {
+        // E.g. the disk is full. Keep recording in memory only, the spill
+        // file stays readable up to spillFileSize
+        spdlog::error("PacketHistoryRecorder: disk spill disabled - {}",
+                      e.what());
+        spillFailed = true;
+        numDroppedPackets += oldest->numPackets;
+      }
+    }
+    ringSizeBytes -= oldest->compressed.size();
+    ring.pop_front();
+  }
+}
+
+void PacketHistoryRecorder::SpillBlock(const PacketHistoryBlock& block)
+{
+  if (!spillFile.is_open()) {
+    std::filesystem::create_directories(spillPath.parent_path());
+    spillFile.open(spillPath, std::ios::binary | std::ios::trunc);
+    spillFileSize = 0;
+    if (!spillFile) {
+      throw std::runtime_error("Unable to open " + spillPath.string());
+    }
+  }
+
+  BlockHeader header;
+  header.numPackets = block.numPackets;
+  header.rawSize = block.rawSize;
+  header.compressedSize = static_cast<uint32_t>(block.compressed.size());
+
+  spillFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  spillFile.write(reinterpret_cast<const char*>(block.compressed.data()),
+                  block.compressed.size());
+  if (!spillFile) {
+    throw std::runtime_error("Unable to write " + spillPath.string());
+  }
+  spillFileSize += sizeof(header) + block.compressed.size();
+}
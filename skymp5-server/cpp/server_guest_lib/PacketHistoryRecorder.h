@@ -0,0 +1,127 @@
+#pragma once
+#include "PacketHistory.h"
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct PacketHistoryRecorderSettings
+{
+  // Uncompressed size of a block. A block is compressed as soon as it is full
+  size_t blockSizeBytes = 64 * 1024;
+
+  // Limit for compressed blocks kept in memory. When exceeded, the oldest
+  // blocks are spilled to disk (or dropped if spillDirectory is empty)
+  size_t ringCapacityBytes = 4 * 1024 * 1024;
+
+  // Directory for per-user history files. Empty means no disk spill
+  std::filesystem::path spillDirectory;
+};
+
+// Block of packets compressed with zlib. Decompressed layout is a sequence of
+// [uint32_t length][uint64_t timeMs][length bytes of packet data]
+struct PacketHistoryBlock
+{
+  uint32_t numPackets = 0;
+  uint32_t rawSize = 0;
+  std::vector<uint8_t> compressed;
+};
+
+// Streaming reader over a recorded history. Reads spilled blocks from disk
+// one by one, then in-memory blocks. Never holds more than one decompressed
+// block at a time
+class PacketHistoryReader
+{
+public:
+  struct Packet
+  {
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+    uint64_t timeMs = 0;
+  };
+
+  // Only the first spillFileSize bytes of the file are read, so blocks
+  // spilled after the reader was created are not read twice
+  PacketHistoryReader(
+    const std::filesystem::path& spillPath, uintmax_t spillFileSize,
+    std::vector<std::shared_ptr<const PacketHistoryBlock>> blocks);
+  explicit PacketHistoryReader(const PacketHistory& history);
+
+  // Returns nullptr when there are no more packets
+  const Packet* Peek();
+  void Pop();
+
+private:
+  bool LoadNextBlock();
+
+  std::ifstream spillFile;
+  uintmax_t spillFileBytesLeft = 0;
+  std::vector<std::shared_ptr<const PacketHistoryBlock>> blocks;
+  size_t nextBlockIdx = 0;
+
+  std::vector<uint8_t> decoded;
+  size_t decodedOffset = 0;
+
+  Packet current;
+  bool hasCurrent = false;
+};
+
+class PacketHistoryRecorder
+{
+public:
+  // spillFileName is ignored if settings.spillDirectory is empty
+  PacketHistoryRecorder(const PacketHistoryRecorderSettings& settings,
+                        const std::string& spillFileName);
+  ~PacketHistoryRecorder();
+
+  PacketHistoryRecorder(const PacketHistoryRecorder&) = delete;
+  PacketHistoryRecorder& operator=(const PacketHistoryRecorder&) = delete;
+
+  // Never throws: on failure (e.g. a disk spill error) packets are counted as
+  // dropped and the error is logged
+  void Record(const uint8_t* data, size_t length, uint64_t timeMs) noexcept;
+
+  // Compresses the current block even if it isn't full
+  void Flush();
+
+  // Moves everything recorded so far to the spill file. Equivalent to Flush
+  // when there is no spill file. Throws if spilling fails, what is not
+  // spilled yet stays in memory
+  void SpillAll();
+
+  // Removes everything recorded, including the spill file
+  void Clear();
+
+  std::unique_ptr<PacketHistoryReader> CreateReader();
+
+  // Materializes the whole history in memory. Prefer CreateReader
+  PacketHistory ToPacketHistory();
+
+  const std::filesystem::path& GetSpillPath() const;
+  uint64_t GetNumRecordedPackets() const;
+  uint64_t GetNumDroppedPackets() const;
+
+private:
+  void CompressCurrentBlock();
+  void EnforceRingCapacity();
+  void SpillBlock(const PacketHistoryBlock& block);
+
+  const PacketHistoryRecorderSettings settings;
+  const std::filesystem::path spillPath;
+
+  std::vector<uint8_t> currentBlock;
+  uint32_t currentBlockNumPackets = 0;
+
+  std::deque<std::shared_ptr<const PacketHistoryBlock>> ring;
+  size_t ringSizeBytes = 0;
+
+  std::ofstream spillFile;
+  uintmax_t spillFileSize = 0;
+  bool spillFailed = false;
+
+  uint64_t numRecordedPackets = 0;
+  uint64_t numDroppedPackets = 0;
+};
@@ -28,7 +28,7 @@ static const JsonPointer t("t"), idx("idx"), content("content"), data("data"),
   remoteId("remoteId"), eventName("eventName"), health("health"),
   magicka("magicka"), stamina("stamina"), leftSpell("leftSpell"),
   rightSpell("rightSpell"), voiceSpell("voiceSpell"),
-  instantSpell("instantSpell");
+  instantSpell("instantSpell"), hashes("hashes"), manifest("manifest");
 }
 
 struct PacketParser::Impl
@@ -307,6 +307,27 @@ void PacketParser::TransformPacketIntoAction(Networking::UserId userId,
                                 entry);
       break;
     }
+    case MsgType::RequestGamemodeData: {
+      simdjson::dom::element jHashes;
+      ReadEx(jMessage, JsonPointers::hashes, &jHashes);
+      auto arr = jHashes.get_array().value();
+
+      std::vector<std::string> hashes;
+      hashes.reserve(arr.size());
+      for (size_t i = 0; i < arr.size(); ++i) {
+        const char* hash;
+        ReadEx(jHashes, i, &hash);
+        hashes.push_back(hash);
+      }
+
+      bool manifest = false;
+      if (jMessage.at_pointer(JsonPointers::manifest.GetData()).error() ==
+          simdjson::error_code::SUCCESS) {
+        ReadEx(jMessage, JsonPointers::manifest, &manifest);
+      }
+      actionListener.OnRequestGamemodeData(rawMsgData, hashes, manifest);
+      break;
+    }
     default:
       simdjson::dom::element data_;
       ReadEx(jMessage, JsonPointers::data, &data_);
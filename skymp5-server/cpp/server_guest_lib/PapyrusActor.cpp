@@ -2,6 +2,7 @@
 
 #include "MpActor.h"
 #include "MpFormGameObject.h"
+#include "PapyrusFormList.h"
 
 #include "SpSnippetFunctionGen.h"
 #include "papyrus-vm/CIString.h"
@@ -72,10 +73,9 @@ VarValue PapyrusActor::IsEquipped(VarValue self,
 
   std::vector<uint32_t> formIds;
 
-  if (auto formlist = espm::Convert<espm::FLST>(form.rec)) {
-    formIds =
-      espm::GetData<espm::FLST>(formlist->GetId(), selfRefr->GetParent())
-        .formIds;
+  if (auto formList =
+        PapyrusFormList::GetFormList(form, selfRefr->GetParent())) {
+    formIds = formList->GetFormIds();
   } else {
     formIds.emplace_back(form.ToGlobalId(form.rec->GetId()));
   }
@@ -137,14 +137,9 @@ VarValue PapyrusActor::SetAlpha(VarValue self,
     // neigbours by sending papyrus functions to them.
     auto funcName = "SetAlpha";
     auto serializedArgs = SpSnippetFunctionGen::SerializeArguments(arguments);
-    for (auto listener : selfRefr->GetListeners()) {
-      auto targetRefr = dynamic_cast<MpActor*>(listener);
-      if (targetRefr) {
-        SpSnippet(GetName(), funcName, serializedArgs.data(),
-                  selfRefr->GetFormId())
-          .Execute(targetRefr);
-      }
-    }
+    SpSnippet(GetName(), funcName, serializedArgs.data(),
+              selfRefr->GetFormId())
+      .ExecuteBroadcast(selfRefr->GetListeners());
   }
   return VarValue::None();
 }
@@ -26,6 +26,29 @@ VarValue PapyrusForm::RegisterForSingleUpdate(
   return VarValue::None();
 }
 
+VarValue PapyrusForm::RegisterForUpdate(VarValue self,
+                                        const std::vector<VarValue>& arguments)
+{
+  if (arguments.size() >= 1) {
+    if (auto form = GetFormPtr<MpForm>(self)) {
+      double seconds = static_cast<double>(arguments[0]);
+      form->GetParent()->RegisterForUpdate(self, seconds);
+    }
+  }
+
+  return VarValue::None();
+}
+
+VarValue PapyrusForm::UnregisterForUpdate(VarValue self,
+                                          const std::vector<VarValue>&)
+{
+  if (auto form = GetFormPtr<MpForm>(self)) {
+    form->GetParent()->UnregisterForUpdate(self);
+  }
+
+  return VarValue::None();
+}
+
 VarValue PapyrusForm::GetType(VarValue self, const std::vector<VarValue>&)
 {
   const auto& selfRec = GetRecordPtr(self);
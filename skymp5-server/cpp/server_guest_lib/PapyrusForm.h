@@ -9,6 +9,12 @@ public:
   VarValue RegisterForSingleUpdate(VarValue self,
                                    const std::vector<VarValue>& arguments);
 
+  VarValue RegisterForUpdate(VarValue self,
+                             const std::vector<VarValue>& arguments);
+
+  VarValue UnregisterForUpdate(VarValue self,
+                               const std::vector<VarValue>& arguments);
+
   VarValue GetType(VarValue self, const std::vector<VarValue>& arguments);
 
   VarValue HasKeyword(VarValue self, const std::vector<VarValue>& arguments);
@@ -19,6 +25,8 @@ public:
   {
     AddMethod(vm, "RegisterForSingleUpdate",
               &PapyrusForm::RegisterForSingleUpdate);
+    AddMethod(vm, "RegisterForUpdate", &PapyrusForm::RegisterForUpdate);
+    AddMethod(vm, "UnregisterForUpdate", &PapyrusForm::UnregisterForUpdate);
     AddMethod(vm, "GetType", &PapyrusForm::GetType);
     AddMethod(vm, "HasKeyword", &PapyrusForm::HasKeyword);
   }
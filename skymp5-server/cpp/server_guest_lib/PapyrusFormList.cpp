@@ -1,16 +1,20 @@
 #include "PapyrusFormList.h"
 
 #include "EspmGameObject.h"
+#include "WorldState.h"
+
+std::shared_ptr<const DecodedFormList> PapyrusFormList::GetFormList(
+  const espm::LookupResult& formList, WorldState* worldState)
+{
+  return worldState ? worldState->GetFormListCache().Get(formList)
+                    : FormListCache::Decode(formList);
+}
 
 VarValue PapyrusFormList::GetSize(VarValue self,
                                   const std::vector<VarValue>& arguments)
 {
-  espm::CompressedFieldsCache dummyCache;
-
-  const auto& res = GetRecordPtr(self);
-  if (auto formlist = espm::Convert<espm::FLST>(res.rec)) {
-    int size = static_cast<int>(formlist->GetData(dummyCache).formIds.size());
-    return VarValue(size);
+  if (auto formList = GetFormList(GetRecordPtr(self), worldState)) {
+    return VarValue(static_cast<int>(formList->GetFormIds().size()));
   }
   return VarValue(0);
 }
@@ -18,17 +22,16 @@ VarValue PapyrusFormList::GetSize(VarValue self,
 VarValue PapyrusFormList::GetAt(VarValue self,
                                 const std::vector<VarValue>& arguments)
 {
-  espm::CompressedFieldsCache dummyCache;
-
   if (arguments.size() >= 1) {
     int idx = static_cast<int>(arguments[0]);
     const auto& res = GetRecordPtr(self);
-    if (auto formlist = espm::Convert<espm::FLST>(res.rec)) {
-      auto formIds = formlist->GetData(dummyCache).formIds;
+    if (auto formList = GetFormList(res, worldState)) {
+      const auto& formIds = formList->GetFormIds();
       if (idx >= 0 && static_cast<int>(formIds.size()) > idx) {
-        auto formId = res.ToGlobalId(formIds[idx]);
-        auto record = res.parent->LookupById(formId);
-        return VarValue(std::make_shared<EspmGameObject>(record));
+        auto record = res.parent->LookupById(formIds[idx]);
+        return worldState
+          ? VarValue(worldState->GetEspmGameObject(record))
+          : VarValue(std::make_shared<EspmGameObject>(record));
       }
     }
   }
@@ -38,19 +41,13 @@ VarValue PapyrusFormList::GetAt(VarValue self,
 VarValue PapyrusFormList::Find(VarValue self,
                                const std::vector<VarValue>& arguments) const
 {
-  espm::CompressedFieldsCache dummyCache;
-
   if (arguments.size() >= 1) {
-    const auto& res = GetRecordPtr(self);
-    if (auto formlist = espm::Convert<espm::FLST>(res.rec)) {
+    if (auto formList = GetFormList(GetRecordPtr(self), worldState)) {
       const auto& arg = GetRecordPtr(arguments[0]);
       if (arg.rec != nullptr) {
-        auto formId = arg.ToGlobalId(arg.rec->GetId());
-        auto data = formlist->GetData(dummyCache).formIds;
-        for (int i = 0; i < data.size(); i++) {
-          if (data[i] == formId) {
-            return VarValue(i);
-          }
+        int idx = formList->Find(arg.ToGlobalId(arg.rec->GetId()));
+        if (idx >= 0) {
+          return VarValue(idx);
         }
       }
     }
@@ -58,3 +55,19 @@ VarValue PapyrusFormList::Find(VarValue self,
 
   return VarValue::None();
 }
+
+VarValue PapyrusFormList::HasForm(VarValue self,
+                                  const std::vector<VarValue>& arguments)
+{
+  if (arguments.size() >= 1) {
+    if (auto formList = GetFormList(GetRecordPtr(self), worldState)) {
+      const auto& arg = GetRecordPtr(arguments[0]);
+      if (arg.rec != nullptr) {
+        return VarValue(
+          formList->Contains(arg.ToGlobalId(arg.rec->GetId())));
+      }
+    }
+  }
+
+  return VarValue(false);
+}
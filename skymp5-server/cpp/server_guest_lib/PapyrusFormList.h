@@ -1,4 +1,5 @@
 #pragma once
+#include "FormListCache.h"
 #include "IPapyrusClass.h"
 
 class PapyrusFormList : public IPapyrusClass<PapyrusFormList>
@@ -9,13 +10,24 @@ public:
   VarValue GetSize(VarValue self, const std::vector<VarValue>& arguments);
   VarValue GetAt(VarValue self, const std::vector<VarValue>& arguments);
   VarValue Find(VarValue self, const std::vector<VarValue>& arguments) const;
+  VarValue HasForm(VarValue self, const std::vector<VarValue>& arguments);
+
+  // Returns nullptr if formList is not a FLST record. Uses the cache of
+  // worldState if it is not null
+  static std::shared_ptr<const DecodedFormList> GetFormList(
+    const espm::LookupResult& formList, WorldState* worldState);
 
   void Register(VirtualMachine& vm,
                 std::shared_ptr<IPapyrusCompatibilityPolicy> policy,
                 WorldState* world) override
   {
+    worldState = world;
+
     AddMethod(vm, "GetSize", &PapyrusFormList::GetSize);
     AddMethod(vm, "GetAt", &PapyrusFormList::GetAt);
     AddMethod(vm, "Find", &PapyrusFormList::Find);
+    AddMethod(vm, "HasForm", &PapyrusFormList::HasForm);
   }
+
+  WorldState* worldState = nullptr;
 };
@@ -2,8 +2,10 @@
 #include "PapyrusFormList.h"
 
 #include "EspmGameObject.h"
+#include "MpActor.h"
 #include "MpFormGameObject.h"
 #include "WorldState.h"
+#include <random>
 
 VarValue PapyrusGame::IncrementStat(VarValue self,
                                     const std::vector<VarValue>& arguments)
@@ -12,54 +14,157 @@ VarValue PapyrusGame::IncrementStat(VarValue self,
 }
 
 namespace {
-bool ExistsInFormList(const VarValue& formList, uint32_t baseId)
-{
-  int n = static_cast<int>(PapyrusFormList().GetSize(formList, {}));
-  for (int i = 0; i < n; ++i) {
-    VarValue element = PapyrusFormList().GetAt(formList, { VarValue(i) });
-    auto elementRec = GetRecordPtr(element);
-    if (elementRec.rec &&
-        baseId == elementRec.ToGlobalId(elementRec.rec->GetId())) {
-      return true;
+std::mt19937 g_rng{ std::random_device{}() };
+
+enum class PickMode
+{
+  Closest,
+  Random
+};
+
+// VarValue only converts to double, distances are float
+float GetRadius(const VarValue& value)
+{
+  return static_cast<float>(static_cast<double>(value));
+}
+
+VarValue PickReference(const MpObjectReference& center, float radius,
+                       const WorldState::ReferenceFilter& filter,
+                       PickMode mode)
+{
+  auto worldState = center.GetParent();
+  if (!worldState || center.IsDisabled() || !(radius >= 0)) {
+    return VarValue::None();
+  }
+
+  auto cellOrWorld = center.GetCellOrWorld().ToFormId(worldState->espmFiles);
+  auto references = worldState->FindReferencesInRadius(
+    cellOrWorld, center.GetPos(), radius, filter);
+  if (references.empty()) {
+    return VarValue::None();
+  }
+
+  MpObjectReference* res = nullptr;
+  if (mode == PickMode::Random) {
+    std::uniform_int_distribution<size_t> dist(0, references.size() - 1);
+    res = references[dist(g_rng)];
+  } else {
+    float bestDistance = std::numeric_limits<float>::infinity();
+    for (auto refr : references) {
+      float distance = (center.GetPos() - refr->GetPos()).Length();
+      if (bestDistance > distance) {
+        bestDistance = distance;
+        res = refr;
+      }
     }
   }
-  return false;
-}
+  return VarValue(res->ToGameObject());
 }
 
-VarValue PapyrusGame::FindClosestReferenceOfAnyTypeInListFromRef(
-  VarValue self, const std::vector<VarValue>& arguments)
+// Arguments: Form arBaseObject, ObjectReference arCenter, float afRadius
+VarValue FindReferenceOfTypeFromRef(const std::vector<VarValue>& arguments,
+                                    PickMode mode)
 {
-  if (arguments.size() >= 3) {
-    auto arBaseObjects = arguments[0];
-    auto arCenter = GetFormPtr<MpObjectReference>(arguments[1]);
-    double afRadius = static_cast<double>(arguments[2].CastToFloat());
+  if (arguments.size() < 3) {
+    return VarValue::None();
+  }
+
+  auto& baseObject = GetRecordPtr(arguments[0]);
+  auto center = GetFormPtr<MpObjectReference>(arguments[1]);
+  if (!baseObject.rec || !center) {
+    return VarValue::None();
+  }
 
-    if (arBaseObjects && arCenter && afRadius >= 0) {
+  const uint32_t baseId = baseObject.ToGlobalId(baseObject.rec->GetId());
+  return PickReference(
+    *center, GetRadius(arguments[2]),
+    [&](const MpObjectReference& refr) { return refr.GetBaseId() == baseId; },
+    mode);
+}
+
+// Arguments: FormList arBaseObjects, ObjectReference arCenter, float afRadius
+VarValue FindReferenceOfAnyTypeInListFromRef(
+  const std::vector<VarValue>& arguments, PickMode mode)
+{
+  if (arguments.size() < 3) {
+    return VarValue::None();
+  }
 
-      float bestDistance = std::numeric_limits<float>::infinity();
-      MpObjectReference* bestNeighbour = nullptr;
+  auto center = GetFormPtr<MpObjectReference>(arguments[1]);
+  if (!center) {
+    return VarValue::None();
+  }
 
-      arCenter->VisitNeighbours([&](MpObjectReference* neighbour) {
-        auto baseId = neighbour->GetBaseId();
-        if (!ExistsInFormList(arBaseObjects, baseId))
-          return;
+  auto baseObjects = PapyrusFormList::GetFormList(GetRecordPtr(arguments[0]),
+                                                  center->GetParent());
+  if (!baseObjects) {
+    return VarValue::None();
+  }
 
-        float distance = (arCenter->GetPos() - neighbour->GetPos()).Length();
-        if (distance > afRadius)
-          return;
+  return PickReference(
+    *center, GetRadius(arguments[2]),
+    [&](const MpObjectReference& refr) {
+      return baseObjects->Contains(refr.GetBaseId());
+    },
+    mode);
+}
 
-        if (bestDistance > distance) {
-          bestDistance = distance;
-          bestNeighbour = neighbour;
-        }
-      });
+// Arguments: ObjectReference arCenter, float afRadius. Never returns arCenter
+VarValue FindActorFromRef(const std::vector<VarValue>& arguments,
+                          PickMode mode)
+{
+  if (arguments.size() < 2) {
+    return VarValue::None();
+  }
 
-      if (bestNeighbour)
-        return VarValue(std::make_shared<MpFormGameObject>(bestNeighbour));
-    }
+  auto center = GetFormPtr<MpObjectReference>(arguments[0]);
+  if (!center) {
+    return VarValue::None();
   }
-  return VarValue::None();
+
+  return PickReference(
+    *center, GetRadius(arguments[1]),
+    [&](const MpObjectReference& refr) {
+      return &refr != center && dynamic_cast<const MpActor*>(&refr);
+    },
+    mode);
+}
+}
+
+VarValue PapyrusGame::FindClosestReferenceOfTypeFromRef(
+  VarValue self, const std::vector<VarValue>& arguments)
+{
+  return FindReferenceOfTypeFromRef(arguments, PickMode::Closest);
+}
+
+VarValue PapyrusGame::FindRandomReferenceOfTypeFromRef(
+  VarValue self, const std::vector<VarValue>& arguments)
+{
+  return FindReferenceOfTypeFromRef(arguments, PickMode::Random);
+}
+
+VarValue PapyrusGame::FindClosestReferenceOfAnyTypeInListFromRef(
+  VarValue self, const std::vector<VarValue>& arguments)
+{
+  return FindReferenceOfAnyTypeInListFromRef(arguments, PickMode::Closest);
+}
+
+VarValue PapyrusGame::FindRandomReferenceOfAnyTypeInListFromRef(
+  VarValue self, const std::vector<VarValue>& arguments)
+{
+  return FindReferenceOfAnyTypeInListFromRef(arguments, PickMode::Random);
+}
+
+VarValue PapyrusGame::FindClosestActorFromRef(
+  VarValue self, const std::vector<VarValue>& arguments)
+{
+  return FindActorFromRef(arguments, PickMode::Closest);
+}
+
+VarValue PapyrusGame::FindRandomActorFromRef(
+  VarValue self, const std::vector<VarValue>& arguments)
+{
+  return FindActorFromRef(arguments, PickMode::Random);
 }
 
 VarValue PapyrusGame::GetPlayer(VarValue self,
@@ -67,7 +172,8 @@ VarValue PapyrusGame::GetPlayer(VarValue self,
 {
   auto actor = compatibilityPolicy->GetDefaultActor("Game", "GetPlayer",
                                                     self.GetMetaStackId());
-  return VarValue(std::make_shared<MpFormGameObject>(actor));
+  return actor ? VarValue(actor->ToGameObject())
+               : VarValue(std::make_shared<MpFormGameObject>(nullptr));
 }
 
 VarValue PapyrusGame::ShowRaceMenu(VarValue self,
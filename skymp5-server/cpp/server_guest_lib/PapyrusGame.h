@@ -13,8 +13,18 @@ public:
 
   VarValue IncrementStat(VarValue self,
                          const std::vector<VarValue>& arguments);
+  VarValue FindClosestReferenceOfTypeFromRef(
+    VarValue self, const std::vector<VarValue>& arguments);
+  VarValue FindRandomReferenceOfTypeFromRef(
+    VarValue self, const std::vector<VarValue>& arguments);
   VarValue FindClosestReferenceOfAnyTypeInListFromRef(
     VarValue self, const std::vector<VarValue>& arguments);
+  VarValue FindRandomReferenceOfAnyTypeInListFromRef(
+    VarValue self, const std::vector<VarValue>& arguments);
+  VarValue FindClosestActorFromRef(VarValue self,
+                                   const std::vector<VarValue>& arguments);
+  VarValue FindRandomActorFromRef(VarValue self,
+                                  const std::vector<VarValue>& arguments);
   VarValue GetPlayer(VarValue self, const std::vector<VarValue>& arguments);
   VarValue ShowRaceMenu(VarValue self, const std::vector<VarValue>& arguments);
   VarValue ShowLimitedRaceMenu(VarValue self,
@@ -33,8 +43,18 @@ public:
     AddStatic(vm, "DisablePlayerControls",
               &PapyrusGame::DisablePlayerControls);
     AddStatic(vm, "EnablePlayerControls", &PapyrusGame::EnablePlayerControls);
+    AddStatic(vm, "FindClosestReferenceOfTypeFromRef",
+              &PapyrusGame::FindClosestReferenceOfTypeFromRef);
+    AddStatic(vm, "FindRandomReferenceOfTypeFromRef",
+              &PapyrusGame::FindRandomReferenceOfTypeFromRef);
     AddStatic(vm, "FindClosestReferenceOfAnyTypeInListFromRef",
               &PapyrusGame::FindClosestReferenceOfAnyTypeInListFromRef);
+    AddStatic(vm, "FindRandomReferenceOfAnyTypeInListFromRef",
+              &PapyrusGame::FindRandomReferenceOfAnyTypeInListFromRef);
+    AddStatic(vm, "FindClosestActorFromRef",
+              &PapyrusGame::FindClosestActorFromRef);
+    AddStatic(vm, "FindRandomActorFromRef",
+              &PapyrusGame::FindRandomActorFromRef);
     AddStatic(vm, "GetPlayer", &PapyrusGame::GetPlayer);
     AddStatic(vm, "ShowRaceMenu", &PapyrusGame::ShowRaceMenu);
     AddStatic(vm, "ShowLimitedRaceMenu", &PapyrusGame::ShowLimitedRaceMenu);
@@ -1,4 +1,5 @@
 #include "PapyrusKeyword.h"
+#include "EditorIdIndex.h"
 
 VarValue PapyrusKeyword::GetKeyword(VarValue self,
                                     const std::vector<VarValue>& arguments)
@@ -8,23 +9,16 @@ VarValue PapyrusKeyword::GetKeyword(VarValue self,
     return VarValue::None();
   }
 
-  CIString keywordName = arguments[0].GetType() == VarValue::kType_String
+  const char* keywordName = arguments[0].GetType() == VarValue::kType_String
     ? static_cast<const char*>(arguments[0])
     : "";
 
-  for (auto it = keywords.rbegin(); it != keywords.rend(); ++it) {
-    for (auto itKeyword = (*it)->begin(); itKeyword != (*it)->end();
-         ++itKeyword) {
-      auto keyword = reinterpret_cast<espm::KYWD*>(*itKeyword);
-      CIString otherName =
-        keyword->GetData(worldState->GetEspmCache()).editorId;
-
-      if (otherName == keywordName) {
-        return VarValue(std::make_shared<EspmGameObject>(
-          worldState->GetEspm().GetBrowser().LookupById(keyword->GetId())));
-      }
-    }
+  uint32_t formId =
+    worldState->GetEditorIdIndex(espm::KYWD::kType).Find(keywordName);
+  if (!formId) {
+    return VarValue::None();
   }
 
-  return VarValue::None();
+  return VarValue(worldState->GetEspmGameObject(
+    worldState->GetEspm().GetBrowser().LookupById(formId)));
 }
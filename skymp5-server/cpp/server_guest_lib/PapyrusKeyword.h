@@ -17,12 +17,9 @@ public:
     compatibilityPolicy = policy;
     worldState = world;
 
-    keywords = world->GetEspm().GetBrowser().GetRecordsByType("KYWD");
-
     AddStatic(vm, "GetKeyword", &PapyrusKeyword::GetKeyword);
   }
 
   std::shared_ptr<IPapyrusCompatibilityPolicy> compatibilityPolicy;
   WorldState* worldState;
-  std::vector<const std::vector<espm::RecordHeader*>*> keywords;
 };
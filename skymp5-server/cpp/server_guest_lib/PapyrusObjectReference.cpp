@@ -5,6 +5,7 @@
 #include "MpActor.h"
 #include "MpFormGameObject.h"
 #include "MpObjectReference.h"
+#include "PapyrusFormList.h"
 #include "SpSnippetFunctionGen.h"
 #include "WorldState.h"
 #include <cstring>
@@ -68,10 +69,9 @@ VarValue PapyrusObjectReference::AddItem(
   std::vector<uint32_t> formIds;
   bool runSkympHacks = false;
 
-  if (auto formlist = espm::Convert<espm::FLST>(item.rec)) {
-    formIds =
-      espm::GetData<espm::FLST>(formlist->GetId(), selfRefr->GetParent())
-        .formIds;
+  if (auto formList =
+        PapyrusFormList::GetFormList(item, selfRefr->GetParent())) {
+    formIds = formList->GetFormIds();
   } else {
     formIds.emplace_back(item.ToGlobalId(item.rec->GetId()));
     runSkympHacks = true;
@@ -111,10 +111,9 @@ VarValue PapyrusObjectReference::RemoveItem(
   std::vector<uint32_t> formIds;
   bool runSkympHacks = false;
 
-  if (auto formlist = espm::Convert<espm::FLST>(item.rec)) {
-    formIds =
-      espm::GetData<espm::FLST>(formlist->GetId(), selfRefr->GetParent())
-        .formIds;
+  if (auto formList =
+        PapyrusFormList::GetFormList(item, selfRefr->GetParent())) {
+    formIds = formList->GetFormIds();
   } else {
     formIds.emplace_back(item.ToGlobalId(item.rec->GetId()));
     runSkympHacks = true;
@@ -155,10 +154,9 @@ VarValue PapyrusObjectReference::GetItemCount(
     }
     std::vector<uint32_t> formIds;
 
-    if (auto formlist = espm::Convert<espm::FLST>(form.rec)) {
-      formIds =
-        espm::GetData<espm::FLST>(formlist->GetId(), selfRefr->GetParent())
-          .formIds;
+    if (auto formList =
+          PapyrusFormList::GetFormList(form, selfRefr->GetParent())) {
+      formIds = formList->GetFormIds();
     } else {
       formIds.emplace_back(form.ToGlobalId(form.rec->GetId()));
     }
@@ -223,7 +221,7 @@ VarValue PapyrusObjectReference::PlaceAtMe(
 
       auto& refr = worldState->GetFormAt<MpObjectReference>(newRefrId);
       refr.ForceSubscriptionsUpdate();
-      return VarValue(std::make_shared<MpFormGameObject>(&refr));
+      return VarValue(refr.ToGameObject());
     }
   }
   return VarValue::None();
@@ -344,14 +342,9 @@ VarValue PapyrusObjectReference::SetPosition(
     selfRefr->ForceSubscriptionsUpdate();
     auto funcName = "SetPosition";
     auto serializedArgs = SpSnippetFunctionGen::SerializeArguments(arguments);
-    for (auto listener : selfRefr->GetListeners()) {
-      auto targetRefr = dynamic_cast<MpActor*>(listener);
-      if (targetRefr) {
-        SpSnippet(GetName(), funcName, serializedArgs.data(),
-                  selfRefr->GetFormId())
-          .Execute(targetRefr);
-      }
-    }
+    SpSnippet(GetName(), funcName, serializedArgs.data(),
+              selfRefr->GetFormId())
+      .ExecuteBroadcast(selfRefr->GetListeners());
   }
   return VarValue::None();
 }
@@ -366,7 +359,7 @@ VarValue PapyrusObjectReference::GetBaseObject(
         auto& espm = worldState->GetEspm();
         auto lookupRes = espm.GetBrowser().LookupById(baseId);
         if (lookupRes.rec) {
-          return VarValue(std::make_shared<EspmGameObject>(lookupRes));
+          return VarValue(worldState->GetEspmGameObject(lookupRes));
         }
       }
     }
@@ -383,14 +376,9 @@ VarValue PapyrusObjectReference::PlayAnimation(
     }
     auto funcName = "PlayAnimation";
     auto serializedArgs = SpSnippetFunctionGen::SerializeArguments(arguments);
-    for (auto listener : selfRefr->GetListeners()) {
-      auto targetRefr = dynamic_cast<MpActor*>(listener);
-      if (targetRefr) {
-        SpSnippet(GetName(), funcName, serializedArgs.data(),
-                  selfRefr->GetFormId())
-          .Execute(targetRefr);
-      }
-    }
+    SpSnippet(GetName(), funcName, serializedArgs.data(),
+              selfRefr->GetFormId())
+      .ExecuteBroadcast(selfRefr->GetListeners());
   }
   return VarValue::None();
 }
@@ -405,14 +393,9 @@ VarValue PapyrusObjectReference::PlayGamebryoAnimation(
     }
     auto funcName = "PlayGamebryoAnimation";
     auto serializedArgs = SpSnippetFunctionGen::SerializeArguments(arguments);
-    for (auto listener : selfRefr->GetListeners()) {
-      auto targetRefr = dynamic_cast<MpActor*>(listener);
-      if (targetRefr) {
-        SpSnippet(GetName(), funcName, serializedArgs.data(),
-                  selfRefr->GetFormId())
-          .Execute(targetRefr);
-      }
-    }
+    SpSnippet(GetName(), funcName, serializedArgs.data(),
+              selfRefr->GetFormId())
+      .ExecuteBroadcast(selfRefr->GetListeners());
   }
   return VarValue::None();
 }
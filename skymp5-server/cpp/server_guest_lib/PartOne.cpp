@@ -2,6 +2,7 @@
 #include "ActionListener.h"
 #include "Exceptions.h"
 #include "FormCallbacks.h"
+#include "GamemodeData.h"
 #include "IdManager.h"
 #include "JsonUtils.h"
 #include "MsgType.h"
@@ -53,7 +54,12 @@ struct PartOne::Impl
   FakeSendTarget fakeSendTarget;
 
   GamemodeApi::State gamemodeApiState;
-  std::string updateGamemodeDataMsg;
+  GamemodeData gamemodeData;
+
+  PacketHistoryRecorderSettings packetHistorySettings;
+
+  JoinQueueSettings joinQueueSettings;
+  JoinQueue joinQueue;
 };
 
 PartOne::PartOne(Networking::ISendTarget* sendTarget)
@@ -105,30 +111,25 @@ void PartOne::Tick()
   serverState.requestedPlaybacks.clear();
 
   for (auto& [userId, playback] : serverState.activePlaybacks) {
-    auto& packetHistory = playback.history;
-
-    while (
-      !packetHistory.packets.empty() &&
-      playback.startTime +
-          std::chrono::milliseconds(packetHistory.packets.front().timeMs) <=
-        std::chrono::steady_clock::now()) {
-      auto& packet = packetHistory.packets.front();
-
-      if (packetHistory.buffer.size() < packet.offset + packet.length) {
-        spdlog::error("Packet history buffer is corrupted");
-      } else {
-        pImpl->packetParser->TransformPacketIntoAction(
-          userId, &packetHistory.buffer[packet.offset], packet.length,
-          *pImpl->actionListener);
+    auto& reader = *playback.reader;
+
+    while (auto packet = reader.Peek()) {
+      if (playback.startTime + std::chrono::milliseconds(packet->timeMs) >
+          std::chrono::steady_clock::now()) {
+        break;
       }
-      packetHistory.packets.pop_front();
+      pImpl->packetParser->TransformPacketIntoAction(
+        userId, packet->data, packet->length, *pImpl->actionListener);
+      reader.Pop();
     }
   }
 
-  // delete playback if packetHistory.packets is empty
+  ProcessJoinQueue();
+
+  // delete playback if there are no packets left
   for (auto it = serverState.activePlaybacks.begin();
        it != serverState.activePlaybacks.end();) {
-    if (it->second.history.packets.empty()) {
+    if (!it->second.reader->Peek()) {
       it = serverState.activePlaybacks.erase(it);
     } else {
       ++it;
@@ -163,6 +164,10 @@ void PartOne::SetUserActor(Networking::UserId userId, uint32_t actorFormId)
 {
   serverState.EnsureUserExists(userId);
 
+  if (auto previousActor = serverState.ActorByUser(userId)) {
+    previousActor->SetUserActivationPending(false);
+  }
+
   if (actorFormId > 0) {
     auto& actor = worldState.GetFormAt<MpActor>(actorFormId);
 
@@ -178,19 +183,104 @@ void PartOne::SetUserActor(Networking::UserId userId, uint32_t actorFormId)
     actor.UnsubscribeFromAll();
     actor.RemoveFromGrid();
 
+    RecordUserActorOffline(userId);
     serverState.actorsMap.Set(userId, &actor);
+    if (worldState.neighborEventsEnabled) {
+      worldState.neighborEvents.RecordOnline(actorFormId, true);
+    }
 
-    actor.ForceSubscriptionsUpdate();
-
-    if (actor.IsDead() && !actor.IsRespawning()) {
-      actor.RespawnWithDelay();
+    if (pImpl->joinQueueSettings.maxActivationsPerTick > 0) {
+      actor.SetUserActivationPending(true);
+      pImpl->joinQueue.Push(userId, actorFormId);
+      auto position = pImpl->joinQueue.GetPosition(userId);
+      SendJoinQueuePosition(pImpl->joinQueue.GetEntries()[position - 1],
+                            position);
+      return;
     }
 
+    ActivateUserActor(actor);
+
   } else {
+    pImpl->joinQueue.Erase(userId);
+    RecordUserActorOffline(userId);
     serverState.actorsMap.Erase(userId);
   }
 }
 
+void PartOne::RecordUserActorOffline(Networking::UserId userId)
+{
+  if (!worldState.neighborEventsEnabled) {
+    return;
+  }
+  if (auto actor = serverState.ActorByUser(userId)) {
+    worldState.neighborEvents.RecordOnline(actor->GetFormId(), false);
+  }
+}
+
+void PartOne::ActivateUserActor(MpActor& actor)
+{
+  actor.SetUserActivationPending(false);
+  actor.ForceSubscriptionsUpdate();
+
+  if (actor.IsDead() && !actor.IsRespawning()) {
+    actor.RespawnWithDelay();
+  }
+}
+
+void PartOne::ProcessJoinQueue()
+{
+  auto& joinQueue = pImpl->joinQueue;
+  if (joinQueue.Empty()) {
+    return;
+  }
+
+  // Chunk loading (espm references and their change forms) is the heaviest
+  // part of activation. Do it ahead for users that will be activated soon
+  size_t numPreloaded = 0;
+  for (auto& entry : joinQueue.GetEntries()) {
+    if (numPreloaded >= pImpl->joinQueueSettings.maxPreloadsPerTick) {
+      break;
+    }
+    if (entry.preloaded) {
+      continue;
+    }
+    entry.preloaded = true;
+    ++numPreloaded;
+    auto actor = serverState.ActorByUser(entry.userId);
+    if (actor && actor->GetFormId() == entry.actorFormId) {
+      worldState.PreloadChunksAt(
+        actor->GetCellOrWorld().ToFormId(worldState.espmFiles),
+        actor->GetPos());
+    }
+  }
+
+  auto entries =
+    joinQueue.Pop(pImpl->joinQueueSettings.maxActivationsPerTick);
+  for (auto& entry : entries) {
+    // The actor may have been destroyed or reassigned while in the queue
+    auto actor = serverState.ActorByUser(entry.userId);
+    if (actor && actor->GetFormId() == entry.actorFormId) {
+      ActivateUserActor(*actor);
+    }
+  }
+
+  size_t position = 0;
+  for (auto& entry : joinQueue.GetEntries()) {
+    SendJoinQueuePosition(entry, ++position);
+  }
+}
+
+void PartOne::SendJoinQueuePosition(JoinQueue::Entry& entry, size_t position)
+{
+  if (entry.sentPosition == position) {
+    return;
+  }
+  entry.sentPosition = position;
+  Networking::SendFormatted(&GetSendTarget(), entry.userId,
+                            R"({"type": "joinQueue", "position": %zu})",
+                            position);
+}
+
 uint32_t PartOne::GetUserActor(Networking::UserId userId)
 {
   serverState.EnsureUserExists(userId);
@@ -215,6 +305,11 @@ void PartOne::DestroyActor(uint32_t actorFormId)
   std::shared_ptr<MpActor> destroyedForm;
   worldState.DestroyForm<MpActor>(actorFormId, &destroyedForm);
 
+  auto userId = serverState.UserByActor(destroyedForm.get());
+  if (userId != Networking::InvalidUserId) {
+    RecordUserActorOffline(userId);
+  }
+
   serverState.actorsMap.Erase(destroyedForm.get());
 }
 
@@ -275,6 +370,75 @@ void PartOne::SetEnabled(uint32_t actorFormId, bool enabled)
   enabled ? ac.Enable() : ac.Disable();
 }
 
+std::vector<uint32_t> PartOne::PlaceReferences(
+  const std::vector<PlaceRequest>& requests,
+  const std::function<void(MpObjectReference& refr, size_t requestIndex)>&
+    beforeActivation)
+{
+  auto& br = GetEspm().GetBrowser();
+
+  std::vector<std::string> baseTypes;
+  baseTypes.reserve(requests.size());
+  for (auto& request : requests) {
+    auto lookupRes = br.LookupById(request.baseId);
+    if (!lookupRes.rec) {
+      throw std::runtime_error(
+        fmt::format("Bad record Id {:x}", request.baseId));
+    }
+    baseTypes.push_back(lookupRes.rec->GetType().ToString());
+  }
+
+  std::vector<uint32_t> res;
+  std::vector<MpObjectReference*> refrs;
+  res.reserve(requests.size());
+  refrs.reserve(requests.size());
+
+  FormCallbacks callbacks = CreateFormCallbacks();
+  for (size_t i = 0; i < requests.size(); ++i) {
+    auto& request = requests[i];
+
+    std::unique_ptr<MpObjectReference> newRefr;
+    if (baseTypes[i] == "NPC_") {
+      newRefr.reset(
+        new MpActor(request.locationalData, callbacks, request.baseId));
+    } else {
+      newRefr.reset(new MpObjectReference(request.locationalData, callbacks,
+                                          request.baseId, baseTypes[i]));
+    }
+
+    auto newRefrId = worldState.GenerateFormId();
+    worldState.AddForm(std::move(newRefr), newRefrId);
+    res.push_back(newRefrId);
+    refrs.push_back(&worldState.GetFormAt<MpObjectReference>(newRefrId));
+  }
+
+  if (beforeActivation) {
+    try {
+      for (size_t i = 0; i < refrs.size(); ++i) {
+        beforeActivation(*refrs[i], i);
+      }
+    } catch (...) {
+      // Nobody has seen the batch yet. Otherwise it would stay in the world
+      // and in the database, but never get on the grid
+      for (auto formId : res) {
+        if (worldState.LookupFormById(formId)) {
+          worldState.DestroyForm(formId);
+        }
+        worldState.CancelSave(formId);
+      }
+      throw;
+    }
+  }
+
+  // References placed earlier in the batch are already on the grid, so each
+  // pair of new neighbours is subscribed once, by the later one
+  for (auto refr : refrs) {
+    refr->ForceSubscriptionsUpdate();
+  }
+
+  return res;
+}
+
 void PartOne::AttachEspm(espm::Loader* espm)
 {
   pImpl->espm = espm;
@@ -360,7 +524,10 @@ void PartOne::HandlePacket(void* partOneInstance, Networking::UserId userId,
           if (this_->animationSystem) {
             this_->animationSystem->ClearInfo(actor);
           }
+          actor->SetUserActivationPending(false);
         }
+        this_->pImpl->joinQueue.Erase(userId);
+        this_->RecordUserActorOffline(userId);
         this_->serverState.Disconnect(userId);
         this_->serverState.disconnectingUserId = Networking::InvalidUserId;
       });
@@ -398,81 +565,126 @@ float PartOne::CalculateDamage(const MpActor& aggressor, const MpActor& target,
 void PartOne::NotifyGamemodeApiStateChanged(
   const GamemodeApi::State& newState) noexcept
 {
-  nlohmann::json j{ { "type", "updateGamemodeData" },
-                    { "eventSources", nlohmann::json::object() },
-                    { "updateOwnerFunctions", nlohmann::json::object() } };
-  for (auto [eventName, eventSourceInfo] : newState.createdEventSources) {
-    j["eventSources"][eventName] = eventSourceInfo.functionBody;
-  }
-  for (auto [propertyName, propertyInfo] : newState.createdProperties) {
-    //  From docs: isVisibleByNeighbors considered to be always false for
-    //  properties with `isVisibleByOwner == false`, in that case, actual
-    //  flag value is ignored.
-    const bool actuallyVisibleByNeighbor =
-      propertyInfo.isVisibleByNeighbors && propertyInfo.isVisibleByOwner;
+  pImpl->gamemodeApiState = newState;
 
-    j["updateOwnerFunctions"][propertyName] =
-      propertyInfo.isVisibleByOwner ? propertyInfo.updateOwner : "";
-    j["updateNeighborFunctions"][propertyName] =
-      actuallyVisibleByNeighbor ? propertyInfo.updateNeighbor : "";
+  if (!pImpl->gamemodeData.Update(newState)) {
+    return;
   }
 
   std::string m;
   m += Networking::MinPacketId;
-  m += j.dump();
-  pImpl->updateGamemodeDataMsg = m;
+  m += pImpl->gamemodeData.GetDeltaMessage();
 
   for (Networking::UserId i = 0; i <= serverState.maxConnectedId; ++i) {
     if (!serverState.IsConnected(i))
       continue;
+    if (!serverState.userInfo[i]->hasGamemodeDataManifest) {
+      SendGamemodeDataManifest(i);
+      continue;
+    }
     GetSendTarget().Send(i, reinterpret_cast<Networking::PacketData>(m.data()),
                          m.size(), true);
   }
+}
 
-  pImpl->gamemodeApiState = newState;
+void PartOne::SendGamemodeDataManifest(Networking::UserId userId)
+{
+  if (pImpl->gamemodeData.GetVersion() == 0) {
+    return;
+  }
+
+  std::string m;
+  m += Networking::MinPacketId;
+  m += pImpl->gamemodeData.GetManifestMessage();
+  GetSendTarget().Send(userId,
+                       reinterpret_cast<Networking::PacketData>(m.data()),
+                       m.size(), true);
+  serverState.userInfo[userId]->hasGamemodeDataManifest = true;
+}
+
+void PartOne::SendGamemodeDataBodies(Networking::UserId userId,
+                                     const std::vector<std::string>& hashes)
+{
+  std::string m;
+  m += Networking::MinPacketId;
+  m += pImpl->gamemodeData.MakeBodiesMessage(hashes);
+  GetSendTarget().Send(userId,
+                       reinterpret_cast<Networking::PacketData>(m.data()),
+                       m.size(), true);
+}
+
+void PartOne::SetJoinQueueSettings(const JoinQueueSettings& settings)
+{
+  pImpl->joinQueueSettings = settings;
+}
+
+size_t PartOne::GetJoinQueuePosition(Networking::UserId userId) const
+{
+  return pImpl->joinQueue.GetPosition(userId);
+}
+
+void PartOne::SetPacketHistorySettings(
+  const PacketHistoryRecorderSettings& settings)
+{
+  pImpl->packetHistorySettings = settings;
 }
 
 void PartOne::SetPacketHistoryRecording(Networking::UserId userId, bool enable)
 {
-  if (userId < serverState.userInfo.size() && serverState.userInfo[userId]) {
-    if (!serverState.userInfo[userId]->packetHistoryStartTime) {
-      serverState.userInfo[userId]->packetHistoryStartTime =
-        std::chrono::steady_clock::now();
-    }
-    serverState.userInfo[userId]->isPacketHistoryRecording = enable;
-  } else {
-    throw std::runtime_error("Invalid user id " + std::to_string(userId));
+  auto& userInfo = GetUserInfo(userId);
+  if (!userInfo.packetHistoryStartTime) {
+    userInfo.packetHistoryStartTime = std::chrono::steady_clock::now();
   }
+  if (enable) {
+    GetPacketHistoryRecorder(userId);
+  }
+  userInfo.isPacketHistoryRecording = enable;
 }
 
 PacketHistory PartOne::GetPacketHistory(Networking::UserId userId)
 {
-  if (userId < serverState.userInfo.size() && serverState.userInfo[userId]) {
-    return serverState.userInfo[userId]->packetHistory;
-  } else {
-    throw std::runtime_error("Invalid user id " + std::to_string(userId));
+  auto& userInfo = GetUserInfo(userId);
+  if (!userInfo.packetHistoryRecorder) {
+    return PacketHistory();
   }
+  return userInfo.packetHistoryRecorder->ToPacketHistory();
+}
+
+std::unique_ptr<PacketHistoryReader> PartOne::CreatePacketHistoryReader(
+  Networking::UserId userId)
+{
+  return GetPacketHistoryRecorder(userId).CreateReader();
+}
+
+std::filesystem::path PartOne::SpillPacketHistory(Networking::UserId userId)
+{
+  auto& recorder = GetPacketHistoryRecorder(userId);
+  recorder.SpillAll();
+  return recorder.GetSpillPath();
 }
 
 void PartOne::ClearPacketHistory(Networking::UserId userId)
 {
-  if (userId < serverState.userInfo.size() && serverState.userInfo[userId]) {
-    serverState.userInfo[userId]->packetHistory = std::move(PacketHistory{});
-    serverState.userInfo[userId]->packetHistoryStartTime = std::nullopt;
-  } else {
-    throw std::runtime_error("Invalid user id " + std::to_string(userId));
+  auto& userInfo = GetUserInfo(userId);
+  if (userInfo.packetHistoryRecorder) {
+    userInfo.packetHistoryRecorder->Clear();
   }
+  userInfo.packetHistoryStartTime = std::nullopt;
 }
 
 void PartOne::RequestPacketHistoryPlayback(Networking::UserId userId,
                                            const PacketHistory& history)
 {
-  if (userId < serverState.userInfo.size() && serverState.userInfo[userId]) {
-    serverState.requestedPlaybacks[userId] =
-      Playback{ history, std::chrono::steady_clock::now() };
-  } else {
-    throw std::runtime_error("Invalid user id " + std::to_string(userId));
-  }
+  RequestPacketHistoryPlayback(userId,
+                               std::make_shared<PacketHistoryReader>(history));
+}
+
+void PartOne::RequestPacketHistoryPlayback(
+  Networking::UserId userId, std::shared_ptr<PacketHistoryReader> reader)
+{
+  GetUserInfo(userId);
+  serverState.requestedPlaybacks[userId] =
+    Playback{ std::move(reader), std::chrono::steady_clock::now() };
 }
 
 FormCallbacks PartOne::CreateFormCallbacks()
@@ -677,12 +889,7 @@ void PartOne::AddUser(Networking::UserId userId, UserType type)
   for (auto& listener : worldState.listeners)
     listener->OnConnect(userId);
 
-  if (!pImpl->updateGamemodeDataMsg.empty()) {
-    GetSendTarget().Send(userId,
-                         reinterpret_cast<Networking::PacketData>(
-                           pImpl->updateGamemodeDataMsg.data()),
-                         pImpl->updateGamemodeDataMsg.size(), true);
-  }
+  SendGamemodeDataManifest(userId);
 }
 
 void PartOne::HandleMessagePacket(Networking::UserId userId,
@@ -700,24 +907,20 @@ void PartOne::HandleMessagePacket(Networking::UserId userId,
 
   auto& userInfo = serverState.userInfo[userId];
   if (userInfo && userInfo->isPacketHistoryRecording) {
-    if (!userInfo->packetHistoryStartTime) {
-      spdlog::error(
-        "Expected packetHistoryStartTime to present, probably incorrect code");
+    if (!userInfo->packetHistoryStartTime ||
+        !userInfo->packetHistoryRecorder) {
+      spdlog::error("Expected packetHistoryStartTime and "
+                    "packetHistoryRecorder to present, probably incorrect "
+                    "code");
     } else {
-      size_t offset = userInfo->packetHistory.buffer.size();
-
-      userInfo->packetHistory.buffer.resize(offset + length);
-      std::copy(data, data + length,
-                userInfo->packetHistory.buffer.data() + offset);
-
       auto duration =
         std::chrono::steady_clock::now() - *userInfo->packetHistoryStartTime;
       auto milliseconds =
         std::chrono::duration_cast<std::chrono::milliseconds>(duration);
       auto timeMs = milliseconds.count();
 
-      userInfo->packetHistory.packets.push_back(
-        { offset, length, static_cast<uint64_t>(timeMs) });
+      userInfo->packetHistoryRecorder->Record(data, length,
+                                              static_cast<uint64_t>(timeMs));
     }
   }
 
@@ -734,3 +937,26 @@ void PartOne::InitActionListener()
   if (!pImpl->actionListener)
     pImpl->actionListener.reset(new ActionListener(*this));
 }
+
+UserInfo& PartOne::GetUserInfo(Networking::UserId userId)
+{
+  if (userId < serverState.userInfo.size() && serverState.userInfo[userId]) {
+    return *serverState.userInfo[userId];
+  }
+  throw std::runtime_error("Invalid user id " + std::to_string(userId));
+}
+
+PacketHistoryRecorder& PartOne::GetPacketHistoryRecorder(
+  Networking::UserId userId)
+{
+  auto& userInfo = GetUserInfo(userId);
+  if (!userInfo.packetHistoryRecorder) {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    auto fileName = fmt::format(
+      "user_{}_{}.bin", userId,
+      std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+    userInfo.packetHistoryRecorder = std::make_unique<PacketHistoryRecorder>(
+      pImpl->packetHistorySettings, fileName);
+  }
+  return *userInfo.packetHistoryRecorder;
+}
@@ -2,6 +2,7 @@
 #include "AnimationSystem.h"
 #include "GamemodeApi.h"
 #include "ISaveStorage.h"
+#include "JoinQueue.h"
 #include "MpActor.h"
 #include "Networking.h"
 #include "NiPoint3.h"
@@ -10,6 +11,7 @@
 #include "WorldState.h"
 #include "formulas/IDamageFormula.h"
 #include "libespm/Loader.h"
+#include <functional>
 #include <memory>
 #include <nlohmann/json.hpp>
 #include <set>
@@ -20,6 +22,14 @@
 using ProfileId = int32_t;
 class ActionListener;
 
+struct PlaceRequest
+{
+  uint32_t baseId = 0;
+  LocationalData locationalData = { { 0, 0, 0 },
+                                    { 0, 0, 0 },
+                                    FormDesc::Tamriel() };
+};
+
 struct HitData;
 
 class PartOne
@@ -52,6 +62,8 @@ public:
   // API
   uint32_t CreateActor(uint32_t formId, const NiPoint3& pos, float angleZ,
                        uint32_t cellOrWorld, ProfileId profileId = -1);
+  // With JoinQueueSettings::maxActivationsPerTick set the user gets the actor
+  // immediately, but the actor enters the world in one of the next ticks
   void SetUserActor(Networking::UserId userId, uint32_t actorFormId);
   uint32_t GetUserActor(Networking::UserId userId);
   Networking::UserId GetUserByActor(uint32_t formId);
@@ -65,6 +77,17 @@ public:
   const std::set<uint32_t>& GetActorsByProfileId(ProfileId profileId);
   void SetEnabled(uint32_t actorFormId, bool enabled);
 
+  // Creates references (actors for NPC_ records) at their initial places.
+  // All forms are added first, then 'beforeActivation' is called for each of
+  // them while nobody sees them yet (e.g. to set properties), then each
+  // reference is put on the grid and subscribed once. Throws before creating
+  // anything if a base record doesn't exist. If beforeActivation throws, the
+  // whole batch is destroyed and the exception is rethrown
+  std::vector<uint32_t> PlaceReferences(
+    const std::vector<PlaceRequest>& requests,
+    const std::function<void(MpObjectReference& refr, size_t requestIndex)>&
+      beforeActivation = nullptr);
+
   void AttachEspm(espm::Loader* espm);
   void AttachSaveStorage(std::shared_ptr<ISaveStorage> saveStorage);
   espm::Loader& GetEspm() const;
@@ -88,11 +111,30 @@ public:
   void NotifyGamemodeApiStateChanged(
     const GamemodeApi::State& newState) noexcept;
 
+  // Answers MsgType::RequestGamemodeData, see GamemodeData
+  void SendGamemodeDataBodies(Networking::UserId userId,
+                              const std::vector<std::string>& hashes);
+
+  // Does nothing before the first NotifyGamemodeApiStateChanged. Users that
+  // didn't receive the manifest get it instead of the next delta
+  void SendGamemodeDataManifest(Networking::UserId userId);
+
+  void SetJoinQueueSettings(const JoinQueueSettings& settings);
+  // 1-based, 0 if the user's actor isn't waiting for activation
+  size_t GetJoinQueuePosition(Networking::UserId userId) const;
+
+  void SetPacketHistorySettings(const PacketHistoryRecorderSettings& settings);
   void SetPacketHistoryRecording(Networking::UserId userId, bool value);
   PacketHistory GetPacketHistory(Networking::UserId userId);
+  std::unique_ptr<PacketHistoryReader> CreatePacketHistoryReader(
+    Networking::UserId userId);
+  // Returns path to the spill file or empty path if disk spill is disabled
+  std::filesystem::path SpillPacketHistory(Networking::UserId userId);
   void ClearPacketHistory(Networking::UserId userId);
   void RequestPacketHistoryPlayback(Networking::UserId userId,
                                     const PacketHistory& history);
+  void RequestPacketHistoryPlayback(
+    Networking::UserId userId, std::shared_ptr<PacketHistoryReader> reader);
 
 private:
   void Init();
@@ -110,6 +152,15 @@ private:
 
   void InitActionListener();
 
+  void ActivateUserActor(MpActor& actor);
+  void ProcessJoinQueue();
+  void RecordUserActorOffline(Networking::UserId userId);
+  // Does nothing if the user already knows this position
+  void SendJoinQueuePosition(JoinQueue::Entry& entry, size_t position);
+
+  UserInfo& GetUserInfo(Networking::UserId userId);
+  PacketHistoryRecorder& GetPacketHistoryRecorder(Networking::UserId userId);
+
   struct Impl;
   std::shared_ptr<Impl> pImpl;
 };
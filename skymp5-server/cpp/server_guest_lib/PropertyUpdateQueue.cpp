@@ -0,0 +1,29 @@
+#include "PropertyUpdateQueue.h"
+
+void PropertyUpdateQueue::Push(uint32_t refrId, const char* propName,
+                               const nlohmann::json& value,
+                               bool isVisibleByNeighbors)
+{
+  auto [it, inserted] =
+    updateIndexByKey.emplace(std::make_pair(refrId, propName), updates.size());
+  if (!inserted) {
+    auto& update = updates[it->second];
+    update.value = value;
+    update.isVisibleByNeighbors = isVisibleByNeighbors;
+    return;
+  }
+  updates.push_back({ refrId, propName, value, isVisibleByNeighbors });
+}
+
+bool PropertyUpdateQueue::Empty() const noexcept
+{
+  return updates.empty();
+}
+
+std::vector<PropertyUpdateQueue::Update> PropertyUpdateQueue::Take()
+{
+  auto res = std::move(updates);
+  updates.clear();
+  updateIndexByKey.clear();
+  return res;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Property changes waiting to be sent at the end of the tick. Setting the
+// same property of the same reference again replaces the queued value, so
+// listeners only receive the last one
+class PropertyUpdateQueue
+{
+public:
+  struct Update
+  {
+    uint32_t refrId = 0;
+    std::string propName;
+    nlohmann::json value;
+
+    // false means only the reference itself (an actor) receives the update
+    bool isVisibleByNeighbors = true;
+  };
+
+  void Push(uint32_t refrId, const char* propName, const nlohmann::json& value,
+            bool isVisibleByNeighbors);
+
+  bool Empty() const noexcept;
+
+  // Returns updates in order of the first change and clears the queue
+  std::vector<Update> Take();
+
+private:
+  std::vector<Update> updates;
+  std::map<std::pair<uint32_t, std::string>, size_t> updateIndexByKey;
+};
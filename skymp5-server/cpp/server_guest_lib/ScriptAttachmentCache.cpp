@@ -0,0 +1,79 @@
+#include "ScriptAttachmentCache.h"
+
+#include "ScriptStorage.h"
+#include "papyrus-vm/Utils.h"
+#include <algorithm>
+
+std::shared_ptr<const ScriptAttachments> ScriptAttachmentCache::Get(
+  const espm::LookupResult& base,
+  espm::CompressedFieldsCache& compressedFieldsCache,
+  IScriptStorage& scriptStorage)
+{
+  if (!base.rec) {
+    return nullptr;
+  }
+
+  auto& attachments = attachmentsByRecord[base.rec];
+  if (attachments) {
+    return attachments;
+  }
+
+  espm::ScriptData scriptData;
+  base.rec->GetScriptData(&scriptData, compressedFieldsCache);
+
+  auto res = std::make_shared<ScriptAttachments>();
+  auto& scriptsInStorage = GetScriptNames(scriptStorage);
+  for (auto& script : scriptData.scripts) {
+    auto isDuplicate = [&](const std::shared_ptr<const espm::Script>& s) {
+      return !Utils::stricmp(s->scriptName.data(), script.scriptName.data());
+    };
+    if (std::any_of(res->available.begin(), res->available.end(),
+                    isDuplicate) ||
+        std::any_of(res->missing.begin(), res->missing.end(), isDuplicate)) {
+      continue;
+    }
+
+    auto& dest = scriptsInStorage.count(
+                   { script.scriptName.begin(), script.scriptName.end() })
+      ? res->available
+      : res->missing;
+    dest.push_back(std::make_shared<espm::Script>(std::move(script)));
+  }
+
+  attachments = std::move(res);
+  return attachments;
+}
+
+bool ScriptAttachmentCache::IsInStorage(const std::string& scriptName,
+                                        IScriptStorage& scriptStorage)
+{
+  return GetScriptNames(scriptStorage)
+    .count({ scriptName.begin(), scriptName.end() });
+}
+
+bool ScriptAttachmentCache::ShouldReportMissing(const std::string& scriptName)
+{
+  CIString name = { scriptName.begin(), scriptName.end() };
+  return reportedMissingScripts.insert(std::move(name)).second;
+}
+
+void ScriptAttachmentCache::ResetScriptNames()
+{
+  scriptNames.reset();
+}
+
+void ScriptAttachmentCache::Clear()
+{
+  attachmentsByRecord.clear();
+  scriptNames.reset();
+  reportedMissingScripts.clear();
+}
+
+const std::set<CIString>& ScriptAttachmentCache::GetScriptNames(
+  IScriptStorage& scriptStorage)
+{
+  if (!scriptNames) {
+    scriptNames = scriptStorage.ListScripts(false);
+  }
+  return *scriptNames;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "libespm/Combiner.h"
+#include "papyrus-vm/CIString.h"
+#include <memory>
+#include <optional>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+class IScriptStorage;
+
+// Scripts attached to a base record via VMAD, split by presence in the script
+// storage at the moment of decoding. Duplicate script names are dropped
+struct ScriptAttachments
+{
+  std::vector<std::shared_ptr<const espm::Script>> available;
+
+  // Scripts can be added to the storage at runtime, so these are checked
+  // again by the user of the cache
+  std::vector<std::shared_ptr<const espm::Script>> missing;
+};
+
+// Decodes scripts of each base record once. Records are identified by
+// address, so the cache must be cleared when plugins or scripts are reloaded
+class ScriptAttachmentCache
+{
+public:
+  // Property values may point into compressedFieldsCache, so it must outlive
+  // the returned attachments
+  std::shared_ptr<const ScriptAttachments> Get(
+    const espm::LookupResult& base,
+    espm::CompressedFieldsCache& compressedFieldsCache,
+    IScriptStorage& scriptStorage);
+
+  // Script names are listed once and kept until ResetScriptNames. Listing is
+  // not cheap, e.g. CombinedScriptStorage merges sets on each call
+  bool IsInStorage(const std::string& scriptName,
+                   IScriptStorage& scriptStorage);
+
+  // True on the first call for the script only, so that each missing script
+  // is reported once
+  bool ShouldReportMissing(const std::string& scriptName);
+
+  // Must be called when scripts are reloaded in the storage
+  void ResetScriptNames();
+
+  void Clear();
+
+private:
+  const std::set<CIString>& GetScriptNames(IScriptStorage& scriptStorage);
+
+  std::optional<std::set<CIString>> scriptNames;
+  std::set<CIString> reportedMissingScripts;
+  std::unordered_map<const espm::RecordHeader*,
+                     std::shared_ptr<const ScriptAttachments>>
+    attachmentsByRecord;
+};
@@ -11,13 +11,15 @@ ScriptVariablesHolder::ScriptVariablesHolder(
   const std::string& myScriptName_, espm::LookupResult baseRecordWithScripts_,
   espm::LookupResult refrRecordWithScripts_,
   const espm::CombineBrowser* browser_,
-  espm::CompressedFieldsCache* compressedFieldsCache_, WorldState* worldState_)
+  espm::CompressedFieldsCache* compressedFieldsCache_, WorldState* worldState_,
+  std::optional<DecodedScripts> decodedScripts_)
   : baseRecordWithScripts(baseRecordWithScripts_)
   , refrRecordWithScripts(refrRecordWithScripts_)
   , myScriptName(myScriptName_)
   , browser(browser_)
   , compressedFieldsCache(compressedFieldsCache_)
   , worldState(worldState_)
+  , decodedScripts(std::move(decodedScripts_))
 {
 }
 
@@ -50,12 +52,14 @@ VarValue* ScriptVariablesHolder::GetVariableByName(const char* name,
 
 void ScriptVariablesHolder::FillProperties()
 {
-  auto baseScript = GetScript(baseRecordWithScripts);
-  auto refrScript = GetScript(refrRecordWithScripts);
+  auto baseScript = GetScript(
+    baseRecordWithScripts, decodedScripts ? &decodedScripts->base : nullptr);
+  auto refrScript = GetScript(
+    refrRecordWithScripts, decodedScripts ? &decodedScripts->refr : nullptr);
 
   for (auto& script : { baseScript, refrScript }) {
     if (script) {
-      for (auto& prop : script->script.properties) {
+      for (auto& prop : script->script->properties) {
         VarValue out;
         CastProperty(*browser, prop, &out, scriptsCache.get(),
                      script->toGlobalId, worldState);
@@ -68,7 +72,7 @@ void ScriptVariablesHolder::FillProperties()
         if (spdlog::should_log(spdlog::level::trace)) {
           spdlog::trace(
             "FillProperties for script {}: Adding property {} with value {}",
-            script->script.scriptName, fullVarName.data(), out.ToString());
+            script->script->scriptName, fullVarName.data(), out.ToString());
         }
       }
     }
@@ -98,12 +102,24 @@ void ScriptVariablesHolder::FillState(const PexScript& pex)
 }
 
 std::optional<ScriptVariablesHolder::Script> ScriptVariablesHolder::GetScript(
-  const espm::LookupResult& lookupRes)
+  const espm::LookupResult& lookupRes,
+  const std::shared_ptr<const espm::Script>* decodedScript)
 {
   if (!lookupRes.rec) {
     return std::nullopt;
   }
 
+  auto toGlobalId = [lookupRes](uint32_t rawId) {
+    return lookupRes.ToGlobalId(rawId);
+  };
+
+  if (decodedScript) {
+    if (!*decodedScript) {
+      return std::nullopt;
+    }
+    return Script{ *decodedScript, toGlobalId };
+  }
+
   espm::ScriptData scriptData;
   lookupRes.rec->GetScriptData(&scriptData, *compressedFieldsCache);
   auto matchingScriptData = std::find_if(
@@ -113,10 +129,9 @@ std::optional<ScriptVariablesHolder::Script> ScriptVariablesHolder::GetScript(
     });
   if (matchingScriptData != scriptData.scripts.end()) {
     ScriptVariablesHolder::Script result;
-    result.script = std::move(*matchingScriptData);
-    result.toGlobalId = [lookupRes](uint32_t rawId) {
-      return lookupRes.ToGlobalId(rawId);
-    };
+    result.script =
+      std::make_shared<espm::Script>(std::move(*matchingScriptData));
+    result.toGlobalId = toGlobalId;
     return result;
   }
   return std::nullopt;
@@ -149,7 +164,7 @@ VarValue ScriptVariablesHolder::CastPrimitivePropertyValue(
             if (worldState) {
               auto& form = worldState->LookupFormById(propValueFormIdGlobal);
               if (form != nullptr) {
-                gameObject = std::make_shared<MpFormGameObject>(form.get());
+                gameObject = form->ToGameObject();
                 spdlog::trace("CastPrimitivePropertyValue - Created {} "
                               "(MpFormGameObject) property with id {:x}",
                               type.ToString(), propValueFormIdGlobal);
@@ -167,7 +182,9 @@ VarValue ScriptVariablesHolder::CastPrimitivePropertyValue(
                             type.ToString(), propValueFormIdGlobal);
             }
           } else {
-            gameObject = std::make_shared<EspmGameObject>(lookupResult);
+            gameObject = worldState
+              ? worldState->GetEspmGameObject(lookupResult)
+              : std::make_shared<EspmGameObject>(lookupResult);
             spdlog::trace("CastPrimitivePropertyValue - Created {} "
                           "(EspmGameObject) property with id {:x}",
                           type.ToString(), propValueFormIdGlobal);
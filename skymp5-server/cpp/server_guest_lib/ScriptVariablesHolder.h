@@ -3,6 +3,7 @@
 #include "papyrus-vm/CIString.h"
 #include "papyrus-vm/VirtualMachine.h"
 #include <functional>
+#include <memory>
 #include <optional>
 #include <unordered_map>
 
@@ -12,12 +13,22 @@ class WorldState;
 class ScriptVariablesHolder : public IVariablesHolder
 {
 public:
-  ScriptVariablesHolder(const std::string& myScriptName,
-                        espm::LookupResult baseRecordWithScripts,
-                        espm::LookupResult refrRecordWithScripts,
-                        const espm::CombineBrowser* browser,
-                        espm::CompressedFieldsCache* compressedFieldsCache,
-                        WorldState* worldState);
+  // Scripts already decoded by the caller. nullptr means that the record
+  // doesn't have this script attached
+  struct DecodedScripts
+  {
+    std::shared_ptr<const espm::Script> base;
+    std::shared_ptr<const espm::Script> refr;
+  };
+
+  // Scripts are decoded from records on first access if decodedScripts is
+  // not provided
+  ScriptVariablesHolder(
+    const std::string& myScriptName, espm::LookupResult baseRecordWithScripts,
+    espm::LookupResult refrRecordWithScripts,
+    const espm::CombineBrowser* browser,
+    espm::CompressedFieldsCache* compressedFieldsCache, WorldState* worldState,
+    std::optional<DecodedScripts> decodedScripts = std::nullopt);
 
   VarValue* GetVariableByName(const char* name, const PexScript& pex) override;
 
@@ -28,13 +39,15 @@ private:
 
   struct Script
   {
-    espm::Script script;
+    std::shared_ptr<const espm::Script> script;
 
     // To decode formIds for property values of Object type
     std::function<uint32_t(uint32_t rawId)> toGlobalId;
   };
 
-  std::optional<Script> GetScript(const espm::LookupResult& lookupRes);
+  std::optional<Script> GetScript(
+    const espm::LookupResult& lookupRes,
+    const std::shared_ptr<const espm::Script>* decodedScript);
 
   struct ScriptsCache
   {
@@ -64,4 +77,5 @@ private:
   std::unique_ptr<ScriptsCache> scriptsCache;
   espm::CompressedFieldsCache* const compressedFieldsCache;
   WorldState* const worldState;
+  const std::optional<DecodedScripts> decodedScripts;
 };
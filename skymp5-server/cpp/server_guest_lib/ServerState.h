@@ -1,10 +1,11 @@
 #pragma once
 #include "ActorsMap.h"
 #include "Config.h"
+#include "PacketHistory.h"
+#include "PacketHistoryRecorder.h"
 #include <Networking.h>
 #include <array>
 #include <chrono>
-#include <deque>
 #include <map>
 #include <memory>
 #include <optional>
@@ -13,22 +14,9 @@
 
 class MpActor;
 
-struct PacketHistoryElement
-{
-  size_t offset = 0;
-  size_t length = 0;
-  uint64_t timeMs = 0;
-};
-
-struct PacketHistory
-{
-  std::vector<uint8_t> buffer;
-  std::deque<PacketHistoryElement> packets;
-};
-
 struct Playback
 {
-  PacketHistory history;
+  std::shared_ptr<PacketHistoryReader> reader;
   std::chrono::time_point<std::chrono::steady_clock> startTime;
 };
 
@@ -36,8 +24,11 @@ struct UserInfo
 {
   bool isDisconnecting = false;
 
+  // Gamemode data deltas are useless for clients without the manifest
+  bool hasGamemodeDataManifest = false;
+
   bool isPacketHistoryRecording = false;
-  PacketHistory packetHistory;
+  std::unique_ptr<PacketHistoryRecorder> packetHistoryRecorder;
   std::optional<std::chrono::time_point<std::chrono::steady_clock>>
     packetHistoryStartTime;
 };
@@ -2,6 +2,8 @@
 
 #include "MpActor.h"
 #include "NetworkingInterface.h" // Format
+#include <charconv>
+#include <string>
 
 SpSnippet::SpSnippet(const char* cl_, const char* func_, const char* args_,
                      uint32_t selfId_)
@@ -18,17 +20,63 @@ Viet::Promise<VarValue> SpSnippet::Execute(MpActor* actor)
 
   auto snippetIdx = actor->NextSnippetIndex(promise);
 
-  // Player character is always 0x14 on client, but 0xff000000+ in our server
-  // See also SpSnippetFunctionGen.cpp
-  auto targetSelfId =
-    (selfId < 0xff000000 || selfId != actor->GetFormId()) ? selfId : 0x14;
-
   Networking::Format(
     [&](Networking::PacketData data, size_t len) {
       actor->SendToUser(data, len, true);
     },
     R"({"type": "spSnippet", "class": "%s", "function": "%s", "arguments": %s, "selfId": %u, "snippetIdx": %u})",
-    cl, func, args, targetSelfId, snippetIdx);
+    cl, func, args, GetTargetSelfId(actor), snippetIdx);
 
   return promise;
 }
+
+namespace {
+void AppendNumber(std::string& s, uint32_t value)
+{
+  char buf[16];
+  auto res = std::to_chars(std::begin(buf), std::end(buf), value);
+  s.append(buf, res.ptr);
+}
+}
+
+void SpSnippet::ExecuteBroadcast(
+  const std::set<MpObjectReference*>& listeners)
+{
+  // Same layout as in Execute
+  std::string packet;
+  packet += static_cast<char>(Networking::MinPacketId);
+  packet += R"({"type": "spSnippet", "class": ")";
+  packet += cl;
+  packet += R"(", "function": ")";
+  packet += func;
+  packet += R"(", "arguments": )";
+  packet += args;
+  packet += R"(, "selfId": )";
+  const auto prefixSize = packet.size();
+
+  for (auto listener : listeners) {
+    auto actor = dynamic_cast<MpActor*>(listener);
+    if (!actor) {
+      continue;
+    }
+
+    // Nobody awaits the result, so the index is reserved without a promise
+    auto snippetIdx = actor->NextSnippetIndex();
+
+    packet.resize(prefixSize);
+    AppendNumber(packet, GetTargetSelfId(actor));
+    packet += R"(, "snippetIdx": )";
+    AppendNumber(packet, snippetIdx);
+    packet += '}';
+
+    actor->SendToUser(packet.data(), packet.size(), true);
+  }
+}
+
+uint32_t SpSnippet::GetTargetSelfId(MpActor* actor) const
+{
+  // Player character is always 0x14 on client, but 0xff000000+ in our server
+  // See also SpSnippetFunctionGen.cpp
+  return (selfId < 0xff000000 || selfId != actor->GetFormId()) ? selfId
+                                                               : 0x14;
+}
@@ -3,8 +3,10 @@
 #include <cstdint>
 #include <functional>
 #include <nlohmann/json.hpp>
+#include <set>
 
 class MpActor;
+class MpObjectReference;
 
 class SpSnippet
 {
@@ -13,7 +15,14 @@ public:
             uint32_t selfId_ = 0);
   Viet::Promise<VarValue> Execute(MpActor* actor);
 
+  // Sends the snippet to every actor among listeners without waiting for the
+  // result. The payload is formatted once, only selfId and snippetIdx differ
+  // between recipients
+  void ExecuteBroadcast(const std::set<MpObjectReference*>& listeners);
+
 private:
+  uint32_t GetTargetSelfId(MpActor* actor) const;
+
   const char *const cl, *const func, *const args;
   const uint32_t selfId;
 };
@@ -0,0 +1,56 @@
+#include "UpdateScheduler.h"
+
+void UpdateScheduler::Register(uint32_t formId, Clock::time_point due,
+                               Clock::duration interval)
+{
+  Unregister(formId);
+  auto it = queue.emplace(due, formId);
+  registrations[formId] = { it, interval };
+}
+
+void UpdateScheduler::Unregister(uint32_t formId)
+{
+  auto it = registrations.find(formId);
+  if (it != registrations.end()) {
+    queue.erase(it->second.it);
+    registrations.erase(it);
+  }
+}
+
+bool UpdateScheduler::IsRegistered(uint32_t formId) const
+{
+  return registrations.count(formId) > 0;
+}
+
+size_t UpdateScheduler::GetSize() const noexcept
+{
+  return registrations.size();
+}
+
+std::vector<UpdateScheduler::DueUpdate> UpdateScheduler::PopDue(
+  Clock::time_point now, size_t maxCount)
+{
+  std::vector<DueUpdate> res;
+
+  while (!queue.empty() && queue.begin()->first <= now &&
+         (maxCount == 0 || res.size() < maxCount)) {
+    auto [due, formId] = *queue.begin();
+    queue.erase(queue.begin());
+
+    auto registrationIt = registrations.find(formId);
+    auto interval = registrationIt->second.interval;
+    if (interval <= Clock::duration::zero()) {
+      registrations.erase(registrationIt);
+      res.push_back({ formId, false });
+      continue;
+    }
+
+    // Missed intervals are not caught up. The next due time is after 'now',
+    // so the form can't be due twice in one call
+    auto numIntervals = (now - due) / interval + 1;
+    registrationIt->second.it =
+      queue.emplace(due + interval * numIntervals, formId);
+    res.push_back({ formId, true });
+  }
+  return res;
+}
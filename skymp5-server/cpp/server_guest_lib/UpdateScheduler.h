@@ -0,0 +1,46 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+// Papyrus OnUpdate registrations (RegisterForSingleUpdate/RegisterForUpdate)
+// ordered by due time. A form has at most one registration: registering
+// again replaces the previous one, like in Skyrim
+class UpdateScheduler
+{
+public:
+  using Clock = std::chrono::system_clock;
+
+  struct DueUpdate
+  {
+    uint32_t formId = 0;
+    bool isRepeating = false;
+  };
+
+  // Zero interval means a single update
+  void Register(uint32_t formId, Clock::time_point due,
+                Clock::duration interval = Clock::duration::zero());
+  void Unregister(uint32_t formId);
+
+  bool IsRegistered(uint32_t formId) const;
+  size_t GetSize() const noexcept;
+
+  // Returns up to maxCount (0 means no limit) updates due at 'now' in order
+  // of due time. Single registrations are removed, repeating ones are moved
+  // to the next interval after 'now'. Updates over the limit stay due
+  std::vector<DueUpdate> PopDue(Clock::time_point now, size_t maxCount = 0);
+
+private:
+  using Queue = std::multimap<Clock::time_point, uint32_t>;
+
+  struct Registration
+  {
+    Queue::iterator it;
+    Clock::duration interval{};
+  };
+
+  Queue queue;
+  std::unordered_map<uint32_t, Registration> registrations;
+};
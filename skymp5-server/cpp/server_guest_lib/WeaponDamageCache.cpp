@@ -0,0 +1,27 @@
+#include "WeaponDamageCache.h"
+
+const WeaponDamageCache::Entry& WeaponDamageCache::Get(
+  uint32_t baseId, const espm::CombineBrowser& browser,
+  espm::CompressedFieldsCache& compressedFieldsCache)
+{
+  auto [it, inserted] = entryByBaseId.try_emplace(baseId);
+  if (!inserted) {
+    return it->second;
+  }
+
+  auto& entry = it->second;
+  auto lookupRes = browser.LookupById(baseId);
+  entry.exists = lookupRes.rec != nullptr;
+  if (auto weap = espm::Convert<espm::WEAP>(lookupRes.rec)) {
+    entry.isWeapon = true;
+    if (auto weapData = weap->GetData(compressedFieldsCache).weapData) {
+      entry.damage = weapData->damage;
+    }
+  }
+  return entry;
+}
+
+void WeaponDamageCache::Clear()
+{
+  entryByBaseId.clear();
+}
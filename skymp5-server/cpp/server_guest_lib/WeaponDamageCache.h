@@ -0,0 +1,26 @@
+#pragma once
+#include "libespm/Combiner.h"
+#include <cstdint>
+#include <unordered_map>
+
+// Remembers record type and WEAP damage for base forms, so that picking the
+// best weapon doesn't look up and decode records again. Keyed by global form
+// id, so the cache must be cleared when plugins are reloaded
+class WeaponDamageCache
+{
+public:
+  struct Entry
+  {
+    bool exists = false;
+    bool isWeapon = false;
+    int16_t damage = 0;
+  };
+
+  const Entry& Get(uint32_t baseId, const espm::CombineBrowser& browser,
+                   espm::CompressedFieldsCache& compressedFieldsCache);
+
+  void Clear();
+
+private:
+  std::unordered_map<uint32_t, Entry> entryByBaseId;
+};
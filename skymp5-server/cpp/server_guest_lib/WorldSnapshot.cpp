@@ -0,0 +1,139 @@
+#include "WorldSnapshot.h"
+#include <simdjson.h>
+#include <stdexcept>
+#include <string>
+#include <zlib.h>
+
+namespace {
+std::filesystem::path GetTemporaryPath(const std::filesystem::path& path)
+{
+  auto res = path;
+  res += ".tmp";
+  return res;
+}
+}
+
+struct WorldSnapshotWriter::Impl
+{
+  std::filesystem::path path;
+  gzFile file = nullptr;
+  std::string line;
+  size_t numWritten = 0;
+};
+
+WorldSnapshotWriter::WorldSnapshotWriter(const std::filesystem::path& path)
+  : pImpl(std::make_unique<Impl>())
+{
+  pImpl->path = path;
+
+  if (path.has_parent_path()) {
+    std::filesystem::create_directories(path.parent_path());
+  }
+
+  auto tmpPath = GetTemporaryPath(path).string();
+  pImpl->file = gzopen(tmpPath.data(), "wb");
+  if (!pImpl->file) {
+    throw std::runtime_error("Unable to open " + tmpPath);
+  }
+}
+
+WorldSnapshotWriter::~WorldSnapshotWriter()
+{
+  if (pImpl->file) {
+    gzclose(pImpl->file);
+    std::error_code ec;
+    std::filesystem::remove(GetTemporaryPath(pImpl->path), ec);
+  }
+}
+
+void WorldSnapshotWriter::Write(const MpChangeForm& changeForm)
+{
+  if (!pImpl->file) {
+    throw std::runtime_error("Snapshot is already finished");
+  }
+
+  pImpl->line = MpChangeForm::ToJson(changeForm).dump();
+  pImpl->line += '\n';
+
+  auto size = static_cast<unsigned>(pImpl->line.size());
+  int res = gzwrite(pImpl->file, pImpl->line.data(), size);
+  if (res != static_cast<int>(size)) {
+    int errnum = 0;
+    throw std::runtime_error(std::string("gzwrite failed: ") +
+                             gzerror(pImpl->file, &errnum));
+  }
+  ++pImpl->numWritten;
+}
+
+void WorldSnapshotWriter::Finish()
+{
+  if (!pImpl->file) {
+    throw std::runtime_error("Snapshot is already finished");
+  }
+
+  int res = gzclose(pImpl->file);
+  pImpl->file = nullptr;
+
+  auto tmpPath = GetTemporaryPath(pImpl->path);
+  if (res != Z_OK) {
+    std::error_code ec;
+    std::filesystem::remove(tmpPath, ec);
+    throw std::runtime_error("gzclose failed with code " +
+                             std::to_string(res));
+  }
+
+  std::filesystem::rename(tmpPath, pImpl->path);
+}
+
+size_t WorldSnapshotWriter::GetNumWritten() const
+{
+  return pImpl->numWritten;
+}
+
+size_t WorldSnapshotUtils::Read(const std::filesystem::path& path,
+                                const ReadCallback& cb)
+{
+  gzFile file = gzopen(path.string().data(), "rb");
+  if (!file) {
+    throw std::runtime_error("Unable to open " + path.string());
+  }
+
+  std::unique_ptr<gzFile_s, int (*)(gzFile)> guard(file, gzclose);
+
+  simdjson::dom::parser parser;
+  std::string line;
+  size_t numRead = 0;
+  char buf[64 * 1024];
+
+  auto flushLine = [&] {
+    if (line.empty()) {
+      return;
+    }
+    auto element = parser.parse(line).value();
+    cb(MpChangeForm::JsonToChangeForm(element));
+    ++numRead;
+    line.clear();
+  };
+
+  while (true) {
+    int n = gzread(file, buf, sizeof(buf));
+    if (n < 0) {
+      int errnum = 0;
+      throw std::runtime_error(std::string("gzread failed: ") +
+                               gzerror(file, &errnum));
+    }
+    if (n == 0) {
+      break;
+    }
+    for (int i = 0; i < n; ++i) {
+      if (buf[i] == '\n') {
+        flushLine();
+      } else {
+        line += buf[i];
+      }
+    }
+  }
+  flushLine();
+
+  return numRead;
+}
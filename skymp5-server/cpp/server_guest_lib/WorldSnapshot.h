@@ -0,0 +1,36 @@
+#pragma once
+#include "MpChangeForms.h"
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+
+// Snapshot archive is a gzip stream with one ChangeForm JSON per line, so it
+// can also be inspected with zcat
+class WorldSnapshotWriter
+{
+public:
+  // Writes to a temporary file next to path. The file is renamed to path in
+  // Finish, so an interrupted snapshot never replaces the previous one
+  explicit WorldSnapshotWriter(const std::filesystem::path& path);
+  ~WorldSnapshotWriter();
+
+  WorldSnapshotWriter(const WorldSnapshotWriter&) = delete;
+  WorldSnapshotWriter& operator=(const WorldSnapshotWriter&) = delete;
+
+  void Write(const MpChangeForm& changeForm);
+  void Finish();
+
+  size_t GetNumWritten() const;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> pImpl;
+};
+
+namespace WorldSnapshotUtils {
+using ReadCallback = std::function<void(const MpChangeForm&)>;
+
+// Returns the number of change forms read
+size_t Read(const std::filesystem::path& path, const ReadCallback& cb);
+}
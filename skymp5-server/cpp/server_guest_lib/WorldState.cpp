@@ -1,5 +1,8 @@
 #include "WorldState.h"
+#include "EditorIdIndex.h"
+#include "EspmGameObject.h"
 #include "FormCallbacks.h"
+#include "FormListCache.h"
 #include "HeuristicPolicy.h"
 #include "ISaveStorage.h"
 #include "MpActor.h"
@@ -18,12 +21,17 @@
 #include "PapyrusSkymp.h"
 #include "PapyrusUtility.h"
 #include "ScopedTask.h"
+#include "ScriptAttachmentCache.h"
 #include "ScriptStorage.h"
 #include "Timer.h"
+#include "UpdateScheduler.h"
+#include "WeaponDamageCache.h"
+#include "WorldSnapshot.h"
 #include "libespm/GroupUtils.h"
 #include "papyrus-vm/Reader.h"
 #include <algorithm>
 #include <deque>
+#include <set>
 #include <unordered_map>
 
 namespace {
@@ -39,11 +47,35 @@ inline NiPoint3 GetRot(const espm::REFR::LocationalData* locationalData)
            locationalData->rotRadians[1] / g_pi * 180.f,
            locationalData->rotRadians[2] / g_pi * 180.f };
 }
+
+struct SnapshotState
+{
+  std::unique_ptr<WorldSnapshotWriter> writer;
+  std::vector<std::shared_ptr<const MpChangeForm>> pendingChangeForms;
+  std::set<FormDesc> pendingFormDescs;
+  bool pendingWritten = false;
+
+  // Pending change forms are newer than their saved versions, so they are
+  // written first and saved versions of the same forms are skipped
+  void WritePendingOnce()
+  {
+    if (pendingWritten) {
+      return;
+    }
+    pendingWritten = true;
+    for (auto& changeForm : pendingChangeForms) {
+      pendingFormDescs.insert(changeForm->formDesc);
+      writer->Write(*changeForm);
+    }
+    pendingChangeForms.clear();
+  }
+};
 }
 
 struct WorldState::Impl
 {
-  std::unordered_map<uint32_t, MpChangeForm> changes;
+  // Change forms are immutable once stored here, so snapshots may share them
+  std::unordered_map<uint32_t, std::shared_ptr<const MpChangeForm>> changes;
   std::shared_ptr<ISaveStorage> saveStorage;
   std::shared_ptr<IScriptStorage> scriptStorage;
   bool saveStorageBusy = false;
@@ -57,6 +89,15 @@ struct WorldState::Impl
     relootTimeForTypes;
   std::vector<std::unique_ptr<IPapyrusClassBase>> classes;
   Viet::Timer timer;
+  UpdateScheduler updateScheduler;
+  std::unordered_map<std::string, std::unique_ptr<EditorIdIndex>>
+    editorIdIndexes;
+  FormListCache formListCache;
+  ScriptAttachmentCache scriptAttachmentCache;
+  WeaponDamageCache weaponDamageCache;
+  std::unordered_map<const espm::RecordHeader*,
+                     std::shared_ptr<EspmGameObject>>
+    espmGameObjects;
 };
 
 WorldState::WorldState()
@@ -81,6 +122,11 @@ void WorldState::AttachEspm(espm::Loader* espm_,
   formCallbacksFactory = formCallbacksFactory_;
   espmCache.reset(new espm::CompressedFieldsCache);
   espmFiles = espm->GetFileNames();
+  pImpl->editorIdIndexes.clear();
+  pImpl->formListCache.Clear();
+  pImpl->scriptAttachmentCache.Clear();
+  pImpl->weaponDamageCache.Clear();
+  pImpl->espmGameObjects.clear();
 }
 
 void WorldState::AttachSaveStorage(std::shared_ptr<ISaveStorage> saveStorage)
@@ -92,6 +138,7 @@ void WorldState::AttachScriptStorage(
   std::shared_ptr<IScriptStorage> scriptStorage)
 {
   pImpl->scriptStorage = scriptStorage;
+  pImpl->scriptAttachmentCache.Clear();
 }
 
 void WorldState::AddForm(std::unique_ptr<MpForm> form, uint32_t formId,
@@ -138,6 +185,8 @@ void WorldState::Tick()
   TickReloot(now);
   TickSaveStorage(now);
   TickTimers(now);
+  TickUpdates(now);
+  MpObjectReference::FlushPropertyUpdates(this);
 }
 
 void WorldState::LoadChangeForm(const MpChangeForm& changeForm,
@@ -207,23 +256,120 @@ void WorldState::LoadChangeForm(const MpChangeForm& changeForm,
 void WorldState::RequestReloot(MpObjectReference& ref,
                                std::chrono::system_clock::duration time)
 {
-  auto& list = relootTimers[time];
-  list.push_back({ ref.GetFormId(), std::chrono::system_clock::now() + time });
+  relootQueue.emplace(std::chrono::system_clock::now() + time,
+                      ref.GetFormId());
+}
+
+size_t WorldState::GetNumPendingReloots() const noexcept
+{
+  return relootQueue.size();
 }
 
 void WorldState::RequestSave(MpObjectReference& ref)
 {
   if (!pImpl->formLoadingInProgress) {
-    pImpl->changes[ref.GetFormId()] = ref.GetChangeForm();
+    pImpl->changes[ref.GetFormId()] =
+      std::make_shared<MpChangeForm>(ref.GetChangeForm());
+  }
+}
+
+void WorldState::CancelSave(uint32_t formId)
+{
+  pImpl->changes.erase(formId);
+}
+
+Viet::Promise<size_t> WorldState::CreateSnapshot(
+  const std::filesystem::path& path)
+{
+  if (!pImpl->saveStorage) {
+    throw std::runtime_error("CreateSnapshot requires save storage");
+  }
+
+  auto was = std::chrono::steady_clock::now();
+
+  auto state = std::make_shared<SnapshotState>();
+  state->writer = std::make_unique<WorldSnapshotWriter>(path);
+  state->pendingChangeForms.reserve(pImpl->changes.size());
+  for (auto& [formId, changeForm] : pImpl->changes) {
+    state->pendingChangeForms.push_back(changeForm);
+  }
+  const size_t numPending = state->pendingChangeForms.size();
+
+  // Change forms already passed to Upsert are not in 'changes' anymore.
+  // IterateAsync runs after these upserts, so they are seen as saved
+  Viet::Promise<size_t> promise;
+  pImpl->saveStorage->IterateAsync(
+    [state](const MpChangeForm& changeForm) {
+      state->WritePendingOnce();
+      if (!state->pendingFormDescs.count(changeForm.formDesc)) {
+        state->writer->Write(changeForm);
+      }
+    },
+    [state, promise, path, logger = logger](std::exception_ptr exception) {
+      try {
+        if (exception) {
+          std::rethrow_exception(exception);
+        }
+        state->WritePendingOnce();
+        state->writer->Finish();
+      } catch (std::exception& e) {
+        state->writer.reset();
+        promise.Reject(e.what());
+        return;
+      }
+      if (logger) {
+        logger->info("Snapshot {} contains {} ChangeForms", path.string(),
+                     state->writer->GetNumWritten());
+      }
+      promise.Resolve(state->writer->GetNumWritten());
+    });
+
+  if (logger) {
+    auto pause = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - was);
+    logger->info("Snapshot {} requested, {} pending ChangeForms copied in {} "
+                 "us",
+                 path.string(), numPending, pause.count());
   }
+
+  return promise;
+}
+
+namespace {
+UpdateScheduler::Clock::duration SecondsToDuration(float seconds)
+{
+  return std::chrono::duration_cast<UpdateScheduler::Clock::duration>(
+    std::chrono::duration<float>(std::max(seconds, 0.f)));
+}
 }
 
 void WorldState::RegisterForSingleUpdate(const VarValue& self, float seconds)
 {
-  SetTimer(seconds).Then([self](Viet::Void) {
-    if (auto form = GetFormPtr<MpForm>(self))
-      form->Update();
-  });
+  if (auto form = GetFormPtr<MpForm>(self)) {
+    pImpl->updateScheduler.Register(
+      form->GetFormId(),
+      UpdateScheduler::Clock::now() + SecondsToDuration(seconds));
+  }
+}
+
+void WorldState::RegisterForUpdate(const VarValue& self, float seconds)
+{
+  if (auto form = GetFormPtr<MpForm>(self)) {
+    auto interval = SecondsToDuration(seconds);
+    if (interval <= UpdateScheduler::Clock::duration::zero()) {
+      // Skyrim ignores non-positive intervals as well
+      return;
+    }
+    pImpl->updateScheduler.Register(
+      form->GetFormId(), UpdateScheduler::Clock::now() + interval, interval);
+  }
+}
+
+void WorldState::UnregisterForUpdate(const VarValue& self)
+{
+  if (auto form = GetFormPtr<MpForm>(self)) {
+    pImpl->updateScheduler.Unregister(form->GetFormId());
+  }
 }
 
 Viet::Promise<Viet::Void> WorldState::SetTimer(float seconds)
@@ -368,17 +514,17 @@ bool WorldState::LoadForm(uint32_t formId)
 
 void WorldState::TickReloot(const std::chrono::system_clock::time_point& now)
 {
-  for (auto& p : relootTimers) {
-    auto& list = p.second;
-    while (!list.empty() && list.begin()->second <= now) {
-      uint32_t relootTargetId = list.begin()->first;
-      auto relootTarget = std::dynamic_pointer_cast<MpObjectReference>(
-        LookupFormById(relootTargetId));
-      if (relootTarget) {
-        relootTarget->DoReloot();
-      }
-
-      list.pop_front();
+  size_t numProcessed = 0;
+  while (!relootQueue.empty() && relootQueue.begin()->first <= now &&
+         numProcessed < maxRelootsPerTick) {
+    uint32_t relootTargetId = relootQueue.begin()->second;
+    relootQueue.erase(relootQueue.begin());
+    ++numProcessed;
+
+    auto relootTarget = std::dynamic_pointer_cast<MpObjectReference>(
+      LookupFormById(relootTargetId));
+    if (relootTarget) {
+      relootTarget->DoReloot();
     }
   }
 }
@@ -396,8 +542,8 @@ void WorldState::TickSaveStorage(const std::chrono::system_clock::time_point&)
     pImpl->saveStorageBusy = true;
     std::vector<MpChangeForm> changeForms;
     changeForms.reserve(changes.size());
-    for (auto [formId, changeForm] : changes) {
-      changeForms.push_back(changeForm);
+    for (auto& [formId, changeForm] : changes) {
+      changeForms.push_back(*changeForm);
     }
     changes.clear();
 
@@ -412,55 +558,202 @@ void WorldState::TickTimers(const std::chrono::system_clock::time_point&)
   pImpl->timer.TickTimers();
 }
 
-void WorldState::SendPapyrusEvent(MpForm* form, const char* eventName,
+void WorldState::TickUpdates(const std::chrono::system_clock::time_point& now)
+{
+  // Objects in chunks nobody has visited yet wait for them, retrying this
+  // often. Repeating updates just skip the interval
+  constexpr auto kUnloadedRetryDelay = std::chrono::seconds(1);
+
+  auto& scheduler = pImpl->updateScheduler;
+
+  // Only updates actually sent count against the limit, skipped ones don't
+  // take turns of the others
+  const size_t maxCount = maxPapyrusUpdatesPerTick;
+  size_t numUpdated = 0;
+  while (maxCount == 0 || numUpdated < maxCount) {
+    auto dueUpdates =
+      scheduler.PopDue(now, maxCount == 0 ? 0 : maxCount - numUpdated);
+    if (dueUpdates.empty()) {
+      break;
+    }
+
+    for (auto& dueUpdate : dueUpdates) {
+      // Lookup without loading: registrations of destroyed forms are dropped
+      auto it = forms.find(dueUpdate.formId);
+      if (it == forms.end()) {
+        scheduler.Unregister(dueUpdate.formId);
+        continue;
+      }
+      auto& form = it->second;
+
+      if (auto refr = dynamic_cast<MpObjectReference*>(form.get())) {
+        auto cellOrWorld = refr->GetCellOrWorld().ToFormId(espmFiles);
+        if (!IsChunkLoadedAt(cellOrWorld, refr->GetPos())) {
+          if (!dueUpdate.isRepeating) {
+            scheduler.Register(dueUpdate.formId, now + kUnloadedRetryDelay);
+          }
+          continue;
+        }
+      }
+
+      ++numUpdated;
+      try {
+        form->Update();
+      } catch (std::exception& e) {
+        logger->error("OnUpdate of {:#x} failed: {}", dueUpdate.formId,
+                      e.what());
+      }
+    }
+
+    // Without a limit everything due was popped at once
+    if (maxCount == 0) {
+      break;
+    }
+  }
+}
+
+void WorldState::SendPapyrusEvent(MpForm* form, EventId eventId,
                                   const VarValue* arguments,
                                   size_t argumentsCount)
 {
+  auto& vm = GetPapyrusVm();
+  auto internedName = vm.GetEventNames().GetName(eventId);
+
   VirtualMachine::OnEnter onEnter = [&](const StackIdHolder& holder) {
-    pImpl->policy->BeforeSendPapyrusEvent(form, eventName, arguments,
-                                          argumentsCount, holder.GetStackId());
+    pImpl->policy->BeforeSendPapyrusEvent(form, eventId, internedName,
+                                          arguments, argumentsCount,
+                                          holder.GetStackId());
   };
-  auto& vm = GetPapyrusVm();
   std::vector<VarValue> args = { arguments, arguments + argumentsCount };
-  return vm.SendEvent(form->ToGameObject(), eventName, args, onEnter);
+  return vm.SendEvent(form->ToGameObject(), eventId, args, onEnter);
 }
 
 const std::set<MpObjectReference*>& WorldState::GetReferencesAtPosition(
   uint32_t cellOrWorld, int16_t cellX, int16_t cellY)
 {
-  if (espm && !pImpl->chunkLoadingInProgress) {
-    Viet::ScopedTask<bool> task([](bool& st) { st = false; },
-                                pImpl->chunkLoadingInProgress);
-    pImpl->chunkLoadingInProgress = true;
-
-    auto& br = espm->GetBrowser();
-    for (int16_t x = cellX - 1; x <= cellX + 1; ++x) {
-      for (int16_t y = cellY - 1; y <= cellY + 1; ++y) {
-        const bool loaded = grids[cellOrWorld].loadedChunks[x][y];
-        if (!loaded) {
-          for (size_t i = 0; i < espmFiles.size(); ++i) {
-            auto combMapping = br.GetCombMapping(i);
-            auto rawMapping = br.GetRawMapping(i);
-            uint32_t mappedCellOrWorld =
-              espm::GetMappedId(cellOrWorld, *rawMapping);
-            auto records = br.GetRecordsAtPos(mappedCellOrWorld, x, y);
-            for (auto rec : *records[i]) {
-              auto mappedId = espm::GetMappedId(rec->GetId(), *combMapping);
-              assert(mappedId < 0xff000000);
-              LoadForm(mappedId);
-            }
+  LoadChunks(cellOrWorld, cellX - 1, cellX + 1, cellY - 1, cellY + 1);
+
+  auto& neighbours =
+    grids[cellOrWorld].grid->GetNeighboursByPosition(cellX, cellY);
+  return neighbours;
+}
+
+namespace {
+// Same rounding as grid positions of references use
+int16_t GetCellCoordinate(double coordinate)
+{
+  constexpr double kMin = std::numeric_limits<int16_t>::min(),
+                   kMax = std::numeric_limits<int16_t>::max();
+  return int16_t(std::clamp(coordinate / 4096, kMin, kMax));
+}
+}
+
+bool WorldState::IsChunkLoadedAt(uint32_t cellOrWorld,
+                                 const NiPoint3& pos) const
+{
+  // Without espm there is nothing to load
+  if (!espm) {
+    return true;
+  }
+
+  auto gridIt = grids.find(cellOrWorld);
+  if (gridIt == grids.end()) {
+    return false;
+  }
+  auto& loadedChunks = gridIt->second.loadedChunks;
+  auto xIt = loadedChunks.find(GetCellCoordinate(pos.x));
+  if (xIt == loadedChunks.end()) {
+    return false;
+  }
+  auto yIt = xIt->second.find(GetCellCoordinate(pos.y));
+  return yIt != xIt->second.end() && yIt->second;
+}
+
+void WorldState::PreloadChunksAt(uint32_t cellOrWorld, const NiPoint3& pos)
+{
+  const int16_t cellX = GetCellCoordinate(pos.x),
+                cellY = GetCellCoordinate(pos.y);
+  LoadChunks(cellOrWorld, cellX - 1, cellX + 1, cellY - 1, cellY + 1);
+}
+
+std::vector<MpObjectReference*> WorldState::FindReferencesInRadius(
+  uint32_t cellOrWorld, const NiPoint3& pos, float radius,
+  const ReferenceFilter& filter)
+{
+  std::vector<MpObjectReference*> res;
+  if (!(radius >= 0)) {
+    return res;
+  }
+
+  const int16_t minX = GetCellCoordinate(double(pos.x) - radius),
+                maxX = GetCellCoordinate(double(pos.x) + radius),
+                minY = GetCellCoordinate(double(pos.y) - radius),
+                maxY = GetCellCoordinate(double(pos.y) + radius);
+
+  const int16_t cellX = GetCellCoordinate(pos.x),
+                cellY = GetCellCoordinate(pos.y);
+  constexpr int16_t kLimit = kMaxChunksLoadedByRadiusQuery;
+  LoadChunks(cellOrWorld, std::max<int>(minX, cellX - kLimit),
+             std::min<int>(maxX, cellX + kLimit),
+             std::max<int>(minY, cellY - kLimit),
+             std::min<int>(maxY, cellY + kLimit));
+
+  auto gridIterator = grids.find(cellOrWorld);
+  if (gridIterator == grids.end()) {
+    return res;
+  }
+
+  const float radiusSquared = radius * radius;
+  gridIterator->second.grid->VisitObjectsInCells(
+    minX, maxX, minY, maxY, [&](MpObjectReference* refr) {
+      auto& refrPos = refr->GetPos();
+      const float dx = refrPos.x - pos.x, dy = refrPos.y - pos.y,
+                  dz = refrPos.z - pos.z;
+      if (dx * dx + dy * dy + dz * dz > radiusSquared) {
+        return;
+      }
+      if (filter && !filter(*refr)) {
+        return;
+      }
+      res.push_back(refr);
+    });
+  return res;
+}
+
+void WorldState::LoadChunks(uint32_t cellOrWorld, int16_t minX, int16_t maxX,
+                            int16_t minY, int16_t maxY)
+{
+  if (!espm || pImpl->chunkLoadingInProgress) {
+    return;
+  }
+
+  Viet::ScopedTask<bool> task([](bool& st) { st = false; },
+                              pImpl->chunkLoadingInProgress);
+  pImpl->chunkLoadingInProgress = true;
+
+  auto& br = espm->GetBrowser();
+  for (int32_t x = minX; x <= maxX; ++x) {
+    for (int32_t y = minY; y <= maxY; ++y) {
+      const bool loaded = grids[cellOrWorld].loadedChunks[x][y];
+      if (!loaded) {
+        for (size_t i = 0; i < espmFiles.size(); ++i) {
+          auto combMapping = br.GetCombMapping(i);
+          auto rawMapping = br.GetRawMapping(i);
+          uint32_t mappedCellOrWorld =
+            espm::GetMappedId(cellOrWorld, *rawMapping);
+          auto records = br.GetRecordsAtPos(mappedCellOrWorld, x, y);
+          for (auto rec : *records[i]) {
+            auto mappedId = espm::GetMappedId(rec->GetId(), *combMapping);
+            assert(mappedId < 0xff000000);
+            LoadForm(mappedId);
           }
-          // Do not keep "loaded" reference here since LoadForm would
-          // invalidate this reference
-          grids[cellOrWorld].loadedChunks[x][y] = true;
         }
+        // Do not keep "loaded" reference here since LoadForm would
+        // invalidate this reference
+        grids[cellOrWorld].loadedChunks[x][y] = true;
       }
     }
   }
-
-  auto& neighbours =
-    grids[cellOrWorld].grid->GetNeighboursByPosition(cellX, cellY);
-  return neighbours;
 }
 
 MpForm* WorldState::LookupFormByIdx(int idx)
@@ -498,6 +791,41 @@ espm::CompressedFieldsCache& WorldState::GetEspmCache()
   return *espmCache;
 }
 
+const EditorIdIndex& WorldState::GetEditorIdIndex(const char* recordType)
+{
+  auto& index = pImpl->editorIdIndexes[recordType];
+  if (!index) {
+    index = std::make_unique<EditorIdIndex>(GetEspm().GetBrowser(),
+                                            GetEspmCache(), recordType);
+  }
+  return *index;
+}
+
+FormListCache& WorldState::GetFormListCache()
+{
+  return pImpl->formListCache;
+}
+
+ScriptAttachmentCache& WorldState::GetScriptAttachmentCache()
+{
+  return pImpl->scriptAttachmentCache;
+}
+
+WeaponDamageCache& WorldState::GetWeaponDamageCache()
+{
+  return pImpl->weaponDamageCache;
+}
+
+const std::shared_ptr<EspmGameObject>& WorldState::GetEspmGameObject(
+  const espm::LookupResult& record)
+{
+  auto& gameObject = pImpl->espmGameObjects[record.rec];
+  if (!gameObject) {
+    gameObject = std::make_shared<EspmGameObject>(record);
+  }
+  return gameObject;
+}
+
 IScriptStorage* WorldState::GetScriptStorage() const
 {
   return pImpl->scriptStorage.get();
@@ -579,7 +907,9 @@ VirtualMachine& WorldState::GetPapyrusVm()
           std::optional<PexScript::Lazy> result;
 
           CIString classNameCi = { className.begin(), className.end() };
-          if (scriptStorage->ListScripts(true).count(classNameCi)) {
+          auto& scripts = scriptStorage->ListScripts(true);
+          pImpl->scriptAttachmentCache.ResetScriptNames();
+          if (scripts.count(classNameCi)) {
             result =
               CreatePexScriptLazy(classNameCi, scriptStorage, this->logger,
                                   this->isPapyrusHotReloadEnabled);
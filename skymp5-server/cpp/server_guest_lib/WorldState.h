@@ -5,13 +5,16 @@
 #include "MpChangeForms.h"
 #include "MpForm.h"
 #include "MpObjectReference.h"
+#include "NeighborEvents.h"
 #include "NiPoint3.h"
 #include "PartOneListener.h"
+#include "PropertyUpdateQueue.h"
 #include "libespm/Loader.h"
 #include "papyrus-vm/VirtualMachine.h"
 #include <MakeID.h-1.0.2>
 #include <algorithm>
 #include <chrono>
+#include <filesystem>
 #include <functional>
 #include <list>
 #include <map>
@@ -29,6 +32,11 @@ class MpActor;
 class FormCallbacks;
 class MpChangeForm;
 class ISaveStorage;
+class EditorIdIndex;
+class EspmGameObject;
+class FormListCache;
+class ScriptAttachmentCache;
+class WeaponDamageCache;
 class IScriptStorage;
 
 class WorldState
@@ -62,9 +70,24 @@ public:
   void RequestReloot(MpObjectReference& ref,
                      std::chrono::system_clock::duration time);
 
+  size_t GetNumPendingReloots() const noexcept;
+
   void RequestSave(MpObjectReference& ref);
 
+  // Drops the change form requested by RequestSave if it hasn't been passed
+  // to the save storage yet
+  void CancelSave(uint32_t formId);
+
+  // Writes a consistent cut of all saved and pending change forms to a
+  // compressed archive (see WorldSnapshot.h). The main thread only copies
+  // pointers to pending change forms, the archive is written by the save
+  // storage thread. Resolves with the number of change forms written
+  Viet::Promise<size_t> CreateSnapshot(const std::filesystem::path& path);
+
+  // OnUpdate registrations of forms, see UpdateScheduler
   void RegisterForSingleUpdate(const VarValue& self, float seconds);
+  void RegisterForUpdate(const VarValue& self, float seconds);
+  void UnregisterForUpdate(const VarValue& self);
 
   Viet::Promise<Viet::Void> SetTimer(float seconds);
 
@@ -72,12 +95,28 @@ public:
 
   MpForm* LookupFormByIdx(int idx);
 
-  void SendPapyrusEvent(MpForm* form, const char* eventName,
+  void SendPapyrusEvent(MpForm* form, EventId eventId,
                         const VarValue* arguments, size_t argumentsCount);
 
   const std::set<MpObjectReference*>& GetReferencesAtPosition(
     uint32_t cellOrWorld, int16_t cellX, int16_t cellY);
 
+  // Loads chunks from espm that a reference at pos subscribes to, so that
+  // placing it there later doesn't have to
+  void PreloadChunksAt(uint32_t cellOrWorld, const NiPoint3& pos);
+
+  using ReferenceFilter = std::function<bool(const MpObjectReference&)>;
+
+  // Returns references in cellOrWorld no farther than radius from pos. Only
+  // cells covered by the radius are scanned. Chunks are loaded from espm up
+  // to kMaxChunksLoadedByRadiusQuery cells away from pos. If filter is set,
+  // only references it accepts are returned
+  std::vector<MpObjectReference*> FindReferencesInRadius(
+    uint32_t cellOrWorld, const NiPoint3& pos, float radius,
+    const ReferenceFilter& filter = nullptr);
+
+  static constexpr int16_t kMaxChunksLoadedByRadiusQuery = 4;
+
   template <class F>
   F& GetFormAt(uint32_t formId)
   {
@@ -146,6 +185,24 @@ public:
   espm::Loader& GetEspm() const;
   bool HasEspm() const;
   espm::CompressedFieldsCache& GetEspmCache();
+
+  // Built on first use for each record type and kept until espm is reattached
+  const EditorIdIndex& GetEditorIdIndex(const char* recordType);
+
+  // Cleared when espm is reattached
+  FormListCache& GetFormListCache();
+
+  // Cleared when espm or script storage is reattached
+  ScriptAttachmentCache& GetScriptAttachmentCache();
+
+  // Cleared when espm is reattached
+  WeaponDamageCache& GetWeaponDamageCache();
+
+  // Returns the wrapper shared by all Papyrus values referencing the record.
+  // Forms have their own shared wrapper, see MpForm::ToGameObject. Cleared
+  // when espm is reattached
+  const std::shared_ptr<EspmGameObject>& GetEspmGameObject(
+    const espm::LookupResult& record);
   IScriptStorage* GetScriptStorage() const;
   VirtualMachine& GetPapyrusVm();
   const std::set<uint32_t>& GetActorsByProfileId(int32_t profileId) const;
@@ -169,6 +226,23 @@ public:
 
   bool isPapyrusHotReloadEnabled = false;
 
+  // Reloots that are due but exceed the limit are postponed to next ticks
+  size_t maxRelootsPerTick = 256;
+
+  // OnUpdate events that are due but exceed the limit are sent during next
+  // ticks. 0 means no limit
+  size_t maxPapyrusUpdatesPerTick = 0;
+
+  // Filled by Subscribe/Unsubscribe and PartOne only while enabled, the
+  // consumer is expected to Take() events every tick
+  bool neighborEventsEnabled = false;
+  NeighborEvents neighborEvents;
+
+  // Property updates are queued and sent once at the end of Tick, grouped
+  // per listener
+  bool deferPropertyBroadcasts = false;
+  PropertyUpdateQueue propertyUpdates;
+
 private:
   struct GridInfo
   {
@@ -181,10 +255,8 @@ private:
   spp::sparse_hash_map<uint32_t, GridInfo> grids;
   std::unique_ptr<MakeID> formIdxManager;
   std::vector<MpForm*> formByIdxUnreliable;
-  std::map<
-    std::chrono::system_clock::duration,
-    std::list<std::pair<uint32_t, std::chrono::system_clock::time_point>>>
-    relootTimers;
+  // Due time to formId
+  std::multimap<std::chrono::system_clock::time_point, uint32_t> relootQueue;
   espm::Loader* espm = nullptr;
   FormCallbacksFactory formCallbacksFactory;
   std::unique_ptr<espm::CompressedFieldsCache> espmCache;
@@ -195,9 +267,14 @@ private:
 
   bool LoadForm(uint32_t formId);
 
+  void LoadChunks(uint32_t cellOrWorld, int16_t minX, int16_t maxX,
+                  int16_t minY, int16_t maxY);
+
   void TickReloot(const std::chrono::system_clock::time_point& now);
   void TickSaveStorage(const std::chrono::system_clock::time_point& now);
   void TickTimers(const std::chrono::system_clock::time_point& now);
+  void TickUpdates(const std::chrono::system_clock::time_point& now);
+  bool IsChunkLoadedAt(uint32_t cellOrWorld, const NiPoint3& pos) const;
 
   struct Impl;
   std::shared_ptr<Impl> pImpl;
@@ -10,6 +10,15 @@ export type SendChatMessageFn = (
   message: Record<string, unknown>
 ) => void;
 
+export interface IngressStats {
+  numQueuedPackets: number;
+  numReceivedPackets: number;
+  numProcessedPackets: number;
+  numCoalescedMovements: number;
+  numDeferredTicks: number;
+  numDroppedPackets: number;
+}
+
 export declare class ScampServer {
   constructor(serverPort: number, maxPlayers: number);
 
@@ -43,6 +52,9 @@ export declare class ScampServer {
   createBot(): Bot;
   getUserByActor(formId: number): number;
 
+  // null unless 'ingress' is configured
+  getIngressStats(): IngressStats | null;
+
   executeJavaScriptOnChakra(src: string): void;
   clear(): void;
   writeLogs(logLevel: string, message: string): void;
@@ -0,0 +1,162 @@
+#include "DatabaseMigrator.h"
+#include "FileDatabase.h"
+#include <catch2/catch_all.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <optional>
+
+namespace {
+class MemoryDatabase : public IDatabase
+{
+public:
+  size_t Upsert(const std::vector<MpChangeForm>& changeForms) override
+  {
+    if (failAfterNumUpserts && numUpserts++ >= *failAfterNumUpserts) {
+      throw std::runtime_error("Upsert failed");
+    }
+    for (auto& changeForm : changeForms) {
+      auto key = changeForm.formDesc.ToString();
+      if (!changeFormsByDesc.count(key)) {
+        order.push_back(key);
+      }
+      changeFormsByDesc[key] = changeForm;
+    }
+    return changeForms.size();
+  }
+
+  void Iterate(const IterateCallback& iterateCallback) override
+  {
+    for (auto& key : order) {
+      iterateCallback(changeFormsByDesc[key]);
+    }
+  }
+
+  std::vector<std::string> order;
+  std::map<std::string, MpChangeForm> changeFormsByDesc;
+  std::optional<size_t> failAfterNumUpserts;
+  size_t numUpserts = 0;
+};
+
+std::vector<MpChangeForm> MakeChangeForms(uint32_t numChangeForms)
+{
+  std::vector<MpChangeForm> res;
+  for (uint32_t i = 0; i < numChangeForms; ++i) {
+    MpChangeForm changeForm;
+    changeForm.formDesc = FormDesc::FromFormId(0xff000000 + i, {});
+    changeForm.position = { static_cast<float>(i), 0, 0 };
+    res.push_back(changeForm);
+  }
+  return res;
+}
+
+std::shared_ptr<MemoryDatabase> MakeOldDatabase(uint32_t numChangeForms)
+{
+  auto res = std::make_shared<MemoryDatabase>();
+  res->Upsert(MakeChangeForms(numChangeForms));
+  return res;
+}
+}
+
+TEST_CASE("DatabaseMigrator copies everything", "[DatabaseMigrator]")
+{
+  auto oldDatabase = MakeOldDatabase(1000);
+  auto newDatabase = std::make_shared<MemoryDatabase>();
+
+  DatabaseMigratorSettings settings;
+  settings.batchSize = 64;
+  settings.maxBatchesInQueue = 2;
+  auto stats = DatabaseMigrator(oldDatabase, newDatabase, settings).Run();
+
+  REQUIRE(stats.numRead == 1000);
+  REQUIRE(stats.numSkipped == 0);
+  REQUIRE(stats.numWritten == 1000);
+  REQUIRE(newDatabase->changeFormsByDesc == oldDatabase->changeFormsByDesc);
+}
+
+TEST_CASE("DatabaseMigrator resumes from checkpoint", "[DatabaseMigrator]")
+{
+  auto checkpointPath =
+    std::filesystem::temp_directory_path() / "skymp_migration_checkpoint.json";
+  std::filesystem::remove(checkpointPath);
+
+  auto oldDatabase = MakeOldDatabase(1000);
+  auto newDatabase = std::make_shared<MemoryDatabase>();
+  newDatabase->failAfterNumUpserts = 3;
+
+  DatabaseMigratorSettings settings;
+  settings.batchSize = 100;
+  settings.checkpointPath = checkpointPath;
+
+  REQUIRE_THROWS_WITH(
+    DatabaseMigrator(oldDatabase, newDatabase, settings).Run(),
+    "Upsert failed");
+  REQUIRE(newDatabase->changeFormsByDesc.size() == 300);
+  REQUIRE(std::filesystem::exists(checkpointPath));
+
+  newDatabase->failAfterNumUpserts.reset();
+  auto stats = DatabaseMigrator(oldDatabase, newDatabase, settings).Run();
+  REQUIRE(stats.numRead == 1000);
+  REQUIRE(stats.numSkipped == 300);
+  REQUIRE(stats.numWritten == 700);
+  REQUIRE(newDatabase->changeFormsByDesc == oldDatabase->changeFormsByDesc);
+  REQUIRE(!std::filesystem::exists(checkpointPath));
+}
+
+TEST_CASE("DatabaseMigrator refuses to resume if the order changed",
+          "[DatabaseMigrator]")
+{
+  auto checkpointPath =
+    std::filesystem::temp_directory_path() / "skymp_migration_checkpoint.json";
+  std::filesystem::remove(checkpointPath);
+
+  auto oldDatabase = MakeOldDatabase(10);
+  auto newDatabase = std::make_shared<MemoryDatabase>();
+  newDatabase->failAfterNumUpserts = 1;
+
+  DatabaseMigratorSettings settings;
+  settings.batchSize = 5;
+  settings.checkpointPath = checkpointPath;
+
+  REQUIRE_THROWS(DatabaseMigrator(oldDatabase, newDatabase, settings).Run());
+
+  std::reverse(oldDatabase->order.begin(), oldDatabase->order.end());
+  newDatabase->failAfterNumUpserts.reset();
+  REQUIRE_THROWS_WITH(
+    DatabaseMigrator(oldDatabase, newDatabase, settings).Run(),
+    Catch::Matchers::ContainsSubstring("order changed"));
+
+  std::filesystem::remove(checkpointPath);
+}
+
+TEST_CASE("DatabaseMigrator migrates between file databases",
+          "[DatabaseMigrator]")
+{
+  auto directory =
+    std::filesystem::temp_directory_path() / "skymp_migration_test";
+  std::filesystem::remove_all(directory);
+
+  auto logger = spdlog::default_logger();
+  auto oldDatabase =
+    std::make_shared<FileDatabase>((directory / "old").string(), logger);
+  auto newDatabase =
+    std::make_shared<FileDatabase>((directory / "new").string(), logger);
+  auto changeForms = MakeChangeForms(50);
+  oldDatabase->Upsert(changeForms);
+
+  DatabaseMigratorSettings settings;
+  settings.batchSize = 8;
+  auto stats = DatabaseMigrator(oldDatabase, newDatabase, settings).Run();
+  REQUIRE(stats.numWritten == 50);
+
+  std::map<FormDesc, MpChangeForm> migrated;
+  newDatabase->Iterate([&](const MpChangeForm& changeForm) {
+    migrated[changeForm.formDesc] = changeForm;
+  });
+  REQUIRE(migrated.size() == changeForms.size());
+  for (auto& changeForm : changeForms) {
+    REQUIRE(migrated[changeForm.formDesc] == changeForm);
+  }
+
+  std::filesystem::remove_all(directory);
+}
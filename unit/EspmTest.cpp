@@ -1,3 +1,4 @@
+#include "EspmFieldsUtils.h"
 #include "TestUtils.hpp"
 #include "libespm/GroupUtils.h"
 #include "libespm/Loader.h"
@@ -545,3 +546,37 @@ TEST_CASE("MGEF parsing", "[espm]")
   auto data = espm::GetData<espm::MGEF>(0x51B15, &provider);
   REQUIRE(data.data.primaryAV == espm::ActorValue::DamageResist);
 }
+
+TEST_CASE("CopyFields packs all fields of a record", "[espm]")
+{
+  // Iron sword and the player NPC
+  for (uint32_t id : { 0x12eb7, 0x7 }) {
+    auto lookupRes = l.GetBrowser().LookupById(id);
+    REQUIRE(lookupRes.rec);
+
+    espm::CompressedFieldsCache cache;
+    std::vector<std::string> expected;
+    espm::IterateFields_(
+      lookupRes.rec,
+      [&](const char* type, uint32_t size, const char* data) {
+        expected.push_back(std::string(type, 4) + std::string(data, size));
+      },
+      cache);
+
+    std::vector<char> buffer;
+    auto fields = EspmFieldsUtils::CopyFields(
+      lookupRes.rec, cache, [&](size_t totalSize) {
+        buffer.resize(totalSize);
+        return buffer.data();
+      });
+
+    std::vector<std::string> actual;
+    for (auto& field : fields) {
+      REQUIRE(field.offset + field.size <= buffer.size());
+      actual.push_back(std::string(field.type, 4) +
+                       std::string(buffer.data() + field.offset, field.size));
+    }
+    REQUIRE(!actual.empty());
+    REQUIRE(actual == expected);
+  }
+}
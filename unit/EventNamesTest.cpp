@@ -0,0 +1,22 @@
+#include "papyrus-vm/EventNames.h"
+#include <catch2/catch_all.hpp>
+
+TEST_CASE("EventNames interns names case-insensitively", "[EventNames]")
+{
+  EventNames eventNames;
+  REQUIRE(eventNames.GetSize() == Events::NumWellKnown);
+  REQUIRE(eventNames.Intern("onupdate") == Events::OnUpdate);
+  REQUIRE(std::string(eventNames.GetName(Events::OnUpdate)) == "OnUpdate");
+
+  auto customId = eventNames.Intern("OnMyCustomEvent");
+  REQUIRE(customId == Events::NumWellKnown);
+  REQUIRE(eventNames.Intern("ONMYCUSTOMEVENT") == customId);
+  REQUIRE(eventNames.Find("onMyCustomEvent") == customId);
+  REQUIRE(std::string(eventNames.GetName(customId)) == "OnMyCustomEvent");
+
+  REQUIRE(eventNames.Find("OnUnknownEvent") == std::nullopt);
+  REQUIRE_THROWS(eventNames.GetName(customId + 1));
+
+  REQUIRE(EventNames::GetWellKnown().GetSize() == Events::NumWellKnown);
+  REQUIRE(EventNames::GetWellKnown().Find("OnMyCustomEvent") == std::nullopt);
+}
@@ -138,3 +138,29 @@ TEST_CASE("GetNeighbours5 + Forget", "[Grid]")
   REQUIRE(gr.GetNeighbours(0xA002) == std::set<formid>({}));
   REQUIRE(gr.GetPos(0xA002) == std::pair<int16_t, int16_t>(101, 9));
 }
+
+TEST_CASE("VisitObjectsInCells", "[Grid]")
+{
+  Grid gr;
+  gr.Move(0x1, 0, 0);
+  gr.Move(0x2, 1, 0);
+  gr.Move(0x3, -5, 3);
+  gr.Move(0x4, 100, 100);
+
+  auto visit = [&](int16_t minX, int16_t maxX, int16_t minY, int16_t maxY) {
+    std::set<formid> res;
+    gr.VisitObjectsInCells(minX, maxX, minY, maxY,
+                           [&](formid id) { res.insert(id); });
+    return res;
+  };
+
+  REQUIRE(visit(0, 0, 0, 0) == std::set<formid>({ 0x1 }));
+  REQUIRE(visit(-5, 1, 0, 3) == std::set<formid>({ 0x1, 0x2, 0x3 }));
+  REQUIRE(visit(-32768, 32767, -32768, 32767) ==
+          std::set<formid>({ 0x1, 0x2, 0x3, 0x4 }));
+
+  gr.Move(0x1, 50, 50);
+  gr.Forget(0x2);
+  REQUIRE(visit(-5, 1, 0, 3) == std::set<formid>({ 0x3 }));
+  REQUIRE(visit(50, 50, 50, 50) == std::set<formid>({ 0x1 }));
+}
@@ -28,4 +28,12 @@ TEST_CASE("HeuristicPolicy", "[HeuristicPolicy]")
                                 args.size(), 0);
 
   REQUIRE(policy.GetDefaultActor("", "", 0) == &actor);
+
+  policy.BeforeSendPapyrusEvent(nullptr, Events::OnTriggerEnter,
+                                "OnTriggerEnter", args.data(), args.size(), 1);
+  REQUIRE(policy.GetDefaultActor("", "", 1) == &actor);
+
+  policy.BeforeSendPapyrusEvent(nullptr, "OnMyCustomEvent", args.data(),
+                                args.size(), 1);
+  REQUIRE(policy.GetDefaultActor("", "", 1) == nullptr);
 }
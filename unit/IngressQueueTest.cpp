@@ -0,0 +1,188 @@
+#include "IngressQueue.h"
+#include "MovementMessage.h"
+#include <catch2/catch_all.hpp>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+struct HandledPacket
+{
+  Networking::UserId userId = Networking::InvalidUserId;
+  Networking::PacketType type = Networking::PacketType::Invalid;
+  std::string data;
+};
+
+void OnPacket(void* state, Networking::UserId userId,
+              Networking::PacketType packetType, Networking::PacketData data,
+              size_t length)
+{
+  reinterpret_cast<std::vector<HandledPacket>*>(state)->push_back(
+    { userId, packetType,
+      std::string(reinterpret_cast<const char*>(data), length) });
+}
+
+void PushMessage(IngressQueue& queue, Networking::UserId userId,
+                 const std::string& data)
+{
+  IngressQueue::Push(&queue, userId, Networking::PacketType::Message,
+                     reinterpret_cast<Networking::PacketData>(data.data()),
+                     data.size());
+}
+
+std::string MakeMovement(uint32_t idx, char marker)
+{
+  std::string res;
+  res += static_cast<char>(Networking::MinPacketId);
+  res += MovementMessage::kHeaderByte;
+  res.append(reinterpret_cast<const char*>(&idx), sizeof(idx));
+  res += marker;
+  return res;
+}
+}
+
+TEST_CASE("IngressQueue handles everything without budget", "[IngressQueue]")
+{
+  IngressQueue queue;
+  IngressQueue::Push(&queue, 1, Networking::PacketType::ServerSideUserConnect,
+                     nullptr, 0);
+  PushMessage(queue, 1, "a");
+  PushMessage(queue, 1, "b");
+
+  std::vector<HandledPacket> handled;
+  queue.BeginTick();
+  queue.Process(OnPacket, &handled);
+
+  REQUIRE(handled.size() == 3);
+  REQUIRE(handled[0].type == Networking::PacketType::ServerSideUserConnect);
+  REQUIRE(handled[1].data == "a");
+  REQUIRE(handled[2].data == "b");
+  REQUIRE(queue.GetStats().numQueuedPackets == 0);
+  REQUIRE(queue.GetStats().numDeferredTicks == 0);
+}
+
+TEST_CASE("IngressQueue carries packets over in per-user fair order",
+          "[IngressQueue]")
+{
+  IngressQueueSettings settings;
+  settings.maxPacketsPerTick = 3;
+  IngressQueue queue(settings);
+
+  for (int i = 0; i < 4; ++i) {
+    PushMessage(queue, 1, "x" + std::to_string(i));
+  }
+  PushMessage(queue, 2, "y0");
+
+  std::vector<HandledPacket> handled;
+  queue.BeginTick();
+  queue.Process(OnPacket, &handled);
+
+  REQUIRE(handled.size() == 3);
+  REQUIRE(handled[0].data == "x0");
+  REQUIRE(handled[1].data == "y0");
+  REQUIRE(handled[2].data == "x1");
+  REQUIRE(queue.GetStats().numQueuedPackets == 2);
+  REQUIRE(queue.GetStats().numDeferredTicks == 1);
+
+  handled.clear();
+  queue.BeginTick();
+  queue.Process(OnPacket, &handled);
+  REQUIRE(handled.size() == 2);
+  REQUIRE(handled[0].data == "x2");
+  REQUIRE(handled[1].data == "x3");
+}
+
+TEST_CASE("IngressQueue coalesces movement while there is a backlog",
+          "[IngressQueue]")
+{
+  IngressQueueSettings settings;
+  settings.maxPacketsPerTick = 1;
+  IngressQueue queue(settings);
+
+  std::vector<HandledPacket> handled;
+
+  // No backlog yet, nothing is coalesced
+  PushMessage(queue, 1, MakeMovement(0, 'a'));
+  PushMessage(queue, 1, MakeMovement(0, 'b'));
+  queue.BeginTick();
+  queue.Process(OnPacket, &handled);
+  REQUIRE(queue.GetStats().numCoalescedMovements == 0);
+
+  PushMessage(queue, 1, MakeMovement(0, 'c')); // replaces 'b'
+  PushMessage(queue, 1, MakeMovement(5, 'd')); // another actor
+  PushMessage(queue, 1, "activate");
+  PushMessage(queue, 1, MakeMovement(5, 'e')); // not adjacent to 'd'
+  PushMessage(queue, 1, MakeMovement(5, 'f')); // replaces 'e'
+  REQUIRE(queue.GetStats().numCoalescedMovements == 2);
+
+  for (int i = 0; i < 4; ++i) {
+    queue.BeginTick();
+    queue.Process(OnPacket, &handled);
+  }
+
+  std::vector<std::string> expected = { MakeMovement(0, 'a'),
+                                        MakeMovement(0, 'c'),
+                                        MakeMovement(5, 'd'), "activate",
+                                        MakeMovement(5, 'f') };
+  REQUIRE(handled.size() == expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    REQUIRE(handled[i].data == expected[i]);
+  }
+}
+
+TEST_CASE("IngressQueue continues after a handler throws", "[IngressQueue]")
+{
+  IngressQueue queue;
+  PushMessage(queue, 1, "throw");
+  PushMessage(queue, 1, "ok");
+
+  std::vector<std::string> handled;
+  auto onPacket = [](void* state, Networking::UserId,
+                     Networking::PacketType, Networking::PacketData data,
+                     size_t length) {
+    std::string s(reinterpret_cast<const char*>(data), length);
+    if (s == "throw") {
+      throw std::runtime_error("handler failed");
+    }
+    reinterpret_cast<std::vector<std::string>*>(state)->push_back(s);
+  };
+
+  queue.BeginTick();
+  REQUIRE_THROWS_WITH(queue.Process(onPacket, &handled), "handler failed");
+  queue.Process(onPacket, &handled);
+  REQUIRE(handled == std::vector<std::string>{ "ok" });
+}
+
+TEST_CASE("IngressQueue drops messages of users over the limit",
+          "[IngressQueue]")
+{
+  IngressQueueSettings settings;
+  settings.maxQueuedPacketsPerUser = 2;
+  IngressQueue queue(settings);
+
+  for (int i = 0; i < 4; ++i) {
+    PushMessage(queue, 1, "x" + std::to_string(i));
+  }
+  PushMessage(queue, 2, "y0");
+  IngressQueue::Push(&queue, 1,
+                     Networking::PacketType::ServerSideUserDisconnect,
+                     nullptr, 0);
+
+  REQUIRE(queue.GetStats().numDroppedPackets == 2);
+  REQUIRE(queue.GetStats().numQueuedPackets == 4);
+
+  std::vector<HandledPacket> handled;
+  queue.BeginTick();
+  queue.Process(OnPacket, &handled);
+
+  REQUIRE(handled.size() == 4);
+  REQUIRE(handled[0].data == "x0");
+  REQUIRE(handled[1].data == "y0");
+  REQUIRE(handled[2].data == "x1");
+  REQUIRE(handled[3].type ==
+          Networking::PacketType::ServerSideUserDisconnect);
+
+  // The limit applies to packets queued at the moment
+  PushMessage(queue, 1, "x4");
+  REQUIRE(queue.GetStats().numDroppedPackets == 2);
+}
@@ -0,0 +1,168 @@
+#include "MongoChangeFormCodec.h"
+#include "MongoDatabase.h"
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <optional>
+#include <mongocxx/client.hpp>
+#include <mongocxx/uri.hpp>
+
+namespace {
+MpChangeForm MakeTestChangeForm(uint32_t formId)
+{
+  MpChangeForm res;
+  res.recType = MpChangeForm::ACHR;
+  res.formDesc = FormDesc::FromFormId(formId, {});
+  res.baseDesc = FormDesc::FromString("7:Skyrim.esm");
+  res.position = { 1.5f, -2.f, 100000.f };
+  res.angle = { 0.f, 0.f, 179.f };
+  res.worldOrCellDesc = FormDesc::Tamriel();
+  res.inv.AddItem(0x12eb7, 3);
+  res.inv.entries.push_back({ 0x1, 1 });
+  res.inv.entries.back().extra.name = "Sword";
+  res.inv.entries.back().extra.health = 1.5f;
+  res.inv.entries.back().extra.worn = Inventory::Worn::Left;
+  res.learnedSpells.LearnSpell(0x12fcd);
+  res.nextRelootDatetime = 1700000000;
+  res.profileId = 42;
+  res.isDead = true;
+  res.appearanceDump = R"({"isFemale":false,"name":"Oberyn","weight":99.9})";
+  res.equipmentDump = R"({"inv":{"entries":[]},"numChanges":2})";
+  res.actorValues.healthPercentage = 0.5f;
+  res.dynamicFields.Set("myProp", nlohmann::json{ { "a", { 1, "two" } } });
+  res.spawnDelay = 8.f;
+  return res;
+}
+
+bsoncxx::document::view GetSet(const bsoncxx::document::value& update)
+{
+  return update.view()["$set"].get_document().value;
+}
+}
+
+TEST_CASE("MongoChangeFormCodec decodes what it encodes", "[Mongo]")
+{
+  MongoChangeFormCodec codec;
+
+  for (auto changeForm : { MpChangeForm(), MakeTestChangeForm(0xff000000) }) {
+    auto update = codec.MakeUpdate(changeForm);
+    REQUIRE(update.has_value());
+    REQUIRE(MongoChangeFormCodec::FromBson(GetSet(*update)) == changeForm);
+  }
+}
+
+TEST_CASE("MongoChangeFormCodec decodes documents written via JSON",
+          "[Mongo]")
+{
+  auto changeForm = MakeTestChangeForm(0xff000000);
+  auto document =
+    MongoChangeFormCodec::JsonToBson(MpChangeForm::ToJson(changeForm));
+  REQUIRE(MongoChangeFormCodec::FromBson(document.view()) == changeForm);
+  REQUIRE(MongoChangeFormCodec::BsonToJson(document.view()) ==
+          MpChangeForm::ToJson(changeForm));
+}
+
+TEST_CASE("MongoChangeFormCodec requires the same fields as JSON codec",
+          "[Mongo]")
+{
+  auto full = MpChangeForm::ToJson(MakeTestChangeForm(0xff000000));
+  simdjson::dom::parser parser;
+
+  for (auto& item : full.items()) {
+    INFO(item.key());
+    auto j = full;
+    j.erase(item.key());
+
+    std::optional<MpChangeForm> fromJson, fromBson;
+    try {
+      auto dump = j.dump();
+      simdjson::dom::element element = parser.parse(dump).value();
+      fromJson = MpChangeForm::JsonToChangeForm(element);
+    } catch (std::exception&) {
+    }
+    try {
+      auto document = MongoChangeFormCodec::JsonToBson(j);
+      fromBson = MongoChangeFormCodec::FromBson(document.view());
+    } catch (std::exception&) {
+    }
+
+    REQUIRE(fromJson.has_value() == fromBson.has_value());
+    if (fromJson) {
+      REQUIRE(*fromJson == *fromBson);
+    }
+  }
+}
+
+TEST_CASE("MongoChangeFormCodec produces field-level updates", "[Mongo]")
+{
+  MongoChangeFormCodec codec;
+  auto changeForm = MakeTestChangeForm(0xff000000);
+
+  auto fullUpdate = codec.MakeUpdate(changeForm);
+  REQUIRE(fullUpdate.has_value());
+  REQUIRE(MongoChangeFormCodec::BsonToJson(GetSet(*fullUpdate)) ==
+          MpChangeForm::ToJson(changeForm));
+
+  REQUIRE(!codec.MakeUpdate(changeForm).has_value());
+
+  changeForm.isOpen = true;
+  changeForm.inv.AddItem(0x12eb7, 1);
+  auto partialUpdate = codec.MakeUpdate(changeForm);
+  REQUIRE(partialUpdate.has_value());
+  REQUIRE(MongoChangeFormCodec::BsonToJson(GetSet(*partialUpdate)) ==
+          nlohmann::json{ { "isOpen", true },
+                          { "inv", changeForm.inv.ToJson() } });
+
+  codec.Forget(changeForm.formDesc.ToString());
+  auto updateAfterForget = codec.MakeUpdate(changeForm);
+  REQUIRE(updateAfterForget.has_value());
+  REQUIRE(MongoChangeFormCodec::BsonToJson(GetSet(*updateAfterForget)) ==
+          MpChangeForm::ToJson(changeForm));
+}
+
+// Requires a running mongod (or a compatible server) at SKYMP_TEST_MONGO_URI,
+// e.g. mongodb://localhost:27017
+TEST_CASE("MongoDatabase saves and loads change forms", "[Mongo]")
+{
+  const char* uri = std::getenv("SKYMP_TEST_MONGO_URI");
+  if (!uri || !*uri) {
+    WARN("SKYMP_TEST_MONGO_URI is not set, skipping");
+    return;
+  }
+
+  const auto dbName = "skymp_unit_" +
+    std::to_string(
+      std::chrono::system_clock::now().time_since_epoch().count());
+
+  MongoDatabaseSettings settings;
+  settings.bulkWriteSize = 100;
+  settings.maxBulkWritesInFlight = 4;
+  settings.iterateBatchSize = 250;
+
+  std::vector<MpChangeForm> changeForms;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    changeForms.push_back(MakeTestChangeForm(0xff000000 + i));
+  }
+
+  {
+    MongoDatabase db(uri, dbName, settings);
+    REQUIRE(db.Upsert(changeForms) == changeForms.size());
+
+    changeForms[500].isOpen = true;
+    changeForms[500].position = { 1, 2, 3 };
+    REQUIRE(db.Upsert(changeForms) == changeForms.size());
+  }
+
+  std::map<std::string, MpChangeForm> loaded;
+  MongoDatabase(uri, dbName, settings).Iterate([&](const MpChangeForm& f) {
+    loaded[f.formDesc.ToString()] = f;
+  });
+
+  REQUIRE(loaded.size() == changeForms.size());
+  for (auto& changeForm : changeForms) {
+    REQUIRE(loaded[changeForm.formDesc.ToString()] == changeForm);
+  }
+
+  mongocxx::client client{ mongocxx::uri(uri) };
+  client[dbName].drop();
+}
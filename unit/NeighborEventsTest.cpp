@@ -0,0 +1,48 @@
+#include <catch2/catch_all.hpp>
+
+#include "NeighborEvents.h"
+
+using Catch::Matchers::Equals;
+
+TEST_CASE("NeighborEvents reports subscription changes as pairs",
+          "[NeighborEvents]")
+{
+  NeighborEvents events;
+  REQUIRE(events.Empty());
+
+  events.RecordSubscription(0xff000000, 0xff000001, true);
+  events.RecordSubscription(0x14, 0xff000001, true);
+  events.RecordSubscription(0xff000002, 0xff000001, false);
+  REQUIRE(!events.Empty());
+
+  auto batch = events.Take();
+  REQUIRE_THAT(batch.entered,
+               Equals(std::vector<uint32_t>{ 0x14, 0xff000001, 0xff000000,
+                                             0xff000001 }));
+  REQUIRE_THAT(batch.left,
+               Equals(std::vector<uint32_t>{ 0xff000002, 0xff000001 }));
+  REQUIRE(batch.online.empty());
+  REQUIRE(batch.offline.empty());
+  REQUIRE(events.Empty());
+}
+
+TEST_CASE("NeighborEvents drops changes reverted within a batch",
+          "[NeighborEvents]")
+{
+  NeighborEvents events;
+
+  events.RecordSubscription(1, 2, true);
+  events.RecordSubscription(1, 2, false);
+  events.RecordSubscription(3, 4, false);
+  events.RecordSubscription(3, 4, true);
+  events.RecordSubscription(3, 4, false);
+  events.RecordOnline(5, true);
+  events.RecordOnline(5, false);
+  events.RecordOnline(6, false);
+
+  auto batch = events.Take();
+  REQUIRE(batch.entered.empty());
+  REQUIRE_THAT(batch.left, Equals(std::vector<uint32_t>{ 3, 4 }));
+  REQUIRE(batch.online.empty());
+  REQUIRE_THAT(batch.offline, Equals(std::vector<uint32_t>{ 6 }));
+}
@@ -39,3 +39,35 @@ TEST_CASE("Disable makes ref invisible", "[ObjectReference]")
   ref.Enable();
   REQUIRE(ref.GetListeners() == std::set<MpObjectReference*>{ &ac });
 }
+
+TEST_CASE("Property messages are serialized like PreparePropertyMessage",
+          "[ObjectReference]")
+{
+  class TestReference : public MpObjectReference
+  {
+  public:
+    using MpObjectReference::MpObjectReference;
+
+    void Check(const char* name, const nlohmann::json& value)
+    {
+      auto message = CreatePropertyMessage(this, name, value);
+      REQUIRE(message[0] == static_cast<char>(Networking::MinPacketId));
+      REQUIRE(message.substr(1) ==
+              PreparePropertyMessage(this, name, value).dump());
+    }
+  };
+
+  PartOne p;
+  for (auto baseType : { "DOOR", "CONT" }) {
+    auto formId = baseType == std::string("DOOR") ? 0xff000000 : 0xff000001;
+    p.worldState.AddForm(std::make_unique<TestReference>(
+                         LocationalData(), FormCallbacks::DoNothing(), 0,
+                         baseType),
+                       formId);
+    auto& ref = p.worldState.GetFormAt<TestReference>(formId);
+
+    ref.Check("isOpen", true);
+    ref.Check("inventory", Inventory().AddItem(0x12eb7, 2).ToJson());
+    ref.Check("my \"quoted\" prop", 1.5);
+  }
+}
@@ -0,0 +1,154 @@
+#include "PacketHistoryRecorder.h"
+#include <catch2/catch_all.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+std::vector<uint8_t> MakePacket(uint32_t i)
+{
+  std::string s = "packet #" + std::to_string(i);
+  return { s.begin(), s.end() };
+}
+
+void RecordPackets(PacketHistoryRecorder& recorder, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; ++i) {
+    auto packet = MakePacket(i);
+    recorder.Record(packet.data(), packet.size(), i * 10);
+  }
+}
+
+uint32_t ReadAndCheckPackets(PacketHistoryReader& reader, uint32_t first)
+{
+  uint32_t n = 0;
+  while (auto packet = reader.Peek()) {
+    auto expected = MakePacket(first + n);
+    REQUIRE(std::vector<uint8_t>(packet->data,
+                                 packet->data + packet->length) == expected);
+    REQUIRE(packet->timeMs == (first + n) * 10);
+    reader.Pop();
+    ++n;
+  }
+  return n;
+}
+}
+
+TEST_CASE("PacketHistoryRecorder keeps everything when under capacity",
+          "[PacketHistoryRecorder]")
+{
+  PacketHistoryRecorderSettings settings;
+  settings.blockSizeBytes = 100;
+  PacketHistoryRecorder recorder(settings, "unused.bin");
+
+  RecordPackets(recorder, 50);
+
+  auto reader = recorder.CreateReader();
+  REQUIRE(ReadAndCheckPackets(*reader, 0) == 50);
+
+  auto history = recorder.ToPacketHistory();
+  REQUIRE(history.packets.size() == 50);
+  REQUIRE(history.packets[3].timeMs == 30);
+}
+
+TEST_CASE("PacketHistoryRecorder drops oldest blocks without spill directory",
+          "[PacketHistoryRecorder]")
+{
+  PacketHistoryRecorderSettings settings;
+  settings.blockSizeBytes = 100;
+  settings.ringCapacityBytes = 200;
+  PacketHistoryRecorder recorder(settings, "unused.bin");
+
+  RecordPackets(recorder, 1000);
+
+  REQUIRE(recorder.GetNumRecordedPackets() == 1000);
+  REQUIRE(recorder.GetNumDroppedPackets() > 0);
+
+  auto reader = recorder.CreateReader();
+  auto first = static_cast<uint32_t>(recorder.GetNumDroppedPackets());
+  REQUIRE(ReadAndCheckPackets(*reader, first) == 1000 - first);
+}
+
+TEST_CASE("PacketHistoryRecorder spills oldest blocks to disk",
+          "[PacketHistoryRecorder]")
+{
+  auto directory =
+    std::filesystem::temp_directory_path() / "skymp_packet_history_test";
+  std::filesystem::remove_all(directory);
+
+  PacketHistoryRecorderSettings settings;
+  settings.blockSizeBytes = 100;
+  settings.ringCapacityBytes = 200;
+  settings.spillDirectory = directory;
+
+  {
+    PacketHistoryRecorder recorder(settings, "user_0.bin");
+    RecordPackets(recorder, 1000);
+    REQUIRE(recorder.GetNumDroppedPackets() == 0);
+    REQUIRE(std::filesystem::exists(recorder.GetSpillPath()));
+
+    // Reader is a snapshot: packets recorded later are not visible
+    auto reader = recorder.CreateReader();
+    RecordPackets(recorder, 100);
+    REQUIRE(ReadAndCheckPackets(*reader, 0) == 1000);
+
+    recorder.Clear();
+    REQUIRE(!std::filesystem::exists(recorder.GetSpillPath()));
+    RecordPackets(recorder, 500);
+  }
+
+  // Everything is spilled on destruction
+  auto path = directory / "user_0.bin";
+  PacketHistoryReader reader(path, std::filesystem::file_size(path), {});
+  REQUIRE(ReadAndCheckPackets(reader, 0) == 500);
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("PacketHistoryReader reads legacy PacketHistory",
+          "[PacketHistoryRecorder]")
+{
+  PacketHistory history;
+  for (uint32_t i = 0; i < 3; ++i) {
+    auto packet = MakePacket(i);
+    history.packets.push_back({ history.buffer.size(), packet.size(), i * 10 });
+    history.buffer.insert(history.buffer.end(), packet.begin(), packet.end());
+  }
+
+  PacketHistoryReader reader(history);
+  REQUIRE(ReadAndCheckPackets(reader, 0) == 3);
+  REQUIRE(reader.Peek() == nullptr);
+}
+
+TEST_CASE("PacketHistoryRecorder keeps recording when disk spill fails",
+          "[PacketHistoryRecorder]")
+{
+  // A regular file where the spill directory should be makes spilling fail
+  auto notADirectory =
+    std::filesystem::temp_directory_path() / "skymp_packet_history_file";
+  std::filesystem::remove_all(notADirectory);
+  std::ofstream(notADirectory) << "x";
+
+  PacketHistoryRecorderSettings settings;
+  settings.blockSizeBytes = 100;
+  settings.ringCapacityBytes = 200;
+  settings.spillDirectory = notADirectory / "subdirectory";
+
+  PacketHistoryRecorder recorder(settings, "user_0.bin");
+  REQUIRE_NOTHROW(RecordPackets(recorder, 1000));
+
+  REQUIRE(recorder.GetNumRecordedPackets() == 1000);
+  REQUIRE(recorder.GetNumDroppedPackets() > 0);
+
+  auto reader = recorder.CreateReader();
+  auto first = static_cast<uint32_t>(recorder.GetNumDroppedPackets());
+  REQUIRE(ReadAndCheckPackets(*reader, first) == 1000 - first);
+
+  // The history stays in memory and is still read exactly once
+  REQUIRE_THROWS(recorder.SpillAll());
+  reader = recorder.CreateReader();
+  REQUIRE(ReadAndCheckPackets(*reader, first) == 1000 - first);
+
+  recorder.Clear();
+  std::filesystem::remove_all(notADirectory);
+}
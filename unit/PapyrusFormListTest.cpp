@@ -3,6 +3,7 @@
 
 #include "EspmGameObject.h"
 #include "PapyrusFormList.h"
+#include "WorldState.h"
 
 extern espm::Loader l;
 
@@ -27,3 +28,30 @@ TEST_CASE("GetSize/GetAt", "[Papyrus][FormList][espm]")
   REQUIRE(PapyrusFormList().GetAt(formlist, { VarValue(2) }) ==
           VarValue::None());
 }
+
+TEST_CASE("Find/HasForm", "[Papyrus][FormList][espm]")
+{
+  auto& br = l.GetBrowser();
+
+  auto formlist =
+    VarValue(std::make_shared<EspmGameObject>(br.LookupById(0x21e81)));
+  auto element1 =
+    VarValue(std::make_shared<EspmGameObject>(br.LookupById(0x4e4bb)));
+  auto notAnElement =
+    VarValue(std::make_shared<EspmGameObject>(br.LookupById(0x21e81)));
+
+  WorldState worldState;
+  PapyrusFormList cached, uncached;
+  cached.worldState = &worldState;
+
+  for (auto p : std::vector<PapyrusFormList*>{ &cached, &uncached }) {
+    REQUIRE(p->Find(formlist, { element1 }) == VarValue(1));
+    REQUIRE(p->Find(formlist, { notAnElement }) == VarValue::None());
+    REQUIRE(p->HasForm(formlist, { element1 }) == VarValue(true));
+    REQUIRE(p->HasForm(formlist, { notAnElement }) == VarValue(false));
+  }
+
+  // Decoded once
+  REQUIRE(worldState.GetFormListCache().Get(GetRecordPtr(formlist)) ==
+          worldState.GetFormListCache().Get(GetRecordPtr(formlist)));
+}
@@ -45,16 +45,82 @@ TEST_CASE("RegisterForSingleUpdate", "[Papyrus][Form]")
   REQUIRE(form.counter == 1);
 }
 
+TEST_CASE("RegisterForUpdate repeats until UnregisterForUpdate",
+          "[Papyrus][Form]")
+{
+  class CustomForm : public MpForm
+  {
+  public:
+    void Update() override { counter++; }
+
+    int counter = 0;
+  };
+
+  PartOne p;
+  p.worldState.AddForm(std::make_unique<CustomForm>(), 0xff000000);
+
+  auto& form = p.worldState.GetFormAt<CustomForm>(0xff000000);
+
+  // Registering again replaces the previous registration
+  PapyrusForm().RegisterForSingleUpdate(form.ToVarValue(),
+                                        { VarValue(0.01f) });
+  PapyrusForm().RegisterForUpdate(form.ToVarValue(), { VarValue(0.01f) });
+
+  std::this_thread::sleep_for(10ms);
+  p.worldState.Tick();
+  REQUIRE(form.counter == 1);
+
+  std::this_thread::sleep_for(10ms);
+  p.worldState.Tick();
+  REQUIRE(form.counter == 2);
+
+  PapyrusForm().UnregisterForUpdate(form.ToVarValue(), {});
+  std::this_thread::sleep_for(10ms);
+  p.worldState.Tick();
+  REQUIRE(form.counter == 2);
+}
+
+TEST_CASE("Skipped OnUpdate events don't count against the limit",
+          "[Papyrus][Form]")
+{
+  class CustomForm : public MpForm
+  {
+  public:
+    void Update() override { counter++; }
+
+    int counter = 0;
+  };
+
+  PartOne p;
+  p.worldState.maxPapyrusUpdatesPerTick = 1;
+  p.worldState.AddForm(std::make_unique<CustomForm>(), 0xff000000);
+  p.worldState.AddForm(std::make_unique<CustomForm>(), 0xff000001);
+
+  auto& destroyed = p.worldState.GetFormAt<CustomForm>(0xff000000);
+  auto& form = p.worldState.GetFormAt<CustomForm>(0xff000001);
+  PapyrusForm().RegisterForSingleUpdate(destroyed.ToVarValue(),
+                                        { VarValue(0.01f) });
+  PapyrusForm().RegisterForSingleUpdate(form.ToVarValue(),
+                                        { VarValue(0.02f) });
+
+  // Its registration is due first and is dropped during the tick
+  p.worldState.DestroyForm(0xff000000);
+
+  std::this_thread::sleep_for(30ms);
+  p.worldState.Tick();
+  REQUIRE(form.counter == 1);
+}
+
 TEST_CASE("RegisterForSingleUpdate triggers Papyrus OnUpdate event",
           "[Papyrus][Form]")
 {
   class CustomForm : public MpForm
   {
   public:
-    void SendPapyrusEvent(const char* eventName, const VarValue* arguments,
-                          size_t argumentsCount)
+    void SendPapyrusEvent(EventId eventId, const VarValue* arguments,
+                          size_t argumentsCount) override
     {
-      if (!strcmp(eventName, "OnUpdate") && !argumentsCount)
+      if (eventId == Events::OnUpdate && !argumentsCount)
         sent = true;
     }
 
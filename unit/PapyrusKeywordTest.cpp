@@ -0,0 +1,39 @@
+#include "TestUtils.hpp"
+#include <catch2/catch_all.hpp>
+
+#include "EditorIdIndex.h"
+#include "EspmGameObject.h"
+#include "PapyrusKeyword.h"
+
+PartOne& GetPartOne();
+
+TEST_CASE("GetKeyword", "[Papyrus][Keyword][espm]")
+{
+  auto& partOne = GetPartOne();
+
+  PapyrusKeyword papyrusKeyword;
+  papyrusKeyword.worldState = &partOne.worldState;
+
+  auto keyword = papyrusKeyword.GetKeyword(VarValue::None(),
+                                           { VarValue("armorHEAVY") });
+  REQUIRE(GetRecordPtr(keyword).rec->GetId() == 0x6bbd2);
+
+  REQUIRE(papyrusKeyword.GetKeyword(VarValue::None(),
+                                    { VarValue("NoSuchKeyword") }) ==
+          VarValue::None());
+  REQUIRE(papyrusKeyword.GetKeyword(VarValue::None(), { VarValue(1) }) ==
+          VarValue::None());
+}
+
+TEST_CASE("EditorIdIndex is case-insensitive", "[EditorIdIndex][espm]")
+{
+  auto& partOne = GetPartOne();
+
+  auto& index = partOne.worldState.GetEditorIdIndex("KYWD");
+  REQUIRE(index.GetSize() > 0);
+  REQUIRE(index.Find("ArmorLight") == 0x6bbd3);
+  REQUIRE(index.Find("ARMORLIGHT") == 0x6bbd3);
+  REQUIRE(index.Find("") == 0);
+
+  REQUIRE(&partOne.worldState.GetEditorIdIndex("KYWD") == &index);
+}
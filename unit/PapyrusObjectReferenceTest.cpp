@@ -9,6 +9,7 @@
 using Catch::Matchers::ContainsSubstring;
 
 extern espm::Loader l;
+PartOne& GetPartOne();
 
 namespace {
 
@@ -24,12 +25,11 @@ public:
   {
   }
 
-  void SendPapyrusEvent(const char* eventName,
-                        const VarValue* arguments = nullptr,
+  void SendPapyrusEvent(EventId eventId, const VarValue* arguments = nullptr,
                         size_t argumentsCount = 0) override
   {
-    events.push_back(eventName);
-    return MpObjectReference::SendPapyrusEvent(eventName, arguments,
+    events.push_back(EventNames::GetWellKnown().GetName(eventId));
+    return MpObjectReference::SendPapyrusEvent(eventId, arguments,
                                                argumentsCount);
   }
 
@@ -163,3 +163,26 @@ TEST_CASE("BlockActivation", "[Papyrus][ObjectReference][espm]")
   REQUIRE_THROWS_WITH(refr.Activate(ac),
                       ContainsSubstring("No espm attached"));
 }
+
+TEST_CASE("GetBaseObject returns shared wrapper",
+          "[Papyrus][ObjectReference][espm]")
+{
+  PartOne& p = GetPartOne();
+
+  auto refr = std::make_unique<MpObjectReference>(
+    LocationalData(), FormCallbacks::DoNothing(), 0x12eb7, "WEAP");
+  p.worldState.AddForm(std::move(refr), 0xff000000);
+  auto& ref = p.worldState.GetFormAt<MpObjectReference>(0xff000000);
+
+  auto base = PapyrusObjectReference().GetBaseObject(ref.ToVarValue(), {});
+  REQUIRE(GetRecordPtr(base).rec == l.GetBrowser().LookupById(0x12eb7).rec);
+  REQUIRE(static_cast<IGameObject*>(base) ==
+          static_cast<IGameObject*>(PapyrusObjectReference().GetBaseObject(
+            ref.ToVarValue(), {})));
+  REQUIRE(static_cast<IGameObject*>(base) ==
+          p.worldState
+            .GetEspmGameObject(l.GetBrowser().LookupById(0x12eb7))
+            .get());
+
+  p.worldState.DestroyForm(0xff000000);
+}
@@ -1,3 +1,4 @@
+#include "GamemodeData.h"
 #include "TestUtils.hpp"
 
 using Catch::Matchers::ContainsSubstring;
@@ -124,3 +125,88 @@ TEST_CASE("Server custom packet", "[PartOne]")
   REQUIRE(partOne.Messages()[0].userId == 1);
   REQUIRE(partOne.Messages()[0].reliable);
 }
+
+TEST_CASE("Gamemode data is sent as deltas and fetched by hashes",
+          "[PartOne]")
+{
+  PartOne partOne;
+
+  GamemodeApi::State state;
+  state.createdEventSources["onTick"].functionBody = "ctx.sendEvent()";
+  state.createdProperties["color"] = { "return 1", "return 2", true, true };
+  partOne.NotifyGamemodeApiStateChanged(state);
+
+  DoConnect(partOne, 0);
+  REQUIRE(partOne.Messages().size() == 1);
+  auto manifest = partOne.Messages()[0].j;
+  REQUIRE(manifest["type"] == "gamemodeDataManifest");
+  REQUIRE(manifest["hashes"]["eventSources"]["onTick"] ==
+          GamemodeData::Hash("ctx.sendEvent()"));
+  REQUIRE(manifest["hashes"]["updateNeighborFunctions"]["color"] ==
+          GamemodeData::Hash("return 2"));
+
+  // Only known hashes are answered
+  partOne.Messages().clear();
+  DoMessage(partOne, 0,
+            { { "t", MsgType::RequestGamemodeData },
+              { "hashes",
+                { GamemodeData::Hash("return 1"),
+                  GamemodeData::Hash("unknown") } } });
+  REQUIRE(partOne.Messages().size() == 1);
+  REQUIRE(partOne.Messages()[0].j["type"] == "gamemodeDataBodies");
+  REQUIRE(partOne.Messages()[0].j["bodies"] ==
+          nlohmann::json{ { GamemodeData::Hash("return 1"), "return 1" } });
+
+  // Nothing is sent if nothing changed
+  partOne.Messages().clear();
+  partOne.NotifyGamemodeApiStateChanged(state);
+  REQUIRE(partOne.Messages().empty());
+
+  state.createdProperties["color"].updateOwner = "return 3";
+  state.createdEventSources.clear();
+  partOne.NotifyGamemodeApiStateChanged(state);
+  REQUIRE(partOne.Messages().size() == 1);
+  auto delta = partOne.Messages()[0].j;
+  REQUIRE(delta["type"] == "gamemodeDataDelta");
+  REQUIRE(delta["version"] == 2);
+  REQUIRE(delta["hashes"]["updateOwnerFunctions"] ==
+          nlohmann::json{ { "color", GamemodeData::Hash("return 3") } });
+  REQUIRE(delta["hashes"]["updateNeighborFunctions"].empty());
+  REQUIRE(delta["removed"]["eventSources"] ==
+          nlohmann::json::array({ "onTick" }));
+  REQUIRE(delta["bodies"] ==
+          nlohmann::json{ { GamemodeData::Hash("return 3"), "return 3" } });
+}
+
+TEST_CASE("Gamemode data manifest is sent to users that missed it",
+          "[PartOne]")
+{
+  PartOne partOne;
+
+  // Nothing to send yet
+  DoConnect(partOne, 0);
+  REQUIRE(partOne.Messages().empty());
+
+  GamemodeApi::State state;
+  state.createdEventSources["onTick"].functionBody = "ctx.sendEvent()";
+  partOne.NotifyGamemodeApiStateChanged(state);
+  REQUIRE(partOne.Messages().size() == 1);
+  REQUIRE(partOne.Messages()[0].j["type"] == "gamemodeDataManifest");
+  REQUIRE(partOne.Messages()[0].j["version"] == 1);
+
+  partOne.Messages().clear();
+  state.createdEventSources["onTick"].functionBody = "ctx.sendEvent(1)";
+  partOne.NotifyGamemodeApiStateChanged(state);
+  REQUIRE(partOne.Messages().size() == 1);
+  REQUIRE(partOne.Messages()[0].j["type"] == "gamemodeDataDelta");
+
+  // Requested by a client that detected a version gap
+  partOne.Messages().clear();
+  DoMessage(partOne, 0,
+            { { "t", MsgType::RequestGamemodeData },
+              { "hashes", nlohmann::json::array() },
+              { "manifest", true } });
+  REQUIRE(partOne.Messages().size() == 1);
+  REQUIRE(partOne.Messages()[0].j["type"] == "gamemodeDataManifest");
+  REQUIRE(partOne.Messages()[0].j["version"] == 2);
+}
@@ -277,6 +277,82 @@ TEST_CASE("Activate WRDoorMainGate01 in Whiterun", "[PartOne][espm]")
   partOne.DestroyActor(0xff000000);
 }
 
+TEST_CASE("Reloots are limited per tick", "[PartOne][espm]")
+{
+  auto& partOne = GetPartOne();
+
+  partOne.CreateActor(0xff000000, { 19367.3379, -7433.0698, -3547.4492 }, 0,
+                      0x1a26f);
+
+  // Flush reloots left by other tests
+  partOne.Tick();
+  const auto numPendingBefore = partOne.worldState.GetNumPendingReloots();
+
+  auto& door = partOne.worldState.GetFormAt<MpObjectReference>(0x1b1f3);
+  auto& flower = partOne.worldState.GetFormAt<MpObjectReference>(0x0100122a);
+  door.SetOpen(true);
+  door.RequestReloot(std::chrono::milliseconds(0));
+  flower.RequestReloot(std::chrono::milliseconds(0));
+  REQUIRE(partOne.worldState.GetNumPendingReloots() == numPendingBefore + 2);
+
+  const auto maxRelootsPerTick = partOne.worldState.maxRelootsPerTick;
+  partOne.worldState.maxRelootsPerTick = 1;
+  partOne.Tick();
+  REQUIRE(partOne.worldState.GetNumPendingReloots() == numPendingBefore + 1);
+  partOne.Tick();
+  REQUIRE(partOne.worldState.GetNumPendingReloots() == numPendingBefore);
+  partOne.worldState.maxRelootsPerTick = maxRelootsPerTick;
+
+  REQUIRE(door.IsOpen() == false);
+  REQUIRE(door.GetNextRelootMoment() == nullptr);
+  REQUIRE(flower.GetNextRelootMoment() == nullptr);
+
+  partOne.DestroyActor(0xff000000);
+}
+
+TEST_CASE("Reloot overrides property updates deferred in the same tick",
+          "[PartOne][espm]")
+{
+  auto& partOne = GetPartOne();
+
+  DoConnect(partOne, 0);
+  partOne.CreateActor(0xff000000, { 19367.3379, -7433.0698, -3547.4492 }, 0,
+                      0x1a26f);
+  partOne.SetUserActor(0, 0xff000000);
+
+  auto& door = partOne.worldState.GetFormAt<MpObjectReference>(0x1b1f3);
+  partOne.worldState.deferPropertyBroadcasts = true;
+  partOne.Messages().clear();
+
+  door.SetOpen(true);
+  door.RequestReloot(std::chrono::milliseconds(0));
+  partOne.Tick();
+  partOne.worldState.deferPropertyBroadcasts = false;
+
+  std::vector<nlohmann::json> isOpenValues;
+  for (auto& m : partOne.Messages()) {
+    auto j = m.j;
+    if (m.userId != 0 || !j.contains("t")) {
+      continue;
+    }
+    auto updates = j["t"] == MsgType::UpdatePropertyBatch
+      ? j["updates"]
+      : nlohmann::json::array({ j });
+    for (auto& update : updates) {
+      if (update["t"] == MsgType::UpdateProperty &&
+          update["idx"] == door.GetIdx() && update["propName"] == "isOpen") {
+        isOpenValues.push_back(update["data"]);
+      }
+    }
+  }
+  REQUIRE(!isOpenValues.empty());
+  REQUIRE(isOpenValues.back() == false);
+  REQUIRE(door.IsOpen() == false);
+
+  DoDisconnect(partOne, 0);
+  partOne.DestroyActor(0xff000000);
+}
+
 TEST_CASE("Activate PurpleMountainFlower in Whiterun", "[PartOne][espm]")
 {
   auto& partOne = GetPartOne();
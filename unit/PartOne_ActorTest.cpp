@@ -2,6 +2,8 @@
 
 using Catch::Matchers::ContainsSubstring;
 
+PartOne& GetPartOne();
+
 TEST_CASE("CreateActor/DestroyActor", "[PartOne]")
 {
 
@@ -87,6 +89,229 @@ TEST_CASE("Use SetUserActor with 0 formId argument", "[PartOne]")
   REQUIRE(partOne.GetUserActor(1) == 0);
 }
 
+TEST_CASE("SetUserActor with join queue activates actors over ticks",
+          "[PartOne]")
+{
+  PartOne partOne;
+  JoinQueueSettings settings;
+  settings.maxActivationsPerTick = 1;
+  partOne.SetJoinQueueSettings(settings);
+
+  for (Networking::UserId userId = 0; userId < 3; ++userId) {
+    DoConnect(partOne, userId);
+    partOne.CreateActor(0xff000000 + userId, { 1.f, 2.f, 3.f }, 180.f, 0x3c);
+    partOne.SetUserActor(userId, 0xff000000 + userId);
+    REQUIRE(partOne.GetUserActor(userId) == 0xff000000 + userId);
+    REQUIRE(partOne.GetJoinQueuePosition(userId) == userId + 1);
+  }
+
+  auto isActivated = [&](Networking::UserId userId) {
+    for (auto& m : partOne.Messages()) {
+      if (m.userId == userId && m.j["type"] == "createActor" &&
+          m.j["isMe"] == true) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  REQUIRE(partOne.Messages().size() == 3);
+  REQUIRE(partOne.Messages()[2].j ==
+          nlohmann::json{ { "type", "joinQueue" }, { "position", 3 } });
+  REQUIRE(!isActivated(0));
+
+  // The position is sent only when it changes
+  partOne.CreateActor(0xff000010, { 1.f, 2.f, 3.f }, 180.f, 0x3c);
+  partOne.SetUserActor(0, 0xff000010);
+  REQUIRE(partOne.GetJoinQueuePosition(0) == 1);
+  REQUIRE(partOne.Messages().size() == 3);
+
+  DoDisconnect(partOne, 1);
+  REQUIRE(partOne.GetJoinQueuePosition(2) == 2);
+
+  partOne.Messages().clear();
+  partOne.Tick();
+  REQUIRE(isActivated(0));
+  REQUIRE(!isActivated(2));
+  REQUIRE(partOne.GetJoinQueuePosition(2) == 1);
+  REQUIRE(partOne.Messages().back().j ==
+          nlohmann::json{ { "type", "joinQueue" }, { "position", 1 } });
+
+  partOne.Messages().clear();
+  partOne.Tick();
+  REQUIRE(isActivated(2));
+  REQUIRE(partOne.GetJoinQueuePosition(2) == 0);
+}
+
+TEST_CASE("Moving a queued actor doesn't activate it", "[PartOne]")
+{
+  PartOne partOne;
+  JoinQueueSettings settings;
+  settings.maxActivationsPerTick = 1;
+  partOne.SetJoinQueueSettings(settings);
+
+  for (Networking::UserId userId = 0; userId < 2; ++userId) {
+    DoConnect(partOne, userId);
+    partOne.CreateActor(0xff000000 + userId, { 1.f, 2.f, 3.f }, 180.f, 0x3c);
+    partOne.SetUserActor(userId, 0xff000000 + userId);
+  }
+  partOne.Tick();
+
+  auto numCreateActor = [&] {
+    return std::count_if(
+      partOne.Messages().begin(), partOne.Messages().end(),
+      [](auto& m) { return m.j["type"] == "createActor"; });
+  };
+
+  auto& ac = partOne.worldState.GetFormAt<MpActor>(0xff000001);
+  REQUIRE(ac.IsUserActivationPending());
+
+  partOne.Messages().clear();
+  ac.SetPos({ 10000.f, 10000.f, 3.f });
+  ac.SetCellOrWorld(FormDesc::Tamriel());
+  ac.Enable();
+  REQUIRE(numCreateActor() == 0);
+  REQUIRE(ac.GetPos() == NiPoint3(10000.f, 10000.f, 3.f));
+
+  partOne.Tick();
+  REQUIRE(!ac.IsUserActivationPending());
+  REQUIRE(numCreateActor() == 1);
+  auto it = std::find_if(
+    partOne.Messages().begin(), partOne.Messages().end(),
+    [](auto& m) { return m.j["type"] == "createActor"; });
+  REQUIRE(it->userId == 1);
+  REQUIRE(it->j["isMe"] == true);
+}
+
+TEST_CASE("Deferred property broadcasts are coalesced per listener",
+          "[PartOne]")
+{
+  PartOne partOne;
+  partOne.worldState.deferPropertyBroadcasts = true;
+
+  for (Networking::UserId userId = 0; userId < 2; ++userId) {
+    DoConnect(partOne, userId);
+    partOne.CreateActor(0xff000000 + userId, { 1.f, 2.f, 3.f }, 180.f, 0x3c);
+    partOne.SetUserActor(userId, 0xff000000 + userId);
+  }
+
+  auto& ac0 = partOne.worldState.GetFormAt<MpActor>(0xff000000);
+  auto& ac1 = partOne.worldState.GetFormAt<MpActor>(0xff000001);
+  partOne.Messages().clear();
+
+  ac0.SetProperty("myProp", 1, true, true);
+  ac0.SetProperty("otherProp", "x", true, true);
+  ac0.SetProperty("myProp", 2, true, true);
+  ac1.SetProperty("ownerProp", true, true, false);
+  REQUIRE(partOne.Messages().empty());
+
+  partOne.Tick();
+
+  auto findBatch = [&](Networking::UserId userId) {
+    auto it = std::find_if(
+      partOne.Messages().begin(), partOne.Messages().end(), [&](auto& m) {
+        return m.userId == userId && m.j["t"] == MsgType::UpdatePropertyBatch;
+      });
+    REQUIRE(it != partOne.Messages().end());
+    REQUIRE(it->reliable);
+    return it->j["updates"];
+  };
+
+  auto updates0 = findBatch(0);
+  REQUIRE(updates0.size() == 2);
+  REQUIRE(updates0[0]["propName"] == "myProp");
+  REQUIRE(updates0[0]["data"] == 2);
+  REQUIRE(updates0[0]["idx"] == ac0.GetIdx());
+  REQUIRE(updates0[0]["t"] == MsgType::UpdateProperty);
+  REQUIRE(updates0[1]["propName"] == "otherProp");
+
+  auto updates1 = findBatch(1);
+  REQUIRE(updates1.size() == 3);
+  REQUIRE(updates1[2]["propName"] == "ownerProp");
+  REQUIRE(updates1[2]["data"] == true);
+  REQUIRE(updates1[2]["idx"] == ac1.GetIdx());
+
+  partOne.Messages().clear();
+  partOne.Tick();
+  REQUIRE(partOne.Messages().empty());
+}
+
+TEST_CASE("PlaceReferences subscribes a batch once it is complete",
+          "[PartOne][espm]")
+{
+  auto& partOne = GetPartOne();
+
+  DoConnect(partOne, 0);
+  partOne.CreateActor(0xff000000, { 1.f, 2.f, 3.f }, 0, 0x3c);
+  partOne.SetUserActor(0, 0xff000000);
+  partOne.Messages().clear();
+
+  std::vector<PlaceRequest> requests(2);
+  requests[0].baseId = 0xf; // Gold001
+  requests[0].locationalData.pos = { 10.f, 20.f, 30.f };
+  requests[1].baseId = 0x7; // Player
+  requests[1].locationalData.pos = { 40.f, 50.f, 60.f };
+  requests[1].locationalData.rot = { 0.f, 0.f, 90.f };
+
+  auto formIds = partOne.PlaceReferences(
+    requests, [&](MpObjectReference& refr, size_t requestIndex) {
+      REQUIRE(refr.GetListeners().empty());
+      REQUIRE(partOne.Messages().empty());
+      refr.SetProperty("placeIndex", requestIndex, true, true);
+    });
+  REQUIRE(formIds.size() == 2);
+  REQUIRE(!dynamic_cast<MpActor*>(
+    partOne.worldState.LookupFormById(formIds[0]).get()));
+  REQUIRE(dynamic_cast<MpActor*>(
+    partOne.worldState.LookupFormById(formIds[1]).get()));
+
+  for (size_t i = 0; i < formIds.size(); ++i) {
+    std::vector<PartOne::Message> createMessages;
+    std::copy_if(partOne.Messages().begin(), partOne.Messages().end(),
+                 std::back_inserter(createMessages), [&](auto& m) {
+                   return m.userId == 0 && m.j["type"] == "createActor" &&
+                     m.j["refrId"] == formIds[i];
+                 });
+    REQUIRE(createMessages.size() == 1);
+
+    auto& j = createMessages[0].j;
+    auto& pos = requests[i].locationalData.pos;
+    REQUIRE(j["transform"]["pos"] ==
+            nlohmann::json{ pos.x, pos.y, pos.z });
+    REQUIRE(j["props"]["placeIndex"] == i);
+  }
+
+  REQUIRE_THROWS_WITH(partOne.PlaceReferences({ PlaceRequest{ 0xdeadbeef } }),
+                      ContainsSubstring("Bad record Id"));
+
+  // A failing hook destroys the whole batch
+  partOne.Messages().clear();
+  std::vector<uint32_t> failedFormIds;
+  REQUIRE_THROWS_WITH(
+    partOne.PlaceReferences(
+      requests,
+      [&](MpObjectReference& refr, size_t requestIndex) {
+        failedFormIds.push_back(refr.GetFormId());
+        if (requestIndex == 1) {
+          throw std::runtime_error("hook failed");
+        }
+      }),
+    ContainsSubstring("hook failed"));
+  REQUIRE(failedFormIds.size() == 2);
+  for (auto formId : failedFormIds) {
+    REQUIRE(!partOne.worldState.LookupFormById(formId));
+  }
+  REQUIRE(std::none_of(
+    partOne.Messages().begin(), partOne.Messages().end(),
+    [&](auto& m) { return m.j["type"] == "createActor"; }));
+
+  for (auto formId : formIds) {
+    partOne.worldState.DestroyForm<MpObjectReference>(formId);
+  }
+  DoDisconnect(partOne, 0);
+  partOne.DestroyActor(0xff000000);
+}
+
 TEST_CASE("SetUserActor failures", "[PartOne]")
 {
   PartOne partOne;
@@ -0,0 +1,36 @@
+#include <catch2/catch_all.hpp>
+
+#include "PropertyUpdateQueue.h"
+
+TEST_CASE("PropertyUpdateQueue keeps the last value of each property",
+          "[PropertyUpdateQueue]")
+{
+  PropertyUpdateQueue queue;
+  REQUIRE(queue.Empty());
+
+  queue.Push(0x14, "isOpen", true, true);
+  queue.Push(0xff000000, "isOpen", true, true);
+  queue.Push(0x14, "isHarvested", true, true);
+  queue.Push(0x14, "isOpen", false, true);
+  REQUIRE(!queue.Empty());
+
+  auto updates = queue.Take();
+  REQUIRE(queue.Empty());
+  REQUIRE(updates.size() == 3);
+
+  REQUIRE(updates[0].refrId == 0x14);
+  REQUIRE(updates[0].propName == "isOpen");
+  REQUIRE(updates[0].value == false);
+
+  REQUIRE(updates[1].refrId == 0xff000000);
+  REQUIRE(updates[1].propName == "isOpen");
+  REQUIRE(updates[1].value == true);
+
+  REQUIRE(updates[2].refrId == 0x14);
+  REQUIRE(updates[2].propName == "isHarvested");
+
+  queue.Push(0x14, "isOpen", true, true);
+  updates = queue.Take();
+  REQUIRE(updates.size() == 1);
+  REQUIRE(updates[0].value == true);
+}
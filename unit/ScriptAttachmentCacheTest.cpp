@@ -0,0 +1,79 @@
+#include "ScriptAttachmentCache.h"
+#include "ScriptStorage.h"
+#include "TestUtils.hpp"
+#include <catch2/catch_all.hpp>
+
+extern espm::Loader l;
+
+namespace {
+class FakeScriptStorage : public IScriptStorage
+{
+public:
+  std::vector<uint8_t> GetScriptPex(const char*) override { return {}; }
+
+  const std::set<CIString>& ListScripts(bool) override
+  {
+    ++numListScriptsCalls;
+    return scripts;
+  }
+
+  std::set<CIString> scripts;
+  size_t numListScriptsCalls = 0;
+};
+}
+
+TEST_CASE("ScriptAttachmentCache decodes base record scripts once",
+          "[ScriptAttachmentCache][espm]")
+{
+  auto& br = l.GetBrowser();
+  espm::CompressedFieldsCache compressedFieldsCache;
+  FakeScriptStorage scriptStorage;
+  scriptStorage.scripts = { "trapbear" };
+
+  ScriptAttachmentCache cache;
+  auto bearTrap = br.LookupById(0x7144d);
+  auto attachments = cache.Get(bearTrap, compressedFieldsCache, scriptStorage);
+
+  REQUIRE(attachments);
+  REQUIRE(attachments->available.size() == 1);
+  REQUIRE(attachments->available[0]->scriptName == "TrapBear");
+  REQUIRE(attachments->available[0]->properties.count(
+    espm::Property::Int("LvlDamage1", 20)));
+  REQUIRE(attachments->missing.size() == 1);
+  REQUIRE(attachments->missing[0]->scriptName == "TrapHitBase");
+
+  // Storage changes are not picked up until the cache is cleared
+  scriptStorage.scripts.insert("traphitbase");
+  REQUIRE(cache.Get(bearTrap, compressedFieldsCache, scriptStorage) ==
+          attachments);
+
+  cache.Clear();
+  REQUIRE(cache.Get(bearTrap, compressedFieldsCache, scriptStorage)
+            ->available.size() == 2);
+
+  REQUIRE(!cache.Get({}, compressedFieldsCache, scriptStorage));
+}
+
+TEST_CASE("ScriptAttachmentCache lists script names once",
+          "[ScriptAttachmentCache]")
+{
+  FakeScriptStorage scriptStorage;
+  scriptStorage.scripts = { "trapbear" };
+
+  ScriptAttachmentCache cache;
+  REQUIRE(cache.IsInStorage("TrapBear", scriptStorage));
+  REQUIRE(!cache.IsInStorage("TrapHitBase", scriptStorage));
+  REQUIRE(scriptStorage.numListScriptsCalls == 1);
+
+  scriptStorage.scripts.insert("traphitbase");
+  REQUIRE(!cache.IsInStorage("TrapHitBase", scriptStorage));
+
+  cache.ResetScriptNames();
+  REQUIRE(cache.IsInStorage("TrapHitBase", scriptStorage));
+  REQUIRE(scriptStorage.numListScriptsCalls == 2);
+
+  REQUIRE(cache.ShouldReportMissing("MissingScript"));
+  REQUIRE(!cache.ShouldReportMissing("missingscript"));
+  cache.Clear();
+  REQUIRE(cache.ShouldReportMissing("MissingScript"));
+}
@@ -0,0 +1,56 @@
+#include "TestUtils.hpp"
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+
+#include "SpSnippet.h"
+
+TEST_CASE("ExecuteBroadcast sends the same payload as Execute", "[SpSnippet]")
+{
+  PartOne p;
+
+  p.CreateActor(0xff000000, { 0, 0, 0 }, 0, 0x3c);
+  p.CreateActor(0xff000001, { 0, 0, 0 }, 0, 0x3c);
+  auto& ac0 = p.worldState.GetFormAt<MpActor>(0xff000000);
+  auto& ac1 = p.worldState.GetFormAt<MpActor>(0xff000001);
+
+  auto refr = std::make_unique<MpObjectReference>(
+    LocationalData(), FormCallbacks::DoNothing(), 0, "CONT");
+  p.worldState.AddForm(std::move(refr), 0xff000002);
+  auto& ref = p.worldState.GetFormAt<MpObjectReference>(0xff000002);
+
+  DoConnect(p, 0);
+  p.SetUserActor(0, 0xff000000);
+  DoConnect(p, 1);
+  p.SetUserActor(1, 0xff000001);
+  p.Messages().clear();
+
+  SpSnippet snippet("Actor", "SetAlpha", "[0.5,false]", 0xff000000);
+  (void)snippet.Execute(&ac0);
+  (void)snippet.Execute(&ac1);
+
+  // Non-actor listeners are skipped
+  snippet.ExecuteBroadcast({ &ac0, &ac1, &ref });
+
+  REQUIRE(p.Messages().size() == 4);
+  for (size_t i = 0; i < 2; ++i) {
+    auto& executed = p.Messages()[i];
+    auto it =
+      std::find_if(p.Messages().begin() + 2, p.Messages().end(),
+                   [&](auto& m) { return m.userId == executed.userId; });
+    REQUIRE(it != p.Messages().end());
+    REQUIRE(it->reliable);
+
+    auto expected = executed.j;
+    expected["snippetIdx"] = expected["snippetIdx"].get<uint32_t>() + 1;
+    REQUIRE(it->j == expected);
+  }
+
+  // The player's own actor is 0x14 on its client
+  REQUIRE(p.Messages()[0].j["selfId"] == 0x14);
+  REQUIRE(p.Messages()[1].j["selfId"] == 0xff000000);
+
+  DoDisconnect(p, 0);
+  DoDisconnect(p, 1);
+  p.DestroyActor(0xff000000);
+  p.DestroyActor(0xff000001);
+}
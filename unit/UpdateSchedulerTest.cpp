@@ -0,0 +1,89 @@
+#include <catch2/catch_all.hpp>
+
+#include "UpdateScheduler.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+std::vector<uint32_t> ToFormIds(
+  const std::vector<UpdateScheduler::DueUpdate>& updates)
+{
+  std::vector<uint32_t> res;
+  for (auto& update : updates) {
+    res.push_back(update.formId);
+  }
+  return res;
+}
+}
+
+TEST_CASE("UpdateScheduler pops due updates in order", "[UpdateScheduler]")
+{
+  UpdateScheduler scheduler;
+  UpdateScheduler::Clock::time_point t0;
+
+  scheduler.Register(0xff000000, t0 + 10ms);
+  scheduler.Register(0xff000002, t0 + 12ms);
+  scheduler.Register(0xff000001, t0 + 11ms);
+  REQUIRE(scheduler.GetSize() == 3);
+
+  REQUIRE(scheduler.PopDue(t0 + 9ms).empty());
+  REQUIRE(ToFormIds(scheduler.PopDue(t0 + 11ms)) ==
+          std::vector<uint32_t>{ 0xff000000, 0xff000001 });
+  REQUIRE(!scheduler.IsRegistered(0xff000000));
+  REQUIRE(ToFormIds(scheduler.PopDue(t0 + 20ms)) ==
+          std::vector<uint32_t>{ 0xff000002 });
+  REQUIRE(scheduler.GetSize() == 0);
+}
+
+TEST_CASE("UpdateScheduler replaces registrations", "[UpdateScheduler]")
+{
+  UpdateScheduler scheduler;
+  UpdateScheduler::Clock::time_point t0;
+
+  scheduler.Register(0x14, t0 + 10ms);
+  scheduler.Register(0x14, t0 + 30ms);
+  REQUIRE(scheduler.GetSize() == 1);
+  REQUIRE(scheduler.PopDue(t0 + 20ms).empty());
+  REQUIRE(scheduler.PopDue(t0 + 30ms).size() == 1);
+
+  scheduler.Register(0x14, t0 + 40ms);
+  scheduler.Unregister(0x14);
+  REQUIRE(scheduler.PopDue(t0 + 50ms).empty());
+}
+
+TEST_CASE("UpdateScheduler reschedules repeating updates",
+          "[UpdateScheduler]")
+{
+  UpdateScheduler scheduler;
+  UpdateScheduler::Clock::time_point t0;
+
+  scheduler.Register(0x14, t0 + 10ms, 10ms);
+
+  auto updates = scheduler.PopDue(t0 + 10ms);
+  REQUIRE(updates.size() == 1);
+  REQUIRE(updates[0].isRepeating);
+  REQUIRE(scheduler.IsRegistered(0x14));
+  REQUIRE(scheduler.PopDue(t0 + 19ms).empty());
+
+  // Missed intervals are not caught up
+  REQUIRE(scheduler.PopDue(t0 + 55ms).size() == 1);
+  REQUIRE(scheduler.PopDue(t0 + 59ms).empty());
+  REQUIRE(scheduler.PopDue(t0 + 60ms).size() == 1);
+}
+
+TEST_CASE("UpdateScheduler respects the limit", "[UpdateScheduler]")
+{
+  UpdateScheduler scheduler;
+  UpdateScheduler::Clock::time_point t0;
+
+  for (uint32_t formId = 0; formId < 5; ++formId) {
+    scheduler.Register(formId, t0 + std::chrono::milliseconds(formId));
+  }
+
+  REQUIRE(ToFormIds(scheduler.PopDue(t0 + 10ms, 2)) ==
+          std::vector<uint32_t>{ 0, 1 });
+  REQUIRE(ToFormIds(scheduler.PopDue(t0 + 10ms, 2)) ==
+          std::vector<uint32_t>{ 2, 3 });
+  REQUIRE(ToFormIds(scheduler.PopDue(t0 + 10ms, 2)) ==
+          std::vector<uint32_t>{ 4 });
+}
@@ -208,10 +208,33 @@ TEST_CASE("String assign", "[VarValue]")
   VarValue x(std::string("123"));
   VarValue y;
   y = x;
-  *x.stringHolder = "456";
+  REQUIRE(y.stringHolder == x.stringHolder);
+
+  // Shared string is copied before appending
+  x.AppendString(VarValue("456"));
+  REQUIRE(static_cast<const char*>(x) == std::string("123456"));
   REQUIRE(static_cast<const char*>(y) == std::string("123"));
 }
 
+TEST_CASE("strcat appends in place to unshared strings", "[VarValue]")
+{
+  VarValue s(std::string("a"));
+  auto holder = s.stringHolder.get();
+
+  for (int i = 0; i < 3; ++i) {
+    OpcodesImplementation::StrCat(s, s, VarValue(i));
+  }
+  REQUIRE(s.stringHolder.get() == holder);
+  REQUIRE(static_cast<const char*>(s) == std::string("a012"));
+
+  OpcodesImplementation::StrCat(s, s, s);
+  REQUIRE(static_cast<const char*>(s) == std::string("a012a012"));
+
+  VarValue t;
+  OpcodesImplementation::StrCat(t, VarValue(1.5), VarValue(true));
+  REQUIRE(static_cast<const char*>(t) == std::string("1.5True"));
+}
+
 TEST_CASE("Mixed arithmetics", "[VarValue]")
 {
   std::stringstream ss;
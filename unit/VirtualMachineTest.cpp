@@ -228,3 +228,51 @@ TEST_CASE("Test nested latent calls", "[VirtualMachine]")
 
   REQUIRE(result == VarValue(6));
 }
+
+TEST_CASE("Prepared calls", "[VirtualMachine]")
+{
+  class TestObject : public IGameObject
+  {
+  public:
+    const char* GetParentNativeScript() override { return "TestClass"; }
+  };
+
+  VirtualMachine vm(std::vector<std::shared_ptr<PexScript>>{});
+
+  vm.RegisterFunction("TestClass", "Add", FunctionType::GlobalFunction,
+                      [](VarValue, std::vector<VarValue> args) {
+                        return VarValue(static_cast<int>(args[0]) +
+                                        static_cast<int>(args[1]));
+                      });
+  vm.RegisterFunction("TestClass", "GetId", FunctionType::Method,
+                      [](VarValue self, std::vector<VarValue>) {
+                        return VarValue(1);
+                      });
+
+  auto add = vm.PrepareCall(FunctionType::GlobalFunction, "testclass", "ADD");
+  auto getId = vm.PrepareCall(FunctionType::Method, "", "getid");
+
+  std::vector<VarValue> args = { VarValue(2), VarValue(3) };
+  REQUIRE(vm.CallPrepared(*add, nullptr, args) == VarValue(5));
+
+  TestObject object;
+  std::vector<VarValue> noArgs;
+  REQUIRE(vm.CallPrepared(*getId, &object, noArgs) == VarValue(1));
+  REQUIRE(vm.CallPrepared(*getId, nullptr, noArgs) == VarValue::None());
+
+  // Registering functions invalidates prepared calls
+  vm.RegisterFunction("TestClass", "GetId", FunctionType::Method,
+                      [](VarValue self, std::vector<VarValue>) {
+                        return VarValue(2);
+                      });
+  REQUIRE(vm.CallPrepared(*getId, &object, noArgs) == VarValue(2));
+
+  REQUIRE_THROWS_WITH(
+    vm.PrepareCall(FunctionType::GlobalFunction, "MissingClass", "Foo"),
+    Catch::Matchers::ContainsSubstring("script is missing - 'MissingClass'"));
+
+  auto missingMethod = vm.PrepareCall(FunctionType::Method, "", "Foo");
+  REQUIRE_THROWS_WITH(
+    vm.CallPrepared(*missingMethod, &object, noArgs),
+    Catch::Matchers::ContainsSubstring("Method not found - 'TestClass.Foo'"));
+}
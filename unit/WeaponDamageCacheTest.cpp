@@ -0,0 +1,31 @@
+#include "WeaponDamageCache.h"
+#include "TestUtils.hpp"
+#include <catch2/catch_all.hpp>
+
+extern espm::Loader l;
+
+TEST_CASE("WeaponDamageCache reads WEAP damage once",
+          "[WeaponDamageCache][espm]")
+{
+  auto& br = l.GetBrowser();
+  espm::CompressedFieldsCache compressedFieldsCache;
+  WeaponDamageCache cache;
+
+  constexpr uint32_t ironSword = 0x12eb7, ironDagger = 0x1397e;
+
+  auto& sword = cache.Get(ironSword, br, compressedFieldsCache);
+  REQUIRE(sword.exists);
+  REQUIRE(sword.isWeapon);
+  REQUIRE(sword.damage == 7);
+  REQUIRE(&cache.Get(ironSword, br, compressedFieldsCache) == &sword);
+
+  auto& dagger = cache.Get(ironDagger, br, compressedFieldsCache);
+  REQUIRE(dagger.isWeapon);
+  REQUIRE(dagger.damage == 4);
+
+  auto& player = cache.Get(0x7, br, compressedFieldsCache);
+  REQUIRE(player.exists);
+  REQUIRE(!player.isWeapon);
+
+  REQUIRE(!cache.Get(0xdeadbeef, br, compressedFieldsCache).exists);
+}
@@ -0,0 +1,170 @@
+#include "TestUtils.hpp"
+
+#include "AsyncSaveStorage.h"
+#include "FileDatabase.h"
+#include "WorldSnapshot.h"
+#include <filesystem>
+
+namespace {
+std::filesystem::path MakeSnapshotTestDirectory()
+{
+  auto directory =
+    std::filesystem::temp_directory_path() / "skymp_world_snapshot_test";
+  std::filesystem::remove_all(directory);
+  return directory;
+}
+
+MpChangeForm MakeChangeForm(uint32_t formId, const NiPoint3& pos)
+{
+  MpChangeForm res;
+  res.formDesc = FormDesc::FromFormId(formId, {});
+  res.position = pos;
+  return res;
+}
+
+std::map<FormDesc, MpChangeForm> ReadSnapshot(
+  const std::filesystem::path& path)
+{
+  std::map<FormDesc, MpChangeForm> res;
+  WorldSnapshotUtils::Read(path, [&](const MpChangeForm& changeForm) {
+    REQUIRE(res.count(changeForm.formDesc) == 0);
+    res[changeForm.formDesc] = changeForm;
+  });
+  return res;
+}
+}
+
+TEST_CASE("WorldSnapshotWriter writes change forms readable by Read",
+          "[WorldSnapshot]")
+{
+  auto directory = MakeSnapshotTestDirectory();
+  auto path = directory / "snapshot.gz";
+
+  {
+    WorldSnapshotWriter writer(path);
+    writer.Write(MakeChangeForm(0xff000000, { 1, 2, 3 }));
+    writer.Write(MakeChangeForm(0xff000001, { 4, 5, 6 }));
+
+    // Nothing is visible until Finish
+    REQUIRE(!std::filesystem::exists(path));
+    writer.Finish();
+    REQUIRE(writer.GetNumWritten() == 2);
+  }
+
+  auto res = ReadSnapshot(path);
+  REQUIRE(res.size() == 2);
+  REQUIRE(res[FormDesc::FromFormId(0xff000001, {})].position ==
+          NiPoint3(4, 5, 6));
+
+  // Unfinished snapshot doesn't replace the previous one
+  {
+    WorldSnapshotWriter writer(path);
+    writer.Write(MakeChangeForm(0xff000002, { 7, 8, 9 }));
+  }
+  REQUIRE(ReadSnapshot(path).size() == 2);
+  REQUIRE(std::distance(std::filesystem::directory_iterator(directory),
+                        std::filesystem::directory_iterator()) == 1);
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("CreateSnapshot captures saved and pending change forms",
+          "[WorldSnapshot]")
+{
+  auto directory = MakeSnapshotTestDirectory();
+  auto st = std::make_shared<AsyncSaveStorage>(std::make_shared<FileDatabase>(
+    (directory / "db").string(), spdlog::default_logger()));
+
+  PartOne p;
+  p.AttachSaveStorage(st);
+
+  const uint32_t actorId = 0xffaaaeee;
+
+  bool upserted = false;
+  st->Upsert({ MakeChangeForm(0xff000000, { 1, 1, 1 }),
+               MakeChangeForm(actorId, { 9, 9, 9 }) },
+             [&] { upserted = true; });
+
+  // Pending change form of the actor must replace the saved one
+  p.CreateActor(actorId, { 2, 2, 2 }, 1, 0x3c);
+
+  std::optional<size_t> numWritten;
+  p.worldState.CreateSnapshot(directory / "snapshot.gz")
+    .Then([&](size_t n) { numWritten = n; })
+    .Catch([&](const char* e) { FAIL(e); });
+
+  // Changes made after CreateSnapshot are not in the snapshot
+  p.CreateActor(0xffaaaeef, { 3, 3, 3 }, 1, 0x3c);
+
+  for (int i = 0; !numWritten; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    p.Tick();
+    if (i > 2000)
+      throw std::runtime_error("Timeout exceeded");
+  }
+
+  REQUIRE(upserted);
+  REQUIRE(*numWritten == 2);
+
+  auto res = ReadSnapshot(directory / "snapshot.gz");
+  REQUIRE(res.size() == 2);
+  REQUIRE(res[FormDesc::FromFormId(0xff000000, {})].position ==
+          NiPoint3(1, 1, 1));
+  REQUIRE(res[FormDesc::FromFormId(actorId, {})].position ==
+          NiPoint3(2, 2, 2));
+
+  std::filesystem::remove_all(directory);
+}
+
+namespace {
+class UpsertFailingDatabase : public IDatabase
+{
+public:
+  size_t Upsert(const std::vector<MpChangeForm>&) override
+  {
+    throw std::runtime_error("Upsert failed");
+  }
+
+  void Iterate(const IterateCallback&) override {}
+};
+}
+
+TEST_CASE("CreateSnapshot fails if an upsert before it failed",
+          "[WorldSnapshot]")
+{
+  auto directory = MakeSnapshotTestDirectory();
+  auto st = std::make_shared<AsyncSaveStorage>(
+    std::make_shared<UpsertFailingDatabase>());
+
+  PartOne p;
+  p.AttachSaveStorage(st);
+
+  bool upserted = false;
+  st->Upsert({ MakeChangeForm(0xff000000, { 1, 1, 1 }) },
+             [&] { upserted = true; });
+
+  std::optional<std::string> error;
+  p.worldState.CreateSnapshot(directory / "snapshot.gz")
+    .Then([&](size_t) { FAIL("Snapshot must not be written"); })
+    .Catch([&](const char* e) { error = e; });
+
+  size_t numTickErrors = 0;
+  for (int i = 0; !error; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    try {
+      p.Tick();
+    } catch (std::exception& e) {
+      REQUIRE(std::string(e.what()) == "Upsert failed");
+      ++numTickErrors;
+    }
+    if (i > 2000)
+      throw std::runtime_error("Timeout exceeded");
+  }
+
+  REQUIRE(*error == "Upsert failed");
+  REQUIRE(numTickErrors == 1);
+  REQUIRE(!upserted);
+  REQUIRE(!std::filesystem::exists(directory / "snapshot.gz"));
+
+  std::filesystem::remove_all(directory);
+}
@@ -144,3 +144,45 @@ TEST_CASE("Loads VirtualMachine with all scripts", "[WorldState]")
   auto& p = GetPartOne();
   p.worldState.GetPapyrusVm();
 }
+
+TEST_CASE("FindReferencesInRadius", "[WorldState]")
+{
+  PartOne partOne;
+  partOne.CreateActor(0xff000000, { 0.f, 0.f, 0.f }, 0.f, 0x3c);
+  partOne.CreateActor(0xff000001, { 100.f, 0.f, 0.f }, 0.f, 0x3c);
+  partOne.CreateActor(0xff000002, { 5000.f, 5000.f, 0.f }, 0.f, 0x3c);
+  partOne.CreateActor(0xff000003, { -20000.f, 0.f, 0.f }, 0.f, 0x3c);
+  partOne.CreateActor(0xff000004, { 50.f, 0.f, 0.f }, 0.f, 0x1);
+
+  auto find = [&](const NiPoint3& pos, float radius,
+                  const WorldState::ReferenceFilter& filter = nullptr) {
+    std::set<uint32_t> res;
+    auto& worldState = partOne.worldState;
+    for (auto refr : worldState.FindReferencesInRadius(0x3c, pos, radius,
+                                                       filter)) {
+      res.insert(refr->GetFormId());
+    }
+    return res;
+  };
+
+  REQUIRE(find({ 0.f, 0.f, 0.f }, 150.f) ==
+          std::set<uint32_t>{ 0xff000000, 0xff000001 });
+  REQUIRE(find({ 0.f, 0.f, 0.f }, 8000.f) ==
+          std::set<uint32_t>{ 0xff000000, 0xff000001, 0xff000002 });
+  REQUIRE(find({ 0.f, 0.f, 0.f }, 30000.f).size() == 4);
+  REQUIRE(find({ -20000.f, 0.f, 0.f }, 1.f) ==
+          std::set<uint32_t>{ 0xff000003 });
+  REQUIRE(find({ 0.f, 0.f, 0.f }, -1.f).empty());
+
+  REQUIRE(find({ 0.f, 0.f, 0.f }, 150.f,
+               [](const MpObjectReference& refr) {
+                 return refr.GetFormId() != 0xff000000;
+               }) == std::set<uint32_t>{ 0xff000001 });
+
+  // Moved references are found at their new position
+  partOne.worldState.GetFormAt<MpActor>(0xff000001).SetPos(
+    { 12000.f, 0.f, 0.f });
+  REQUIRE(find({ 12000.f, 0.f, 0.f }, 10.f) ==
+          std::set<uint32_t>{ 0xff000001 });
+  REQUIRE(find({ 0.f, 0.f, 0.f }, 150.f) == std::set<uint32_t>{ 0xff000000 });
+}
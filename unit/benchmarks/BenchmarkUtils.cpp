@@ -0,0 +1,153 @@
+#include "BenchmarkUtils.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+constexpr size_t kRecordHeaderSize = 24;
+constexpr size_t kGroupHeaderSize = 24;
+}
+
+SyntheticPluginBuilder& SyntheticPluginBuilder::BeginGroup(
+  const char* recordsType)
+{
+  openGroups.push_back(data.size());
+
+  const uint32_t size = 0, groupType = 0, stamp = 0, version = 0;
+  Append("GRUP", 4);
+  Append(&size, 4);
+  Append(recordsType, 4);
+  Append(&groupType, 4);
+  Append(&stamp, 4);
+  Append(&version, 4);
+  return *this;
+}
+
+SyntheticPluginBuilder& SyntheticPluginBuilder::EndGroup()
+{
+  if (openGroups.empty()) {
+    throw std::logic_error("EndGroup without BeginGroup");
+  }
+  const size_t start = openGroups.back();
+  openGroups.pop_back();
+  PatchUInt32(start + 4, static_cast<uint32_t>(data.size() - start));
+  return *this;
+}
+
+SyntheticPluginBuilder& SyntheticPluginBuilder::BeginRecord(const char* type,
+                                                            uint32_t formId)
+{
+  if (isRecordOpen) {
+    throw std::logic_error("Nested records are not allowed");
+  }
+  openRecord = data.size();
+  isRecordOpen = true;
+
+  const uint32_t size = 0, flags = 0, revision = 0, version = 0;
+  Append(type, 4);
+  Append(&size, 4);
+  Append(&flags, 4);
+  Append(&formId, 4);
+  Append(&revision, 4);
+  Append(&version, 4);
+  return *this;
+}
+
+SyntheticPluginBuilder& SyntheticPluginBuilder::AddField(const char* type,
+                                                         const void* fieldData,
+                                                         uint16_t size)
+{
+  Append(type, 4);
+  Append(&size, 2);
+  Append(fieldData, size);
+  return *this;
+}
+
+SyntheticPluginBuilder& SyntheticPluginBuilder::AddField(
+  const char* type, const std::string& str)
+{
+  return AddField(type, str.data(), static_cast<uint16_t>(str.size() + 1));
+}
+
+SyntheticPluginBuilder& SyntheticPluginBuilder::AddField(const char* type,
+                                                         uint32_t value)
+{
+  return AddField(type, &value, sizeof(value));
+}
+
+SyntheticPluginBuilder& SyntheticPluginBuilder::EndRecord()
+{
+  if (!isRecordOpen) {
+    throw std::logic_error("EndRecord without BeginRecord");
+  }
+  isRecordOpen = false;
+  PatchUInt32(openRecord + 4,
+              static_cast<uint32_t>(data.size() - openRecord -
+                                    kRecordHeaderSize));
+  return *this;
+}
+
+const std::vector<uint8_t>& SyntheticPluginBuilder::GetData() const
+{
+  return data;
+}
+
+void SyntheticPluginBuilder::Append(const void* src, size_t size)
+{
+  auto p = reinterpret_cast<const uint8_t*>(src);
+  data.insert(data.end(), p, p + size);
+}
+
+void SyntheticPluginBuilder::PatchUInt32(size_t offset, uint32_t value)
+{
+  memcpy(data.data() + offset, &value, sizeof(value));
+}
+
+std::vector<uint8_t> MakeSyntheticPlugin(uint32_t numRecordsPerType,
+                                         uint32_t formListSize)
+{
+  SyntheticPluginBuilder builder;
+
+  // espm::Combiner requires TES4 record with id 0
+  struct
+  {
+    float version = 1.7f;
+    int32_t numRecords = 0;
+    uint32_t nextObjectId = 0;
+  } hedr;
+  hedr.numRecords = static_cast<int32_t>(numRecordsPerType * 3);
+  builder.BeginRecord("TES4", 0)
+    .AddField("HEDR", &hedr, sizeof(hedr))
+    .EndRecord();
+
+  builder.BeginGroup("KYWD");
+  for (uint32_t i = 0; i < numRecordsPerType; ++i) {
+    builder.BeginRecord("KYWD", kSyntheticKeywordBase + i)
+      .AddField("EDID", "BenchKeyword" + std::to_string(i))
+      .EndRecord();
+  }
+  builder.EndGroup();
+
+  builder.BeginGroup("MISC");
+  for (uint32_t i = 0; i < numRecordsPerType; ++i) {
+    builder.BeginRecord("MISC", kSyntheticMiscBase + i)
+      .AddField("EDID", "BenchMisc" + std::to_string(i))
+      .AddField("KSIZ", 1u)
+      .AddField("KWDA", kSyntheticKeywordBase + i)
+      .EndRecord();
+  }
+  builder.EndGroup();
+
+  builder.BeginGroup("FLST");
+  for (uint32_t i = 0; i < numRecordsPerType; ++i) {
+    builder.BeginRecord("FLST", kSyntheticFormListBase + i)
+      .AddField("EDID", "BenchFormList" + std::to_string(i));
+    for (uint32_t j = 0; j < formListSize; ++j) {
+      builder.AddField("LNAM",
+                       kSyntheticMiscBase + (i + j) % numRecordsPerType);
+    }
+    builder.EndRecord();
+  }
+  builder.EndGroup();
+
+  return builder.GetData();
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "NetworkingInterface.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Utilities for benchmarking
+
+class EmptySendTarget : public Networking::ISendTarget
+{
+public:
+  void Send(Networking::UserId targetUserId, Networking::PacketData data,
+            size_t length, bool reliable) override
+  {
+  }
+};
+
+// Builds an in-memory plugin for espm::Browser. Layout follows the real
+// format: GRUP headers followed by records with subrecord fields
+class SyntheticPluginBuilder
+{
+public:
+  SyntheticPluginBuilder& BeginGroup(const char* recordsType);
+  SyntheticPluginBuilder& EndGroup();
+
+  SyntheticPluginBuilder& BeginRecord(const char* type, uint32_t formId);
+  SyntheticPluginBuilder& AddField(const char* type, const void* data,
+                                   uint16_t size);
+  SyntheticPluginBuilder& AddField(const char* type, const std::string& str);
+  SyntheticPluginBuilder& AddField(const char* type, uint32_t value);
+  SyntheticPluginBuilder& EndRecord();
+
+  const std::vector<uint8_t>& GetData() const;
+
+private:
+  void Append(const void* data, size_t size);
+  void PatchUInt32(size_t offset, uint32_t value);
+
+  std::vector<uint8_t> data;
+  std::vector<size_t> openGroups;
+  size_t openRecord = 0;
+  bool isRecordOpen = false;
+};
+
+// TES4 header and groups of KYWD, MISC and FLST records with editor ids.
+// Each FLST contains formListSize MISC ids
+std::vector<uint8_t> MakeSyntheticPlugin(uint32_t numRecordsPerType,
+                                         uint32_t formListSize = 16);
+
+constexpr uint32_t kSyntheticKeywordBase = 0x00010000;
+constexpr uint32_t kSyntheticMiscBase = 0x00100000;
+constexpr uint32_t kSyntheticFormListBase = 0x00200000;
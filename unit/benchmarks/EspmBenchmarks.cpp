@@ -0,0 +1,36 @@
+#include "BenchmarkUtils.h"
+#include "libespm/Combiner.h"
+#include "libespm/espm.h"
+#include <catch2/catch_all.hpp>
+
+TEST_CASE("espm::Browser", "[Benchmarks][espm]")
+{
+  for (uint32_t numRecordsPerType : { 100, 1000, 10000 }) {
+    const auto suffix =
+      ", " + std::to_string(numRecordsPerType * 3) + " records";
+    const auto plugin = MakeSyntheticPlugin(numRecordsPerType);
+
+    BENCHMARK("Construct" + suffix)
+    {
+      espm::Browser browser(plugin.data(), plugin.size());
+      return browser.LookupById(kSyntheticMiscBase) != nullptr;
+    };
+
+    espm::Browser browser(plugin.data(), plugin.size());
+    espm::CompressedFieldsCache cache;
+
+    BENCHMARK("LookupById" + suffix)
+    {
+      return browser.LookupById(kSyntheticMiscBase + numRecordsPerType / 2);
+    };
+
+    BENCHMARK("GetRecordsByType + GetEditorId scan" + suffix)
+    {
+      size_t n = 0;
+      for (auto rec : browser.GetRecordsByType("KYWD")) {
+        n += rec->GetEditorId(cache)[0] == 'B';
+      }
+      return n;
+    };
+  }
+}
@@ -0,0 +1,117 @@
+#include "BenchmarkUtils.h"
+#include "Grid.h"
+#include "MpObjectReference.h"
+#include "TestUtils.hpp"
+#include "WorldState.h"
+#include <catch2/catch_all.hpp>
+
+namespace {
+constexpr float kCellSize = 4096.f;
+
+void FillGrid(Grid& grid, uint64_t numObjects)
+{
+  for (uint64_t i = 0; i < numObjects; ++i) {
+    grid.Move(i, static_cast<int16_t>(i % 8), static_cast<int16_t>(i / 8 % 8));
+  }
+}
+
+void CreateReferences(WorldState& worldState, uint32_t numReferences)
+{
+  for (uint32_t i = 0; i < numReferences; ++i) {
+    LocationalData locationalData;
+    locationalData.pos = { static_cast<float>(i % 4) * kCellSize, 0, 0 };
+    locationalData.cellOrWorldDesc = FormDesc::Tamriel();
+    worldState.AddForm(
+      std::make_unique<MpObjectReference>(
+        locationalData, FormCallbacks::DoNothing(), 0x0000000f, "MISC"),
+      0xff000000 + i);
+  }
+}
+}
+
+TEST_CASE("GridImpl::Move", "[Benchmarks][Grid]")
+{
+  for (uint64_t numObjects : { 10, 100, 1000 }) {
+    Grid grid;
+    FillGrid(grid, numObjects);
+
+    BENCHMARK("Move within a cell, " + std::to_string(numObjects) +
+              " objects")
+    {
+      grid.Move(0, 0, 0);
+      return grid.GetNeighboursAndMe(0).size();
+    };
+
+    int16_t x = 0;
+    BENCHMARK("Move to adjacent cell, " + std::to_string(numObjects) +
+              " objects")
+    {
+      x = x == 0 ? 1 : 0;
+      grid.Move(0, x, 0);
+      return grid.GetNeighboursAndMe(0).size();
+    };
+
+    int16_t farX = 0;
+    BENCHMARK("Move to distant cell, " + std::to_string(numObjects) +
+              " objects")
+    {
+      farX = farX == 0 ? 100 : 0;
+      grid.Move(0, farX, 0);
+      return grid.GetNeighboursAndMe(0).size();
+    };
+  }
+}
+
+TEST_CASE("ForceSubscriptionsUpdate", "[Benchmarks][Grid]")
+{
+  for (uint32_t numReferences : { 10, 100, 1000 }) {
+    WorldState worldState;
+    CreateReferences(worldState, numReferences);
+
+    auto& refr = worldState.GetFormAt<MpObjectReference>(0xff000000);
+
+    BENCHMARK("Subscriptions already up to date, " +
+              std::to_string(numReferences) + " references")
+    {
+      refr.ForceSubscriptionsUpdate();
+    };
+
+    float x = 0;
+    BENCHMARK("Cross cell border, " + std::to_string(numReferences) +
+              " references")
+    {
+      x = x == 0 ? 10 * kCellSize : 0;
+      refr.SetPos({ x, 0, 0 });
+    };
+  }
+}
+
+TEST_CASE("SendToNeighbours", "[Benchmarks][Grid]")
+{
+  for (int numPlayers : { 1, 50, 200 }) {
+    if (numPlayers > kMaxPlayers) {
+      break;
+    }
+
+    EmptySendTarget sendTarget;
+    PartOne p;
+    p.SetSendTarget(&sendTarget);
+
+    for (int i = 0; i < numPlayers; ++i) {
+      DoConnect(p, i);
+      p.CreateActor(0xff000000 + i, { 0, 0, 0 }, 1, 0x3c);
+      p.SetUserActor(i, 0xff000000 + i);
+    }
+
+    const auto message = MakeMessage(jMovement);
+
+    BENCHMARK("UpdateMovement for " + std::to_string(numPlayers) + " users")
+    {
+      PartOne* ptr = &p;
+      PartOne::HandlePacket(
+        ptr, 0, Networking::PacketType::Message,
+        reinterpret_cast<Networking::PacketData>(message.data()),
+        message.size());
+    };
+  }
+}
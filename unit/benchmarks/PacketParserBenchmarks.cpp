@@ -0,0 +1,119 @@
+#include "ActionListener.h"
+#include "MovementMessage.h"
+#include "MovementMessageSerialization.h"
+#include "PacketParser.h"
+#include "TestUtils.hpp"
+#include <catch2/catch_all.hpp>
+#include <slikenet/BitStream.h>
+
+namespace {
+// Measures parsing only: handlers do nothing
+class NullActionListener : public ActionListener
+{
+public:
+  explicit NullActionListener(PartOne& partOne)
+    : ActionListener(partOne)
+  {
+  }
+
+  void OnUpdateMovement(const RawMessageData&, uint32_t, const NiPoint3&,
+                        const NiPoint3&, bool, bool, bool, uint32_t) override
+  {
+  }
+
+  void OnUpdateAnimation(const RawMessageData&, uint32_t,
+                         const AnimationData&) override
+  {
+  }
+
+  void OnUpdateAppearance(const RawMessageData&, uint32_t,
+                          const Appearance&) override
+  {
+  }
+
+  void OnUpdateEquipment(const RawMessageData&, uint32_t,
+                         const simdjson::dom::element&, const Inventory&,
+                         uint32_t, uint32_t, uint32_t, uint32_t) override
+  {
+  }
+
+  void OnActivate(const RawMessageData&, uint32_t, uint32_t) override {}
+
+  void OnCustomEvent(const RawMessageData&, const char*,
+                     simdjson::dom::element&) override
+  {
+  }
+
+  void OnChangeValues(const RawMessageData&, const ActorValues&) override {}
+};
+
+std::string MakeBinaryMovementMessage()
+{
+  MovementMessage movData;
+  movData.worldOrCell = 0x3c;
+  movData.pos = { 1, -1, 1 };
+  movData.rot = { 0, 0, 179 };
+
+  SLNet::BitStream stream;
+  serialization::WriteToBitStream(stream, movData);
+
+  std::string res;
+  res += static_cast<char>(Networking::MinPacketId);
+  res += MovementMessage::kHeaderByte;
+  res.append(reinterpret_cast<const char*>(stream.GetData()),
+             stream.GetNumberOfBytesUsed());
+  return res;
+}
+
+std::vector<std::pair<std::string, std::string>> MakeMessages()
+{
+  auto equipment = jEquipment;
+  for (uint32_t i = 0; i < 10; ++i) {
+    equipment["data"]["inv"]["entries"].push_back(
+      { { "baseId", 0x00012eb7 + i }, { "count", 1 } });
+  }
+
+  return {
+    { "UpdateMovement (binary)", MakeBinaryMovementMessage() },
+    { "UpdateMovement (json)", MakeMessage(jMovement) },
+    { "UpdateAnimation",
+      MakeMessage({ { "t", MsgType::UpdateAnimation },
+                    { "idx", 0 },
+                    { "data",
+                      { { "animEventName", "JumpStandingStart" },
+                        { "numChanges", 42 } } } }) },
+    { "UpdateAppearance", MakeMessage(jAppearance) },
+    { "UpdateEquipment", MakeMessage(equipment) },
+    { "Activate",
+      MakeMessage(
+        { { "t", MsgType::Activate },
+          { "data", { { "caster", 0x14 }, { "target", 0x4cc2d } } } }) },
+    { "CustomEvent",
+      MakeMessage({ { "t", MsgType::CustomEvent },
+                    { "eventName", "_onBenchmark" },
+                    { "args", { 1, "two", 3.0 } } }) },
+    { "ChangeValues",
+      MakeMessage({ { "t", MsgType::ChangeValues },
+                    { "data",
+                      { { "health", 0.5 },
+                        { "magicka", 0.3 },
+                        { "stamina", 0 } } } }) }
+  };
+}
+}
+
+TEST_CASE("PacketParser", "[Benchmarks][PacketParser]")
+{
+  PartOne partOne;
+  NullActionListener listener(partOne);
+  PacketParser parser;
+
+  for (auto& [name, message] : MakeMessages()) {
+    BENCHMARK(std::string(name))
+    {
+      parser.TransformPacketIntoAction(
+        0, reinterpret_cast<Networking::PacketData>(message.data()),
+        message.size(), listener);
+    };
+  }
+}
@@ -0,0 +1,192 @@
+#include "BenchmarkUtils.h"
+#include "EditorIdIndex.h"
+#include "EspmGameObject.h"
+#include "FormCallbacks.h"
+#include "MpObjectReference.h"
+#include "PapyrusFormList.h"
+#include "PapyrusKeyword.h"
+#include "PapyrusObjectReference.h"
+#include "TestUtils.hpp"
+#include "WorldState.h"
+#include "libespm/Combiner.h"
+#include "libespm/Loader.h"
+#include "papyrus-vm/VirtualMachine.h"
+#include <catch2/catch_all.hpp>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+void BenchmarkGetKeyword(espm::Loader& loader, const std::string& suffix,
+                         const std::string& existingKeyword)
+{
+  WorldState worldState;
+  worldState.AttachEspm(&loader, [] { return FormCallbacks::DoNothing(); });
+
+  PapyrusKeyword papyrusKeyword;
+  papyrusKeyword.worldState = &worldState;
+
+  BENCHMARK("EditorIdIndex build (KYWD)" + suffix)
+  {
+    return EditorIdIndex(loader.GetBrowser(), worldState.GetEspmCache(),
+                         "KYWD")
+      .GetSize();
+  };
+
+  // Warm up the index so that only lookups are measured below
+  (void)worldState.GetEditorIdIndex("KYWD");
+
+  const VarValue existing(existingKeyword.data()), missing("NoSuchKeyword");
+
+  BENCHMARK("Keyword.GetKeyword (existing)" + suffix)
+  {
+    return papyrusKeyword.GetKeyword(VarValue::None(), { existing });
+  };
+
+  BENCHMARK("Keyword.GetKeyword (missing)" + suffix)
+  {
+    return papyrusKeyword.GetKeyword(VarValue::None(), { missing });
+  };
+}
+}
+
+TEST_CASE("VarValue arithmetic", "[Benchmarks][VarValue]")
+{
+  VarValue i1(40), i2(2);
+  VarValue f1(40.f), f2(2.f);
+  VarValue s1("Hello "), s2("World");
+
+  BENCHMARK("int + int") { return i1 + i2; };
+  BENCHMARK("int * int") { return i1 * i2; };
+  BENCHMARK("float + float") { return f1 + f2; };
+  BENCHMARK("float / float") { return f1 / f2; };
+  BENCHMARK("string + string") { return s1 + s2; };
+  BENCHMARK("int < int") { return i1 < i2; };
+  BENCHMARK("CastToFloat") { return i1.CastToFloat(); };
+}
+
+TEST_CASE("Papyrus function calls", "[Benchmarks][Papyrus]")
+{
+  VirtualMachine vm(std::vector<std::shared_ptr<PexScript>>{});
+  vm.RegisterFunction("BenchmarkUtil", "Sum", FunctionType::GlobalFunction,
+                      [](VarValue, const std::vector<VarValue>& args) {
+                        return VarValue(static_cast<int32_t>(args[0]) +
+                                        static_cast<int32_t>(args[1]));
+                      });
+
+  std::vector<VarValue> args = { VarValue(40), VarValue(2) };
+  BENCHMARK("VirtualMachine::CallStatic (native)")
+  {
+    return vm.CallStatic("BenchmarkUtil", "Sum", args);
+  };
+
+  WorldState worldState;
+  LocationalData locationalData;
+  locationalData.cellOrWorldDesc = FormDesc::Tamriel();
+  worldState.AddForm(
+    std::make_unique<MpObjectReference>(
+      locationalData, FormCallbacks::DoNothing(), 0x0000000f, "CONT"),
+    0xff000000);
+  auto& refr = worldState.GetFormAt<MpObjectReference>(0xff000000);
+  refr.AddItem(kSyntheticMiscBase, 100);
+
+  PapyrusObjectReference papyrusObjectReference;
+  const auto self = refr.ToVarValue();
+
+  BENCHMARK("ObjectReference.GetPositionX")
+  {
+    return papyrusObjectReference.GetPositionX(self, {});
+  };
+
+  const auto plugin = MakeSyntheticPlugin(10);
+  espm::Browser browser(plugin.data(), plugin.size());
+  espm::Combiner combiner;
+  combiner.AddSource(&browser, "Synthetic.esp");
+  auto combineBrowser = combiner.Combine();
+
+  auto item = VarValue(std::make_shared<EspmGameObject>(
+    combineBrowser->LookupById(kSyntheticMiscBase)));
+  BENCHMARK("ObjectReference.GetItemCount")
+  {
+    return papyrusObjectReference.GetItemCount(self, { item });
+  };
+}
+
+TEST_CASE("Papyrus FormList calls", "[Benchmarks][Papyrus][FormList]")
+{
+  for (uint32_t formListSize : { 16, 256 }) {
+    const auto suffix = ", " + std::to_string(formListSize) + " forms";
+    const auto plugin = MakeSyntheticPlugin(1000, formListSize);
+
+    espm::Browser browser(plugin.data(), plugin.size());
+    espm::Combiner combiner;
+    combiner.AddSource(&browser, "Synthetic.esp");
+    auto combineBrowser = combiner.Combine();
+
+    auto formList = VarValue(std::make_shared<EspmGameObject>(
+      combineBrowser->LookupById(kSyntheticFormListBase)));
+    // FLST::GetData returns LNAM entries in reverse order
+    auto lastForm = VarValue(std::make_shared<EspmGameObject>(
+      combineBrowser->LookupById(kSyntheticMiscBase)));
+
+    WorldState worldState;
+    PapyrusFormList uncached, cached;
+    cached.worldState = &worldState;
+
+    BENCHMARK("FormList.GetSize (uncached)" + suffix)
+    {
+      return uncached.GetSize(formList, {});
+    };
+
+    BENCHMARK("FormList.Find (last element, uncached)" + suffix)
+    {
+      return uncached.Find(formList, { lastForm });
+    };
+
+    BENCHMARK("FormList.GetSize" + suffix)
+    {
+      return cached.GetSize(formList, {});
+    };
+
+    BENCHMARK("FormList.GetAt" + suffix)
+    {
+      return cached.GetAt(formList, { VarValue(0) });
+    };
+
+    BENCHMARK("FormList.Find (last element)" + suffix)
+    {
+      return cached.Find(formList, { lastForm });
+    };
+
+    BENCHMARK("FormList.HasForm (last element)" + suffix)
+    {
+      return cached.HasForm(formList, { lastForm });
+    };
+  }
+}
+
+TEST_CASE("Papyrus Keyword.GetKeyword", "[Benchmarks][Papyrus][Keyword]")
+{
+  const uint32_t numKeywords = 10000;
+  const auto plugin = MakeSyntheticPlugin(numKeywords);
+
+  auto directory =
+    std::filesystem::temp_directory_path() / "skymp_keyword_benchmark";
+  std::filesystem::create_directories(directory);
+  std::ofstream(directory / "Synthetic.esp", std::ios::binary)
+    .write(reinterpret_cast<const char*>(plugin.data()), plugin.size());
+
+  {
+    espm::Loader loader(directory, { "Synthetic.esp" });
+    BenchmarkGetKeyword(loader, ", synthetic",
+                        "benchkeyword" + std::to_string(numKeywords - 1));
+  }
+  std::filesystem::remove_all(directory);
+
+  std::filesystem::path dataDir = GetDataDir();
+  if (!std::filesystem::exists(dataDir / "Skyrim.esm")) {
+    WARN("Skyrim.esm not found, skipping Skyrim.esm keyword set");
+    return;
+  }
+  espm::Loader loader(dataDir, { "Skyrim.esm" });
+  BenchmarkGetKeyword(loader, ", Skyrim.esm", "ArmorHeavy");
+}
@@ -0,0 +1,133 @@
+#include "Inventory.h"
+#include "MovementMessage.h"
+#include "MovementMessageSerialization.h"
+#include "MpChangeForms.h"
+#include <catch2/catch_all.hpp>
+#include <nlohmann/json.hpp>
+#include <simdjson.h>
+#include <slikenet/BitStream.h>
+
+namespace {
+MovementMessage MakeMovementMessage()
+{
+  MovementMessage result;
+  result.idx = 1337;
+  result.worldOrCell = 0x3c;
+  result.pos = { 133857.f, -61130.f, 14662.f };
+  result.rot = { 0.f, 0.f, 72.f };
+  result.direction = 270;
+  result.healthPercentage = 0.5f;
+  result.speed = 400;
+  result.runMode = RunMode::Running;
+  result.isWeapDrawn = true;
+  result.lookAt = { { 1, 2, 3 } };
+  return result;
+}
+
+Inventory MakeInventory(uint32_t numEntries)
+{
+  Inventory inv;
+  for (uint32_t i = 0; i < numEntries; ++i) {
+    inv.AddItem(0x00010000 + i, i + 1);
+  }
+  return inv;
+}
+
+MpChangeForm MakeChangeForm()
+{
+  MpChangeForm changeForm;
+  changeForm.recType = MpChangeForm::ACHR;
+  changeForm.formDesc = FormDesc::FromFormId(0xff000000, {});
+  changeForm.baseDesc = FormDesc::FromFormId(0x7, {});
+  changeForm.position = { 133857.f, -61130.f, 14662.f };
+  changeForm.worldOrCellDesc = FormDesc::Tamriel();
+  changeForm.inv = MakeInventory(50);
+  changeForm.profileId = 1;
+  changeForm.appearanceDump = R"({"isFemale":false,"raceId":1,"name":"Bench"})";
+  changeForm.equipmentDump = R"({"inv":{"entries":[]},"numChanges":0})";
+  return changeForm;
+}
+}
+
+TEST_CASE("MovementMessage serialization", "[Benchmarks][Serialization]")
+{
+  const auto movData = MakeMovementMessage();
+
+  BENCHMARK("WriteToBitStream")
+  {
+    SLNet::BitStream stream;
+    serialization::WriteToBitStream(stream, movData);
+    return stream.GetNumberOfBytesUsed();
+  };
+
+  SLNet::BitStream encoded;
+  serialization::WriteToBitStream(encoded, movData);
+
+  BENCHMARK("ReadFromBitStream")
+  {
+    SLNet::BitStream stream(encoded.GetData(),
+                            encoded.GetNumberOfBytesUsed(), false);
+    MovementMessage res;
+    serialization::ReadFromBitStream(stream, res);
+    return res.idx;
+  };
+
+  BENCHMARK("MovementMessageToJson")
+  {
+    return serialization::MovementMessageToJson(movData);
+  };
+
+  const auto json = serialization::MovementMessageToJson(movData);
+
+  BENCHMARK("MovementMessageFromJson")
+  {
+    return serialization::MovementMessageFromJson(json);
+  };
+}
+
+TEST_CASE("Inventory operations", "[Benchmarks][Inventory]")
+{
+  for (uint32_t numEntries : { 10, 100, 1000 }) {
+    const auto suffix = ", " + std::to_string(numEntries) + " entries";
+    const auto inv = MakeInventory(numEntries);
+
+    BENCHMARK("AddItem" + suffix)
+    {
+      return MakeInventory(numEntries);
+    };
+
+    BENCHMARK("GetItemCount" + suffix)
+    {
+      return inv.GetItemCount(0x00010000 + numEntries - 1);
+    };
+
+    BENCHMARK("AddItems + RemoveItems" + suffix)
+    {
+      auto copy = inv;
+      copy.AddItems({ { 0x00010000, 5 } });
+      copy.RemoveItems({ { 0x00010000, 5 } });
+      return copy.GetTotalItemCount();
+    };
+
+    BENCHMARK("ToJson" + suffix) { return inv.ToJson(); };
+
+    const auto json = inv.ToJson();
+    BENCHMARK("FromJson" + suffix) { return Inventory::FromJson(json); };
+  }
+}
+
+TEST_CASE("MpChangeForm serialization", "[Benchmarks][Serialization]")
+{
+  const auto changeForm = MakeChangeForm();
+
+  BENCHMARK("ToJson") { return MpChangeForm::ToJson(changeForm); };
+
+  const auto dump = MpChangeForm::ToJson(changeForm).dump();
+  simdjson::dom::parser parser;
+
+  BENCHMARK("JsonToChangeForm")
+  {
+    auto element = parser.parse(dump).value();
+    return MpChangeForm::JsonToChangeForm(element);
+  };
+}
@@ -0,0 +1,8 @@
+#include <catch2/catch_all.hpp>
+
+// Run with '--reporter JSON::out=benchmarks.json' to get machine-readable
+// results. 'run_benchmarks' target does exactly this
+int main(int argc, char* argv[])
+{
+  return Catch::Session().run(argc, argv);
+}